@@ -0,0 +1,71 @@
+/**
+ * @file bench_clock.cc
+ * @brief 时钟源基准测试：测量各时钟源采集时间戳及换算为墙上时间的开销
+ */
+#include "jzlog/utils/clock.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+
+using jzlog::utils::ClockSource;
+
+template < class Fn >
+void run_case( const char* name, size_t iterations, Fn&& fn ) {
+    uint64_t sink  = 0;
+    auto     start = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < iterations; ++i ) {
+        sink += fn();
+        asm volatile( "" : "+r"( sink ) );
+    }
+    auto   end = std::chrono::steady_clock::now();
+    double ns  = std::chrono::duration< double, std::nano >( end - start ).count();
+    std::printf( "%-28s %8.3f ns/call\n", name, ns / iterations );
+}
+
+}  // anonymous namespace
+
+int main( int argc, char* argv[] ) {
+    size_t iterations = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 10000000;
+
+    // 预先完成 TSC 校准
+    const auto& tsc = jzlog::utils::CTscClock::instance();
+
+    std::printf( "=== Clock source benchmark (%zu calls) ===\n", iterations );
+    std::printf( "TSC calibration: %.6f ns/tick\n", tsc.ns_per_tick() );
+
+    struct {
+        const char* capture;
+        const char* convert;
+        ClockSource source;
+    } cases[] = {
+        { "SYSTEM capture", "SYSTEM capture+convert", ClockSource::SYSTEM },
+        { "REALTIME_COARSE capture", "REALTIME_COARSE capture+conv", ClockSource::REALTIME_COARSE },
+        { "TSC capture", "TSC capture+convert", ClockSource::TSC },
+    };
+
+    for ( auto& c : cases ) {
+        run_case( c.capture, iterations, [ & ] {
+            return jzlog::utils::now_ticks( c.source );
+        } );
+    }
+
+    for ( auto& c : cases ) {
+        run_case( c.convert, iterations, [ & ] {
+            auto tp = jzlog::utils::to_time_point( c.source, jzlog::utils::now_ticks( c.source ) );
+            return static_cast< uint64_t >( tp.time_since_epoch().count() );
+        } );
+    }
+
+    // 换算精度：TSC 与 system_clock 之间的偏差
+    auto sys  = std::chrono::system_clock::now();
+    auto conv = jzlog::utils::to_time_point( ClockSource::TSC,
+                                             jzlog::utils::now_ticks( ClockSource::TSC ) );
+    std::printf( "TSC vs system_clock skew: %lld ns\n",
+                 static_cast< long long >(
+                     std::chrono::duration_cast< std::chrono::nanoseconds >( conv - sys ).count() ) );
+    return 0;
+}
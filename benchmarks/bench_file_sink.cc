@@ -0,0 +1,181 @@
+/**
+ * @file bench_file_sink.cc
+ * @brief 文件写入基准测试：对比逐缓冲区 ofstream 写入、批量 writev 写入、CFileSink
+ *        各写入后端与 CMmapFileSink 的端到端吞吐
+ */
+#include "jzlog/archive_manager/archive_manager.h"
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/file_sink.h"
+#include "jzlog/sinks/mmap_file_sink.h"
+#include "jzlog/utils/fd_writer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+using namespace jzlog;
+
+const std::string kBenchDir = "/tmp/jzlog_bench_file_sink";
+
+constexpr size_t kLineSize  = 128;  // 每行日志的字节数
+constexpr size_t kBatchSize = 64;   // writev 单批提交的缓冲区数
+
+/**
+ * @brief 生成 count 个填满日志行的缓冲区
+ */
+std::vector< std::string > make_buffers( size_t count, size_t buffer_size ) {
+    std::string line( kLineSize - 1, 'x' );
+    line.push_back( '\n' );
+
+    std::string buffer;
+    while ( buffer.size() + kLineSize <= buffer_size ) {
+        buffer += line;
+    }
+    return std::vector< std::string >( count, buffer );
+}
+
+void report( const char* name, size_t bytes, std::chrono::steady_clock::time_point start ) {
+    double sec =
+        std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+    std::printf( "%-32s %10.1f MB/s\n", name, bytes / sec / ( 1024.0 * 1024.0 ) );
+}
+
+/**
+ * @brief 旧路径：每个缓冲区加锁后 ofstream::write + flush
+ */
+void run_ofstream( const std::vector< std::string >& buffers, size_t bytes ) {
+    std::filesystem::remove_all( kBenchDir );
+    std::filesystem::create_directories( kBenchDir );
+
+    std::mutex    mutex;
+    auto          start = std::chrono::steady_clock::now();
+    std::ofstream out( kBenchDir + "/ofstream.log", std::ios::out | std::ios::app );
+    for ( const auto& buffer : buffers ) {
+        std::lock_guard< std::mutex > lock{ mutex };
+        out.write( buffer.data(), static_cast< std::streamsize >( buffer.size() ) );
+        out.flush();
+    }
+    out.close();
+    report( "ofstream write+flush", bytes, start );
+}
+
+/**
+ * @brief 新路径：每 kBatchSize 个缓冲区合并为一次 writev
+ */
+void run_writev( const std::vector< std::string >& buffers, size_t bytes ) {
+    std::filesystem::remove_all( kBenchDir );
+    std::filesystem::create_directories( kBenchDir );
+
+    auto start = std::chrono::steady_clock::now();
+    int  fd    = ::open( ( kBenchDir + "/writev.log" ).c_str(),
+                         O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+    std::vector< struct iovec > iov;
+    iov.reserve( kBatchSize );
+    for ( const auto& buffer : buffers ) {
+        iov.push_back( { const_cast< char* >( buffer.data() ), buffer.size() } );
+        if ( iov.size() == kBatchSize ) {
+            utils::write_fully( fd, iov.data(), static_cast< int >( iov.size() ) );
+            iov.clear();
+        }
+    }
+    utils::write_fully( fd, iov.data(), static_cast< int >( iov.size() ) );
+    ::close( fd );
+    report( "writev batched", bytes, start );
+}
+
+/**
+ * @brief CFileSink 端到端：写入已格式化的行，析构时等待后台线程落盘
+ */
+void run_file_sink( const char* name, sinks::FileWriteBackend backend, size_t total_bytes,
+                    size_t buffer_size ) {
+    std::filesystem::remove_all( kBenchDir );
+
+    sinks::ArchiveConfig archive_cfg;
+    archive_cfg.base_path      = kBenchDir;
+    archive_cfg.enable_archive = false;
+
+    LogRecord record;
+    record._level     = LogLevel::INFO;
+    record._thread_id = std::this_thread::get_id();
+
+    std::string line( kLineSize - 1, 'x' );
+    line.push_back( '\n' );
+    record._message = line;
+    size_t lines = total_bytes / kLineSize;
+
+    sinks::FileSinkConfig config;
+    config.backend = backend;
+
+    auto start     = std::chrono::steady_clock::now();
+    {
+        sinks::CFileSink sink( LogLevel::INFO, UINT32_MAX, static_cast< uint32_t >( buffer_size ),
+                               false, archive_cfg, config );
+        if ( sink.backend() != backend ) {
+            std::printf( "%-32s %10s\n", name, "unavailable" );
+            return;
+        }
+        for ( size_t i = 0; i < lines; ++i ) {
+            sink.write_formatted( record, line );
+        }
+    }
+    report( name, lines * kLineSize, start );
+}
+
+/**
+ * @brief CMmapFileSink 端到端：调用线程直接拷贝进映射区，析构时截断最后一个分段
+ */
+void run_mmap_sink( size_t total_bytes ) {
+    std::filesystem::remove_all( kBenchDir );
+
+    LogRecord record;
+    record._level     = LogLevel::INFO;
+    record._thread_id = std::this_thread::get_id();
+
+    std::string line( kLineSize - 1, 'x' );
+    line.push_back( '\n' );
+    record._message = line;
+    size_t lines    = total_bytes / kLineSize;
+
+    auto start      = std::chrono::steady_clock::now();
+    {
+        sinks::CMmapFileSink sink( LogLevel::INFO, 64 * 1024 * 1024, kBenchDir );
+        for ( size_t i = 0; i < lines; ++i ) {
+            sink.write_formatted( record, line );
+        }
+    }
+    report( "CMmapFileSink", lines * kLineSize, start );
+}
+
+}  // anonymous namespace
+
+int main( int argc, char* argv[] ) {
+    size_t total_mb  = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 512;
+    size_t buffer_kb = argc > 2 ? std::strtoul( argv[ 2 ], nullptr, 10 ) : 64;
+
+    size_t buffer_size = buffer_kb * 1024;
+    size_t count       = total_mb * 1024 * 1024 / buffer_size;
+    auto   buffers     = make_buffers( count, buffer_size );
+    size_t bytes       = count * buffers.front().size();
+
+    std::printf( "=== File sink benchmark (%zu MB, %zu KB buffers) ===\n", total_mb, buffer_kb );
+    run_ofstream( buffers, bytes );
+    run_writev( buffers, bytes );
+    run_file_sink( "CFileSink writev", sinks::FileWriteBackend::WRITEV, bytes, buffer_size );
+    run_file_sink( "CFileSink io_uring", sinks::FileWriteBackend::IO_URING, bytes, buffer_size );
+    run_mmap_sink( bytes );
+
+    std::filesystem::remove_all( kBenchDir );
+    return 0;
+}
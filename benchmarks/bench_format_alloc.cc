@@ -0,0 +1,128 @@
+/**
+ * @file bench_format_alloc.cc
+ * @brief 格式化路径基准测试：统计每次日志调用的堆分配次数与耗时
+ */
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/logger.hpp"
+#include "jzlog/sinks/sink.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::atomic< size_t > g_alloc_count{ 0 };
+}  // anonymous namespace
+
+void* operator new( size_t size ) {
+    g_alloc_count.fetch_add( 1, std::memory_order_relaxed );
+    if ( void* p = std::malloc( size ) ) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept { std::free( p ); }
+
+void operator delete( void* p, size_t ) noexcept { std::free( p ); }
+
+namespace
+{
+
+using namespace jzlog;
+
+/**
+ * @class CNullSink
+ * @brief 丢弃所有记录的 sink，只用于隔离格式化路径的开销
+ */
+class CNullSink final : public sinks::ISink {
+public:
+    bool write( const LogRecord& r ) override {
+        _bytes += r._message.size();
+        return true;
+    }
+    bool     flush() noexcept override { return true; }
+    void     set_level( LogLevel lvl ) noexcept override { _level = lvl; }
+    LogLevel level() const noexcept override { return _level; }
+    bool     should_log( LogLevel lvl ) const noexcept override { return lvl >= _level; }
+    void     set_enabled( bool enabled ) noexcept override { (void)enabled; }
+    bool     enabled() const noexcept override { return true; }
+
+    size_t _bytes{ 0 };
+
+private:
+    LogLevel _level{ LogLevel::TRACE };
+};
+
+/**
+ * @brief 旧实现：两次 snprintf + vector + string，用作对照
+ */
+template < class... Args >
+bool legacy_add_record( sinks::ISink& sink, std::string_view fmt, Args&&... args ) {
+    int required = snprintf( nullptr, 0, fmt.data(), args... );
+    if ( required < 0 ) {
+        return false;
+    }
+    std::vector< char > buf( required + 1, 0 );
+    snprintf( buf.data(), required + 1, fmt.data(), args... );
+    LogRecord record;
+    record._message = std::string( buf.data(), required );
+    record._level   = LogLevel::INFO;
+    return sink.write( record );
+}
+
+template < class Fn >
+void run_case( const char* name, size_t iterations, Fn&& fn ) {
+    for ( size_t i = 0; i < 1000; ++i ) {
+        fn( i );
+    }
+
+    size_t allocs_before = g_alloc_count.load();
+    auto   start         = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < iterations; ++i ) {
+        fn( i );
+    }
+    auto   end          = std::chrono::steady_clock::now();
+    size_t allocs_after = g_alloc_count.load();
+
+    double ns = std::chrono::duration< double, std::nano >( end - start ).count();
+    std::printf( "%-28s %10.1f ns/call %8.3f allocs/call\n", name, ns / iterations,
+                 static_cast< double >( allocs_after - allocs_before ) / iterations );
+}
+
+}  // anonymous namespace
+
+int main( int argc, char* argv[] ) {
+    size_t iterations = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 1000000;
+
+    CLogger logger;
+    logger.add_sink( std::make_unique< CNullSink >() );
+
+    CNullSink legacy_sink;
+
+    std::cout << "=== Format path allocation benchmark (" << iterations << " calls) ==="
+              << std::endl;
+
+    run_case( "legacy (two-pass)", iterations, [ & ]( size_t i ) {
+        legacy_add_record( legacy_sink, "request %zu served in %d us by worker %s", i, 42,
+                           "worker-007" );
+    } );
+
+    run_case( "single-pass tls buffer", iterations, [ & ]( size_t i ) {
+        logger.info( "request %zu served in %d us by worker %s", i, 42, "worker-007" );
+    } );
+
+    std::string large( 4 * utils::kSmallBuffer, 'x' );
+    run_case( "single-pass overflow", iterations / 10, [ & ]( size_t i ) {
+        logger.info( "request %zu payload %s", i, large.c_str() );
+    } );
+
+    return 0;
+}
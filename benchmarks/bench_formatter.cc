@@ -0,0 +1,94 @@
+/**
+ * @file bench_formatter.cc
+ * @brief 格式化基准测试：对比旧的 stringstream + put_time 路径与编译后的模式串格式化器
+ */
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/core/pattern_formatter.h"
+#include "jzlog/utils/fixed_buffer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+using namespace jzlog;
+
+/**
+ * @brief 旧版 format_log_record 的实现
+ */
+std::string format_stringstream( const LogRecord& r ) {
+    std::stringstream ss;
+
+    auto    time = std::chrono::system_clock::to_time_t( r._timestamp );
+    std::tm tm_buf;
+    localtime_r( &time, &tm_buf );
+    ss << std::put_time( &tm_buf, "%Y-%m-%d %H:%M:%S" ) << " ["
+       << loglevel::to_string( r._level ) << "] " << "[" << r._thread_id << "]"
+       << "[" << r._function << ":" << r._line << "]" << r._message << "\n";
+
+    return ss.str();
+}
+
+template < class Fn >
+void run_case( const char* name, size_t iterations, Fn&& fn ) {
+    size_t bytes = 0;
+    auto   start = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < iterations; ++i ) {
+        bytes += fn( i );
+        asm volatile( "" : "+r"( bytes ) );
+    }
+    auto   end = std::chrono::steady_clock::now();
+    double ns  = std::chrono::duration< double, std::nano >( end - start ).count();
+    std::printf( "%-36s %8.1f ns/record %8.2f M records/s\n", name, ns / iterations,
+                 iterations * 1e3 / ns );
+}
+
+}  // anonymous namespace
+
+int main( int argc, char* argv[] ) {
+    size_t iterations = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 1000000;
+
+    LogRecord record;
+    record._level     = LogLevel::INFO;
+    record._message   = "processing request id=12345 user=alice status=ok latency_us=87";
+    record._thread_id = std::this_thread::get_id();
+    record._file      = __FILE__;
+    record._function  = "main";
+    record._line      = __LINE__;
+
+    // 时间戳每条推进 1 微秒，模拟约 1M 条/秒的真实时间分布
+    auto base = std::chrono::system_clock::now();
+
+    std::printf( "=== Formatter benchmark (%zu records) ===\n", iterations );
+
+    run_case( "stringstream + put_time", iterations, [ & ]( size_t i ) {
+        record._timestamp = base + std::chrono::microseconds( i );
+        return format_stringstream( record ).size();
+    } );
+
+    CPatternFormatter                         formatter;
+    utils::FixedBuffer< utils::kSmallBuffer > buffer;
+    run_case( "pattern -> FixedBuffer", iterations, [ & ]( size_t i ) {
+        record._timestamp = base + std::chrono::microseconds( i );
+        buffer.reset();
+        formatter.format_to( record, buffer );
+        return buffer.length();
+    } );
+
+    CPatternFormatter precise( "%Y-%m-%d %H:%M:%S.%f %z [%l] [%t][%s:%#]%v%n" );
+    run_case( "pattern(us, %z, %s) -> FixedBuffer", iterations, [ & ]( size_t i ) {
+        record._timestamp = base + std::chrono::microseconds( i );
+        buffer.reset();
+        precise.format_to( record, buffer );
+        return buffer.length();
+    } );
+
+    return 0;
+}
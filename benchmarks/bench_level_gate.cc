@@ -0,0 +1,74 @@
+/**
+ * @file bench_level_gate.cc
+ * @brief 级别过滤基准测试：测量被禁用的日志调用的开销
+ */
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/logger.hpp"
+#include "jzlog/sinks/sink.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace
+{
+
+using namespace jzlog;
+
+/**
+ * @class CNullSink
+ * @brief 丢弃所有记录的 sink
+ */
+class CNullSink final : public sinks::ISink {
+public:
+    explicit CNullSink( LogLevel lvl ) : _level( lvl ) {}
+    bool     write( const LogRecord& ) override { return true; }
+    bool     flush() noexcept override { return true; }
+    void     set_level( LogLevel lvl ) noexcept override { _level = lvl; }
+    LogLevel level() const noexcept override { return _level; }
+    bool     should_log( LogLevel lvl ) const noexcept override { return lvl >= _level; }
+    void     set_enabled( bool enabled ) noexcept override { (void)enabled; }
+    bool     enabled() const noexcept override { return true; }
+
+private:
+    LogLevel _level;
+};
+
+template < class Fn >
+void run_case( const char* name, size_t iterations, Fn&& fn ) {
+    auto start = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < iterations; ++i ) {
+        fn( i );
+        asm volatile( "" ::: "memory" );
+    }
+    auto   end = std::chrono::steady_clock::now();
+    double ns  = std::chrono::duration< double, std::nano >( end - start ).count();
+    std::printf( "%-24s %8.3f ns/call\n", name, ns / iterations );
+}
+
+}  // anonymous namespace
+
+int main( int argc, char* argv[] ) {
+    size_t iterations = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 100000000;
+
+    CLogger logger;
+    logger.add_sink( std::make_unique< CNullSink >( LogLevel::INFO ) );
+
+    std::printf( "=== Disabled log call benchmark (%zu calls) ===\n", iterations );
+
+    run_case( "logger.debug()", iterations, [ & ]( size_t i ) {
+        logger.debug( "disabled %zu %s", i, "payload" );
+    } );
+
+    run_case( "JZLOG_DEBUG()", iterations, [ & ]( size_t i ) {
+        JZLOG_DEBUG( logger, "disabled %zu %s", i, "payload" );
+    } );
+
+    logger.set_level( LogLevel::ERROR );
+    run_case( "logger.info() @ERROR", iterations, [ & ]( size_t i ) {
+        logger.info( "disabled %zu %s", i, "payload" );
+    } );
+
+    return 0;
+}
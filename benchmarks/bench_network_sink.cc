@@ -0,0 +1,171 @@
+/**
+ * @file bench_network_sink.cc
+ * @brief 网络 Sink 回环吞吐基准：本进程内的接收线程以 CFrameReceiver 按帧校验、解压并
+ *        累计确认，计时到全部帧被确认为止；积压达到上限被拒绝的行重试写入，结果为持续送达的吞吐。
+ *        开启压缩的组另外输出压缩率与每帧压缩耗时
+ */
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/frame_receiver.h"
+#include "jzlog/sinks/net_codec.h"
+#include "jzlog/sinks/network_sink.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace
+{
+
+using namespace jzlog;
+
+constexpr size_t kLineSize  = 128;    // 每行日志的字节数
+constexpr size_t kLineKinds = 65536;  // 轮流写入的不同日志行数，远超 LZ 的 64KB 匹配窗口
+
+/**
+ * @class CReceiver
+ * @brief 回环接收端：由 CFrameReceiver 读取帧、校验 CRC、解压并对每帧回复累计确认
+ */
+class CReceiver {
+public:
+    CReceiver() :
+        _receiver( [ this ]( const sinks::FrameHeader&, const std::string& lines ) {
+            _bytes += lines.size();
+        } ) {
+        _listen_fd = ::socket( AF_INET, SOCK_STREAM, 0 );
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        ::bind( _listen_fd, reinterpret_cast< sockaddr* >( &addr ), sizeof( addr ) );
+        ::listen( _listen_fd, 4 );
+        socklen_t len = sizeof( addr );
+        ::getsockname( _listen_fd, reinterpret_cast< sockaddr* >( &addr ), &len );
+        _port = ntohs( addr.sin_port );
+
+        _thread = std::thread( [ this ]() {
+            int fd = -1;
+            while ( ( fd = ::accept( _listen_fd, nullptr, nullptr ) ) >= 0 ) {
+                sinks::ReceiveResult result = _receiver.serve( fd );
+                if ( result != sinks::ReceiveResult::CLOSED ) {
+                    ++_errors;
+                }
+                ::close( fd );
+            }
+        } );
+    }
+
+    ~CReceiver() {
+        ::shutdown( _listen_fd, SHUT_RDWR );
+        _thread.join();
+        ::close( _listen_fd );
+    }
+
+    uint16_t port() const { return _port; }
+
+    uint64_t bytes() const { return _bytes.load(); }
+
+    uint64_t errors() const { return _errors.load(); }
+
+private:
+    int                     _listen_fd{ -1 };
+    uint16_t                _port{ 0 };
+    std::atomic< uint64_t > _bytes{ 0 };
+    std::atomic< uint64_t > _errors{ 0 };
+    sinks::CFrameReceiver   _receiver;
+    std::thread             _thread;
+};
+
+/**
+ * @brief 生成 kLineKinds 行时间戳、线程与数值各不相同的日志行，每行 kLineSize 字节
+ */
+std::vector< std::string > make_lines() {
+    std::vector< std::string > lines;
+    for ( size_t i = 0; i < kLineKinds; ++i ) {
+        std::string line = "2026-10-17 12:00:" + std::to_string( 10 + i % 50 ) + "." +
+                           std::to_string( 100000 + i * 7919 % 900000 ) + " [INFO] [worker-" +
+                           std::to_string( i % 8 ) + "] request " + std::to_string( i * 104729 ) +
+                           " handled in " + std::to_string( i * 31 % 977 ) + " us status=ok";
+        line.resize( kLineSize - 1, ' ' );
+        lines.emplace_back( line + "\n" );
+    }
+    return lines;
+}
+
+/**
+ * @brief 写入 total_bytes 的日志行，计时到 flush() 确认全部送达
+ */
+void run( size_t total_bytes, size_t batch_size, size_t zerocopy_threshold,
+          sinks::FrameCodec codec = sinks::FrameCodec::NONE, int level = 1 ) {
+    CReceiver receiver;
+
+    static const std::vector< std::string > lines_set = make_lines();
+    size_t                                  lines     = total_bytes / kLineSize;
+
+    LogRecord record;
+    record._level   = LogLevel::INFO;
+    record._message = lines_set[ 0 ];
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", receiver.port(), LogLevel::INFO, batch_size, 10,
+                                  100, true );
+        sink.set_zerocopy_threshold( zerocopy_threshold );
+        sinks::CompressionConfig compression;
+        compression.codec = codec;
+        compression.level = level;
+        sink.set_compression( compression );
+        for ( size_t i = 0; i < lines; ++i ) {
+            while ( !sink.write_formatted( record, lines_set[ i % kLineKinds ] ) ) {
+                std::this_thread::yield();
+            }
+        }
+        while ( !sink.flush() ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds{ 1 } );
+        }
+        double sec =
+            std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+        std::printf( "batch %-6zu zerocopy %-4s %10.1f MB/s %12.0f lines/s", batch_size,
+                     zerocopy_threshold > 0 ? "on" : "off",
+                     receiver.bytes() / sec / ( 1024.0 * 1024.0 ), lines / sec );
+        if ( codec != sinks::FrameCodec::NONE ) {
+            sinks::NetworkStats stats = sink.stats();
+            std::printf( "  %s-%d ratio %.3f %8.0f ns/frame",
+                         codec == sinks::FrameCodec::LZ ? "lz" : "zstd", level, stats.ratio(),
+                         stats.compress_ns_per_batch() );
+        }
+        std::printf( "\n" );
+    }
+    if ( receiver.errors() > 0 || receiver.bytes() != lines * kLineSize ) {
+        std::printf( "  receiver got %llu of %zu bytes, %llu errors\n",
+                     static_cast< unsigned long long >( receiver.bytes() ), lines * kLineSize,
+                     static_cast< unsigned long long >( receiver.errors() ) );
+    }
+}
+
+}  // anonymous namespace
+
+int main( int argc, char* argv[] ) {
+    size_t total_mb = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 256;
+
+    std::printf( "=== Network sink loopback benchmark (%zu MB, %zu B lines) ===\n", total_mb,
+                 kLineSize );
+    for ( size_t batch_size : { 100, 1000, 10000 } ) {
+        run( total_mb * 1024 * 1024, batch_size, 0 );
+    }
+    run( total_mb * 1024 * 1024, 10000, 256 * 1024 );
+    for ( int level = 1; level <= 3; ++level ) {
+        run( total_mb * 1024 * 1024, 10000, 0, sinks::FrameCodec::LZ, level );
+    }
+    if ( sinks::codec_available( sinks::FrameCodec::ZSTD ) ) {
+        run( total_mb * 1024 * 1024, 10000, 0, sinks::FrameCodec::ZSTD, 1 );
+        run( total_mb * 1024 * 1024, 10000, 0, sinks::FrameCodec::ZSTD, 3 );
+    }
+    return 0;
+}
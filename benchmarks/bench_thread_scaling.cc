@@ -0,0 +1,88 @@
+/**
+ * @file bench_thread_scaling.cc
+ * @brief 线程扩展性基准测试：对比 SYNC 路径与 DEFERRED（每线程 SPSC 环形缓冲区）路径
+ */
+#include "jzlog/archive_manager/archive_manager.h"
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/logger_config.h"
+#include "jzlog/logger.hpp"
+#include "jzlog/sinks/file_sink.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace jzlog;
+
+const std::string kBenchDir = "/tmp/jzlog_bench_thread_scaling";
+
+struct Result {
+    double producer_ms;  // 所有生产者线程完成调用的耗时
+    double total_ms;     // 包含后台排空与落盘的总耗时
+};
+
+Result run( LogMode mode, int threads, size_t total ) {
+    std::filesystem::remove_all( kBenchDir );
+
+    sinks::ArchiveConfig archive_cfg;
+    archive_cfg.base_path      = kBenchDir;
+    archive_cfg.enable_archive = false;
+
+    LoggerConfig config;
+    config.mode = mode;
+
+    auto   start       = std::chrono::steady_clock::now();
+    double producer_ms = 0;
+    {
+        CLogger logger( config );
+        logger.add_sink( std::make_unique< sinks::CFileSink >(
+            LogLevel::INFO, 1024 * 1024 * 1024, 0, false, archive_cfg ) );
+
+        size_t                     per_thread = total / threads;
+        std::vector< std::thread > workers;
+        for ( int t = 0; t < threads; ++t ) {
+            workers.emplace_back( [ &logger, per_thread, t ]() {
+                for ( size_t i = 0; i < per_thread; ++i ) {
+                    logger.info( "worker %d handled request %zu in %d us", t, i, 42 );
+                }
+            } );
+        }
+        for ( auto& worker : workers ) {
+            worker.join();
+        }
+        producer_ms = std::chrono::duration< double, std::milli >(
+                          std::chrono::steady_clock::now() - start )
+                          .count();
+    }
+    double total_ms =
+        std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start )
+            .count();
+    return { producer_ms, total_ms };
+}
+
+}  // anonymous namespace
+
+int main( int argc, char* argv[] ) {
+    size_t total = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 1000000;
+
+    std::printf( "=== Thread scaling benchmark (%zu records per run) ===\n", total );
+    std::printf( "%8s %16s %20s %20s\n", "threads", "sync Mrec/s", "deferred call Mrec/s",
+                 "deferred e2e Mrec/s" );
+
+    for ( int threads : { 1, 2, 4, 8, 16, 32, 64 } ) {
+        Result sync     = run( LogMode::SYNC, threads, total );
+        Result deferred = run( LogMode::DEFERRED, threads, total );
+        std::printf( "%8d %16.2f %20.2f %20.2f\n", threads, total / sync.total_ms / 1000.0,
+                     total / deferred.producer_ms / 1000.0, total / deferred.total_ms / 1000.0 );
+    }
+
+    std::filesystem::remove_all( kBenchDir );
+    return 0;
+}
@@ -24,6 +24,10 @@ int main() {
         std::this_thread::sleep_for( std::chrono::milliseconds( 500 ) );
     }
 
+    // 日志宏会记录调用点的文件、函数和行号，低于 JZLOG_ACTIVE_LEVEL 的级别在编译期被移除
+    JZLOG_INFO( logger, "通过日志宏记录: %s", "带源码位置" );
+    JZLOG_TRACE( logger, "编译期可裁剪的跟踪信息 %d", 0 );
+
     logger.info( "应用程序结束" );
 
     return 0;
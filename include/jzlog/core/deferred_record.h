@@ -0,0 +1,220 @@
+/**
+ * @file deferred_record.h
+ * @brief 延迟格式化的二进制日志记录编解码
+ *
+ * 记录布局：RecordHeader 后紧跟各参数的原始字节。
+ * - 算术类型和指针按值保存
+ * - C 字符串拷贝为 [uint32 长度][字节][\0]，空指针长度记为 kNullString
+ *
+ * 格式串与源码位置只保存指针，因此 DEFERRED 模式要求格式串具有静态存储期（字符串字面量）。
+ */
+#pragma once
+
+#include "log_level.h"
+#include "source_location.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+namespace jzlog
+{
+namespace deferred
+{
+using namespace loglevel;
+
+/**
+ * @brief 解码参数并格式化到 out 的函数指针类型
+ */
+using FormatFn = bool ( * )( const char* fmt, const char* args, std::string& out );
+
+/**
+ * @struct RecordHeader
+ * @brief 二进制记录头部
+ */
+struct RecordHeader {
+    FormatFn              _format;     // 参数解码与格式化函数
+    const char*           _fmt;        // 格式化字符串
+    const SourceLocation* _location;   // 调用点源码位置（静态存储期）
+    uint64_t              _ticks;      // 时间戳原始计数，由后台线程按时钟源换算
+    std::thread::id       _thread_id;  // 线程ID
+    LogLevel              _level;      // 日志级别
+    uint32_t              _size;       // 记录总字节数（含头部）
+};
+
+constexpr uint32_t kNullString = UINT32_MAX;  // 空 C 字符串的长度标记
+
+template < class T >
+inline constexpr bool is_c_string_v =
+    std::is_same_v< T, const char* > || std::is_same_v< T, char* >;
+
+/**
+ * @struct ArgCodec
+ * @brief 单个参数的编解码器（算术类型与非字符指针）
+ * @tparam T 退化后的参数类型
+ */
+template < class T, class Enable = void >
+struct ArgCodec {
+    static_assert( std::is_arithmetic_v< T > || std::is_pointer_v< T >,
+                   "deferred logging only supports arithmetic, pointer and C string arguments" );
+
+    using decoded_type = T;
+
+    static size_t size( const T& ) noexcept { return sizeof( T ); }
+
+    static char* encode( char* dst, const T& value ) noexcept {
+        std::memcpy( dst, &value, sizeof( T ) );
+        return dst + sizeof( T );
+    }
+
+    static T decode( const char*& src ) noexcept {
+        T value{};
+        std::memcpy( &value, src, sizeof( T ) );
+        src += sizeof( T );
+        return value;
+    }
+};
+
+/**
+ * @struct ArgCodec
+ * @brief C 字符串参数的编解码器，拷贝字符串内容
+ */
+template < class T >
+struct ArgCodec< T, std::enable_if_t< is_c_string_v< T > > > {
+    using decoded_type = const char*;
+
+    static size_t size( const char* value ) noexcept {
+        return sizeof( uint32_t ) + ( value ? std::strlen( value ) + 1 : 0 );
+    }
+
+    static char* encode( char* dst, const char* value ) noexcept {
+        uint32_t len = value ? static_cast< uint32_t >( std::strlen( value ) ) : kNullString;
+        std::memcpy( dst, &len, sizeof( len ) );
+        dst += sizeof( len );
+        if ( len != kNullString ) {
+            std::memcpy( dst, value, len + 1 );
+            dst += len + 1;
+        }
+        return dst;
+    }
+
+    static const char* decode( const char*& src ) noexcept {
+        uint32_t len{ 0 };
+        std::memcpy( &len, src, sizeof( len ) );
+        src += sizeof( len );
+        if ( len == kNullString ) {
+            return nullptr;
+        }
+        const char* value = src;
+        src += len + 1;
+        return value;
+    }
+};
+
+template < class T >
+using codec_t = ArgCodec< std::decay_t< T > >;
+
+/**
+ * @brief 使用 snprintf 格式化到 out，复用 out 已有的容量
+ * @return 成功返回 true，失败返回 false
+ */
+template < class... Ts >
+bool format_to( std::string& out, const char* fmt, Ts... values ) {
+    out.resize( out.capacity() );
+    int required = snprintf( out.data(), out.size() + 1, fmt, values... );
+    if ( required < 0 ) {
+        out.clear();
+        return false;
+    }
+    if ( static_cast< size_t >( required ) > out.size() ) {
+        out.resize( required );
+        snprintf( out.data(), out.size() + 1, fmt, values... );
+    } else {
+        out.resize( required );
+    }
+    return true;
+}
+
+/**
+ * @brief 解码参数并格式化，实例化后的地址保存在 RecordHeader::_format 中
+ * @tparam Args 调用点的参数类型
+ */
+template < class... Args >
+bool format_args( const char* fmt, const char* args, std::string& out ) {
+    const char* cursor = args;
+    // 花括号初始化保证从左到右求值
+    std::tuple< typename codec_t< Args >::decoded_type... > values{ codec_t< Args >::decode(
+        cursor )... };
+    (void)cursor;
+    return std::apply(
+        [ & ]( auto... v ) {
+            return format_to( out, fmt, v... );
+        },
+        values );
+}
+
+/**
+ * @brief 计算编码后的记录大小
+ * @return 记录总字节数（含头部）
+ */
+template < class... Args >
+size_t encoded_size( const Args&... args ) noexcept {
+    return sizeof( RecordHeader ) + ( size_t{ 0 } + ... + codec_t< Args >::size( args ) );
+}
+
+/**
+ * @brief 将记录编码到 dst，dst 至少需要 encoded_size() 字节
+ * @param dst 目标地址
+ * @param size encoded_size() 的结果
+ * @param level 日志级别
+ * @param location 调用点源码位置
+ * @param ticks 时间戳原始计数（utils::now_ticks() 的结果）
+ * @param fmt 格式化字符串
+ * @param args 格式化参数
+ */
+template < class... Args >
+void encode( char* dst, size_t size, LogLevel level, const SourceLocation& location,
+             uint64_t ticks, const char* fmt, const Args&... args ) noexcept {
+    RecordHeader header{};
+    header._format    = &format_args< std::decay_t< Args >... >;
+    header._fmt       = fmt;
+    header._location  = &location;
+    header._ticks     = ticks;
+    header._thread_id = std::this_thread::get_id();
+    header._level     = level;
+    header._size      = static_cast< uint32_t >( size );
+    std::memcpy( dst, &header, sizeof( header ) );
+
+    char* cursor = dst + sizeof( header );
+    ( ( cursor = codec_t< Args >::encode( cursor, args ) ), ... );
+    (void)cursor;
+}
+
+/**
+ * @brief 读取记录头部
+ * @param data 记录起始地址
+ * @return 记录头部
+ */
+inline RecordHeader read_header( const char* data ) noexcept {
+    RecordHeader header{};
+    std::memcpy( &header, data, sizeof( header ) );
+    return header;
+}
+
+/**
+ * @brief 格式化记录消息
+ * @param data 记录起始地址
+ * @param out 输出字符串（容量会被复用）
+ * @return 成功返回 true，失败返回 false
+ */
+inline bool format_message( const char* data, std::string& out ) {
+    RecordHeader header = read_header( data );
+    return header._format( header._fmt, data + sizeof( RecordHeader ), out );
+}
+
+}  // namespace deferred
+}  // namespace jzlog
@@ -0,0 +1,174 @@
+/**
+ * @file log_backend.h
+ * @brief 延迟格式化模式的后台分发线程
+ */
+#pragma once
+
+#include "jzlog/core/logger_config.h"
+#include "jzlog/utils/spsc_ring.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace jzlog
+{
+
+/**
+ * @class CLogBackend
+ * @brief 后台分发线程
+ *
+ * 每个生产者线程在第一次记录日志时惰性创建自己的 SPSC 环形缓冲区并注册到后台，
+ * 之后的写入完全无锁。后台线程轮询所有环形缓冲区，把记录交给处理函数（格式化并
+ * 写入各个 sink）。生产者线程退出后，其环形缓冲区在被排空后由后台线程回收。
+ */
+class CLogBackend {
+public:
+    using Handler = std::function< void( const char* data, size_t len ) >;  // 记录处理函数类型
+
+    /**
+     * @struct ProducerRing
+     * @brief 生产者线程的环形缓冲区及其生命周期状态
+     */
+    struct ProducerRing {
+        explicit ProducerRing( size_t capacity ) : _ring( capacity ) {}
+
+        utils::CSpscRing    _ring;               // 环形缓冲区
+        std::atomic< bool > _closed{ false };    // 生产者线程已退出
+        std::atomic< bool > _orphaned{ false };  // 后台已销毁
+    };
+
+    using RingPtr = std::shared_ptr< ProducerRing >;  // 环形缓冲区指针类型
+
+public:
+    /**
+     * @brief 构造函数，启动后台线程
+     * @param config 日志记录器配置（环形缓冲区大小与溢出策略）
+     * @param handler 记录处理函数，只在后台线程中调用
+     */
+    explicit CLogBackend( const LoggerConfig& config, Handler handler ) noexcept;
+
+    /**
+     * @brief 拷贝构造函数（已删除）
+     */
+    CLogBackend( const CLogBackend& ) = delete;
+
+    /**
+     * @brief 拷贝赋值运算符（已删除）
+     */
+    CLogBackend& operator=( const CLogBackend& ) = delete;
+
+    /**
+     * @brief 移动构造函数（已删除）
+     */
+    CLogBackend( CLogBackend&& ) = delete;
+
+    /**
+     * @brief 移动赋值运算符（已删除）
+     */
+    CLogBackend& operator=( CLogBackend&& ) = delete;
+
+    /**
+     * @brief 析构函数，处理完所有环形缓冲区中剩余的记录后停止后台线程
+     */
+    ~CLogBackend();
+
+    /**
+     * @brief 在调用线程的环形缓冲区中写入一条记录
+     * @tparam Encoder 编码函数类型，签名为 void( char* dst )
+     * @param size 记录长度
+     * @param encoder 编码函数，把记录写入 dst
+     * @return 成功返回 true，被丢弃或后台已停止返回 false
+     */
+    template < class Encoder >
+    bool push( size_t size, Encoder&& encoder ) {
+        if ( !_running.load( std::memory_order_relaxed ) ) {
+            return false;
+        }
+
+        ProducerRing* slot = local_ring();
+        if ( slot == nullptr ) {
+            _dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+
+        char* dst = slot->_ring.reserve( size );
+        while ( dst == nullptr ) {
+            if ( _overflow_policy == OverflowPolicy::DROP ||
+                 size > slot->_ring.max_record_size() ||
+                 !_running.load( std::memory_order_relaxed ) ) {
+                _dropped.fetch_add( 1, std::memory_order_relaxed );
+                return false;
+            }
+            wake();
+            std::this_thread::yield();
+            dst = slot->_ring.reserve( size );
+        }
+
+        encoder( dst );
+        slot->_ring.commit();
+
+        if ( _sleeping.load( std::memory_order_relaxed ) ) {
+            wake();
+        }
+        return true;
+    }
+
+    /**
+     * @brief 获取因溢出被丢弃的记录数
+     * @return 丢弃的记录数
+     */
+    uint64_t dropped() const noexcept { return _dropped.load( std::memory_order_relaxed ); }
+
+    /**
+     * @brief 停止后台线程
+     */
+    void stop() noexcept;
+
+private:
+    /**
+     * @brief 获取（必要时创建并注册）调用线程的环形缓冲区
+     * @return 环形缓冲区，创建失败返回 nullptr
+     */
+    ProducerRing* local_ring() noexcept;
+
+    /**
+     * @brief 唤醒后台线程
+     */
+    void wake() noexcept;
+
+    /**
+     * @brief 排空所有环形缓冲区，并回收已退出线程的环形缓冲区
+     * @return 处理的记录数
+     */
+    size_t drain() noexcept;
+
+    /**
+     * @brief 后台工作线程主函数
+     */
+    void work_thread() noexcept;
+
+private:
+    const uint64_t          _id;               // 后台实例 ID，用于线程局部查找
+    const size_t            _ring_size;        // 每个生产者环形缓冲区的大小
+    const OverflowPolicy    _overflow_policy;  // 溢出策略
+    Handler                 _handler;          // 记录处理函数
+    std::vector< RingPtr >  _rings;            // 已注册的环形缓冲区
+    std::vector< RingPtr >  _snapshot;         // 后台线程使用的注册表快照
+    std::atomic< bool >     _rings_changed;    // 注册表已变更
+    std::mutex              _rings_mutex;      // 注册表互斥锁
+    std::mutex              _wait_mutex;       // 等待互斥锁
+    std::condition_variable _cond;             // 条件变量，用于唤醒后台线程
+    std::atomic< bool >     _sleeping;         // 后台线程是否处于等待状态
+    std::atomic< uint64_t > _dropped;          // 丢弃的记录数
+    std::atomic< bool >     _running;          // 线程运行标志
+    std::thread             _thread;           // 后台工作线程
+};
+
+}  // namespace jzlog
@@ -16,12 +16,13 @@ using namespace loglevel;
  * @brief 日记录结构体，存储日志的相关信息
  */
 struct LogRecord {
-    std::chrono::system_clock::time_point _timestamp;    // 时间戳
-    LogLevel                              _level;        // 日志级别
-    std::string                           _logger_name;  // 日志记录器名称
-    std::string                           _message;      // 日志消息
-    std::thread::id                       _thread_id;    // 线程ID
-    std::string                           _function;     // 函数名
-    int                                   _line;         // 行号
+    std::chrono::system_clock::time_point _timestamp;       // 时间戳
+    LogLevel                              _level;           // 日志级别
+    std::string                           _logger_name;     // 日志记录器名称
+    std::string                           _message;         // 日志消息
+    std::thread::id                       _thread_id;       // 线程ID
+    const char*                           _file{ "" };      // 文件名（静态存储期）
+    const char*                           _function{ "" };  // 函数名（静态存储期）
+    int                                   _line{ 0 };       // 行号
 };
 }  // namespace jzlog
@@ -0,0 +1,54 @@
+/**
+ * @file logger_config.h
+ * @brief 日志记录器配置
+ */
+#pragma once
+
+#include "jzlog/utils/clock.h"
+#include <cstddef>
+
+namespace jzlog
+{
+
+constexpr size_t kDefaultRingSize = 256 * 1024;  // 每个生产者线程环形缓冲区的默认大小
+
+/**
+ * @enum LogMode
+ * @brief 日志记录模式
+ */
+enum class LogMode : int
+{
+    SYNC = 0,  // 调用线程格式化并同步写入所有 sink
+    DEFERRED   // 调用线程只保存格式串指针和原始参数，由后台线程格式化并写入 sink
+};
+
+/**
+ * @enum OverflowPolicy
+ * @brief 生产者环形缓冲区写满时的处理策略
+ */
+enum class OverflowPolicy : int
+{
+    BLOCK = 0,  // 等待后台线程腾出空间
+    DROP        // 丢弃当前记录并计数
+};
+
+/**
+ * @brief 日志记录器配置结构体
+ */
+struct LoggerConfig {
+    LogMode            mode;             ///< 日志记录模式，默认 SYNC
+    size_t             ring_size;        ///< DEFERRED 模式下每个生产者线程的环形缓冲区大小（字节）
+    OverflowPolicy     overflow_policy;  ///< DEFERRED 模式下环形缓冲区写满时的策略，默认 BLOCK
+    utils::ClockSource clock;            ///< 时间戳时钟源，默认 SYSTEM
+
+    /**
+     * @brief 默认构造函数，初始化为默认配置
+     */
+    LoggerConfig() :
+        mode( LogMode::SYNC ),
+        ring_size( kDefaultRingSize ),
+        overflow_policy( OverflowPolicy::BLOCK ),
+        clock( utils::ClockSource::SYSTEM ) {}
+};
+
+}  // namespace jzlog
@@ -0,0 +1,273 @@
+/**
+ * @file pattern_formatter.h
+ * @brief 模式串日志格式化器
+ *
+ * 模式串在构造（或 set_pattern）时编译为扁平的步骤列表，格式化时逐步追加到输出缓冲区，
+ * 不经过 iostream，也不产生临时 std::string。支持的占位符：
+ *
+ * | 占位符 | 含义                         | 占位符 | 含义                     |
+ * |--------|------------------------------|--------|--------------------------|
+ * | %Y     | 年（4 位）                   | %l     | 日志级别                 |
+ * | %m     | 月（2 位）                   | %t     | 线程 ID                  |
+ * | %d     | 日（2 位）                   | %v     | 日志消息                 |
+ * | %H     | 时（2 位）                   | %s     | 源文件名（不含目录）     |
+ * | %M     | 分（2 位）                   | %g     | 源文件完整路径           |
+ * | %S     | 秒（2 位）                   | %!     | 函数名                   |
+ * | %e     | 毫秒（3 位）                 | %#     | 行号                     |
+ * | %f     | 微秒（6 位）                 | %n     | 换行                     |
+ * | %z     | UTC 偏移（+HH:MM）           | %%     | 百分号                   |
+ *
+ * 日期时间字段直接切取 utils::format_timestamp() 缓存的秒级前缀。
+ * 未识别的占位符按原样输出。
+ */
+#pragma once
+
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/utils/fixed_buffer.h"
+#include "jzlog/utils/time_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace jzlog
+{
+
+// 与旧版 format_log_record 输出一致的默认模式
+constexpr std::string_view kDefaultPattern{ "%Y-%m-%d %H:%M:%S [%l] [%t][%!:%#]%v%n" };
+
+/**
+ * @class CPatternFormatter
+ * @brief 模式串日志格式化器
+ * @note set_pattern() 不是线程安全的，应在开始记录日志前调用
+ */
+class CPatternFormatter {
+public:
+    /**
+     * @brief 构造函数
+     * @param pattern 模式串
+     */
+    explicit CPatternFormatter( std::string_view pattern = kDefaultPattern );
+
+    /**
+     * @brief 重新编译模式串
+     * @param pattern 模式串
+     */
+    void set_pattern( std::string_view pattern );
+
+    /**
+     * @brief 获取模式串
+     * @return 模式串
+     */
+    const std::string& pattern() const noexcept { return _pattern; }
+
+    /**
+     * @brief 格式化日志记录，追加到固定缓冲区
+     * @tparam N 缓冲区大小
+     * @param r 日志记录
+     * @param out 输出缓冲区
+     * @return 成功返回 true，缓冲区空间不足返回 false（此时缓冲区内容不完整）
+     */
+    template < size_t N >
+    bool format_to( const LogRecord& r, utils::FixedBuffer< N >& out ) const noexcept {
+        return render( r, [ &out ]( const char* data, size_t len ) {
+            return len == 0 || out.append( data, len );
+        } );
+    }
+
+    /**
+     * @brief 格式化日志记录，追加到字符串
+     * @param r 日志记录
+     * @param out 输出字符串
+     */
+    void format_to( const LogRecord& r, std::string& out ) const {
+        render( r, [ &out ]( const char* data, size_t len ) {
+            out.append( data, len );
+            return true;
+        } );
+    }
+
+    /**
+     * @brief 格式化日志记录到调用线程的局部缓冲区
+     * @details 先尝试线程局部的 FixedBuffer，超长时退化为线程局部的 std::string
+     *          （容量保留复用），稳态下不触碰堆。
+     * @param r 日志记录
+     * @return 格式化结果，在同一线程下一次调用 format() 前有效
+     */
+    std::string_view format( const LogRecord& r ) const {
+        thread_local utils::FixedBuffer< utils::kSmallBuffer > tls_buffer;
+        thread_local std::string                               tls_string;
+
+        tls_buffer.reset();
+        if ( format_to( r, tls_buffer ) ) {
+            return { tls_buffer.data(), tls_buffer.length() };
+        }
+        tls_string.clear();
+        format_to( r, tls_string );
+        return tls_string;
+    }
+
+private:
+    /**
+     * @enum StepType
+     * @brief 格式化步骤类型
+     */
+    enum class StepType : uint8_t
+    {
+        LITERAL = 0,  // 字面量，_offset/_length 指向 _literals
+        DATETIME,     // 日期时间字段，_offset/_length 指向秒级前缀
+        MILLIS,       // 毫秒
+        MICROS,       // 微秒
+        UTC_OFFSET,   // UTC 偏移
+        LEVEL,        // 日志级别
+        THREAD,       // 线程 ID
+        MESSAGE,      // 日志消息
+        FILE_NAME,    // 源文件名
+        FILE_PATH,    // 源文件完整路径
+        FUNCTION,     // 函数名
+        LINE          // 行号
+    };
+
+    /**
+     * @struct Step
+     * @brief 格式化步骤
+     */
+    struct Step {
+        StepType _type;    // 步骤类型
+        uint32_t _offset;  // 字面量或前缀切片的偏移
+        uint32_t _length;  // 字面量或前缀切片的长度
+    };
+
+    /**
+     * @brief 追加字面量步骤，与前一个字面量步骤合并
+     */
+    void add_literal( const char* data, size_t len );
+
+    /**
+     * @brief 追加日期时间切片步骤，与前一个连续切片合并
+     */
+    void add_datetime( uint32_t offset, uint32_t length );
+
+    /**
+     * @brief 将无符号整数写为十进制
+     * @return 写入的字节数
+     */
+    static size_t write_decimal( char* dst, uint64_t value ) noexcept {
+        char   tmp[ 20 ];
+        size_t n = 0;
+        do {
+            tmp[ n++ ] = static_cast< char >( '0' + value % 10 );
+            value /= 10;
+        } while ( value != 0 );
+        for ( size_t i = 0; i < n; ++i ) {
+            dst[ i ] = tmp[ n - 1 - i ];
+        }
+        return n;
+    }
+
+    /**
+     * @brief 将线程 ID 转换为整数，与 operator<< 的输出保持一致
+     */
+    static uint64_t thread_number( const std::thread::id& id ) noexcept {
+        if constexpr ( sizeof( std::thread::id ) == sizeof( uint64_t ) ) {
+            uint64_t value{ 0 };
+            std::memcpy( &value, &id, sizeof( value ) );
+            return value;
+        } else {
+            return std::hash< std::thread::id >{}( id );
+        }
+    }
+
+    /**
+     * @brief 逐步执行格式化
+     * @tparam Put 输出函数类型，签名为 bool( const char* data, size_t len )
+     * @param r 日志记录
+     * @param put 输出函数
+     * @return 全部输出成功返回 true，否则返回 false
+     */
+    template < class Put >
+    bool render( const LogRecord& r, Put&& put ) const {
+        int64_t     second{ 0 };
+        uint32_t    micros{ 0 };
+        const char* prefix = nullptr;
+        if ( _needs_time ) {
+            utils::detail::split( r._timestamp, second, micros );
+            prefix = utils::detail::timestamp_cache().prefix( second );
+        }
+
+        char scratch[ 24 ];
+        for ( const auto& step : _steps ) {
+            bool ok = true;
+            switch ( step._type ) {
+            case ( StepType::LITERAL ):
+                ok = put( _literals.data() + step._offset, step._length );
+                break;
+            case ( StepType::DATETIME ):
+                ok = put( prefix + step._offset, step._length );
+                break;
+            case ( StepType::MILLIS ):
+                utils::detail::write_digits( scratch, micros / 1000, 3 );
+                ok = put( scratch, 3 );
+                break;
+            case ( StepType::MICROS ):
+                utils::detail::write_digits( scratch, micros, 6 );
+                ok = put( scratch, 6 );
+                break;
+            case ( StepType::UTC_OFFSET ):
+                ok = put( scratch, utils::format_utc_offset(
+                                       utils::detail::timestamp_cache().offset( second ),
+                                       scratch ) );
+                break;
+            case ( StepType::LEVEL ): {
+                auto level = loglevel::to_string( r._level );
+                ok         = put( level.data(), level.size() );
+                break;
+            }
+            case ( StepType::THREAD ):
+                ok = put( scratch, write_decimal( scratch, thread_number( r._thread_id ) ) );
+                break;
+            case ( StepType::MESSAGE ):
+                ok = put( r._message.data(), r._message.size() );
+                break;
+            case ( StepType::FILE_NAME ): {
+                const char* slash = std::strrchr( r._file, '/' );
+                const char* name  = slash ? slash + 1 : r._file;
+                ok                = put( name, std::strlen( name ) );
+                break;
+            }
+            case ( StepType::FILE_PATH ):
+                ok = put( r._file, std::strlen( r._file ) );
+                break;
+            case ( StepType::FUNCTION ):
+                ok = put( r._function, std::strlen( r._function ) );
+                break;
+            case ( StepType::LINE ):
+                if ( r._line < 0 ) {
+                    ok = put( "-", 1 ) &&
+                         put( scratch, write_decimal( scratch, -static_cast< int64_t >(
+                                                                    r._line ) ) );
+                } else {
+                    ok = put( scratch, write_decimal( scratch, r._line ) );
+                }
+                break;
+            }
+            if ( !ok ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::string         _pattern;              // 模式串
+    std::string         _literals;             // 所有字面量拼接而成的存储区
+    std::vector< Step > _steps;                // 编译后的步骤列表
+    bool                _needs_time{ false };  // 是否包含时间字段
+};
+
+}  // namespace jzlog
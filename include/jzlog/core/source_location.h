@@ -0,0 +1,25 @@
+/**
+ * @file source_location.h
+ * @brief 日志调用点的源码位置
+ */
+#pragma once
+
+namespace jzlog
+{
+
+/**
+ * @struct SourceLocation
+ * @brief 源码位置，由日志宏在调用点以静态常量数据的形式生成
+ */
+struct SourceLocation {
+    const char* _file;      // 文件名
+    const char* _function;  // 函数名
+    int         _line;      // 行号
+};
+
+/**
+ * @brief 未知源码位置，用于不经过日志宏的调用
+ */
+inline constexpr SourceLocation kUnknownLocation{ "", "", 0 };
+
+}  // namespace jzlog
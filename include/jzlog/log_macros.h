@@ -0,0 +1,76 @@
+/**
+ * @file log_macros.h
+ * @brief 日志宏：调用点源码位置捕获与编译期级别裁剪
+ *
+ * 用法：JZLOG_INFO( logger, "处理任务 #%d", id );
+ *
+ * 文件名、函数名和行号在调用点生成为静态常量数据，记录中只保存指针。
+ * 低于 JZLOG_ACTIVE_LEVEL 的宏展开为空语句，参数不会被求值，也不会生成任何代码；
+ * 运行期被日志记录器级别过滤的调用同样不会求值参数。
+ */
+#pragma once
+
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/source_location.h"
+
+#define JZLOG_LEVEL_TRACE 0
+#define JZLOG_LEVEL_DEBUG 1
+#define JZLOG_LEVEL_INFO  2
+#define JZLOG_LEVEL_WARN  3
+#define JZLOG_LEVEL_ERROR 4
+#define JZLOG_LEVEL_FATAL 5
+#define JZLOG_LEVEL_OFF   6
+
+// 编译期最低日志级别，可在编译选项中通过 -DJZLOG_ACTIVE_LEVEL=JZLOG_LEVEL_INFO 等指定
+#ifndef JZLOG_ACTIVE_LEVEL
+#define JZLOG_ACTIVE_LEVEL JZLOG_LEVEL_TRACE
+#endif
+
+#define JZLOG_LOG_( logger, level, ... )                                                       \
+    do {                                                                                       \
+        static constexpr ::jzlog::SourceLocation jzlog_location_{ __FILE__, __func__,         \
+                                                                  __LINE__ };                  \
+        if ( ( logger ).should_log( level ) ) {                                                \
+            ( logger ).log( level, jzlog_location_, __VA_ARGS__ );                             \
+        }                                                                                      \
+    } while ( 0 )
+
+#define JZLOG_DISABLED_( logger, ... )                                                         \
+    do {                                                                                       \
+    } while ( 0 )
+
+#if JZLOG_ACTIVE_LEVEL <= JZLOG_LEVEL_TRACE
+#define JZLOG_TRACE( logger, ... ) JZLOG_LOG_( logger, ::jzlog::LogLevel::TRACE, __VA_ARGS__ )
+#else
+#define JZLOG_TRACE( logger, ... ) JZLOG_DISABLED_( logger, __VA_ARGS__ )
+#endif
+
+#if JZLOG_ACTIVE_LEVEL <= JZLOG_LEVEL_DEBUG
+#define JZLOG_DEBUG( logger, ... ) JZLOG_LOG_( logger, ::jzlog::LogLevel::DEBUG, __VA_ARGS__ )
+#else
+#define JZLOG_DEBUG( logger, ... ) JZLOG_DISABLED_( logger, __VA_ARGS__ )
+#endif
+
+#if JZLOG_ACTIVE_LEVEL <= JZLOG_LEVEL_INFO
+#define JZLOG_INFO( logger, ... ) JZLOG_LOG_( logger, ::jzlog::LogLevel::INFO, __VA_ARGS__ )
+#else
+#define JZLOG_INFO( logger, ... ) JZLOG_DISABLED_( logger, __VA_ARGS__ )
+#endif
+
+#if JZLOG_ACTIVE_LEVEL <= JZLOG_LEVEL_WARN
+#define JZLOG_WARN( logger, ... ) JZLOG_LOG_( logger, ::jzlog::LogLevel::WARN, __VA_ARGS__ )
+#else
+#define JZLOG_WARN( logger, ... ) JZLOG_DISABLED_( logger, __VA_ARGS__ )
+#endif
+
+#if JZLOG_ACTIVE_LEVEL <= JZLOG_LEVEL_ERROR
+#define JZLOG_ERROR( logger, ... ) JZLOG_LOG_( logger, ::jzlog::LogLevel::ERROR, __VA_ARGS__ )
+#else
+#define JZLOG_ERROR( logger, ... ) JZLOG_DISABLED_( logger, __VA_ARGS__ )
+#endif
+
+#if JZLOG_ACTIVE_LEVEL <= JZLOG_LEVEL_FATAL
+#define JZLOG_FATAL( logger, ... ) JZLOG_LOG_( logger, ::jzlog::LogLevel::FATAL, __VA_ARGS__ )
+#else
+#define JZLOG_FATAL( logger, ... ) JZLOG_DISABLED_( logger, __VA_ARGS__ )
+#endif
@@ -4,7 +4,10 @@
  */
 #pragma once
 
+#include "jzlog/core/logger_config.h"
+#include "jzlog/core/source_location.h"
 #include "jzlog/sinks/sink.h"
+#include "log_macros.h"
 #include "logger_impl.hpp"
 #include <memory>
 #include <string_view>
@@ -42,6 +45,28 @@ public:
      */
     explicit CLogger() : _impl( std::make_unique< CLoggerImpl >() ) {}
 
+    /**
+     * @brief 构造函数（带配置）
+     * @param config 日志记录器配置
+     */
+    explicit CLogger( const LoggerConfig& config ) :
+        _impl( std::make_unique< CLoggerImpl >( config ) ) {}
+
+    /**
+     * @brief 在指定源码位置记录日志，通常通过 JZLOG_INFO 等宏调用
+     * @tparam Args 可变模板参数类型
+     * @param level 日志级别
+     * @param location 调用点源码位置（静态存储期）
+     * @param fmt 格式化字符串
+     * @param args 格式化参数
+     * @return 成功返回 true，失败返回 false
+     */
+    template < class... Args >
+    bool log( LogLevel level, const SourceLocation& location, std::string_view fmt,
+              Args&&... args ) const {
+        return this->_impl->log( level, location, fmt, std::forward< Args >( args )... );
+    }
+
     /**
      * @brief 记录 INFO 级别日志
      * @tparam Args 可变模板参数类型
@@ -123,6 +148,36 @@ public:
         return _impl->add_sink( std::move( sink ) );
     }
 
+    /**
+     * @brief 设置日志记录器级别，低于该级别或低于所有 sink 级别的调用不做任何格式化
+     * @param level 日志级别
+     */
+    void set_level( LogLevel level ) const noexcept { _impl->set_level( level ); }
+
+    /**
+     * @brief 获取日志记录器级别
+     * @return 日志记录器级别
+     */
+    LogLevel level() const noexcept { return _impl->level(); }
+
+    /**
+     * @brief 在外部直接修改 sink 级别后，重新计算最低有效级别
+     */
+    void update_min_level() const noexcept { _impl->update_min_level(); }
+
+    /**
+     * @brief 判断该级别是否可能被记录（一次 relaxed 读和一次分支）
+     * @param level 日志级别
+     * @return 可能被记录返回 true，否则返回 false
+     */
+    bool should_log( LogLevel level ) const noexcept { return _impl->should_log( level ); }
+
+    /**
+     * @brief 获取 DEFERRED 模式下因环形缓冲区溢出被丢弃的记录数
+     * @return 丢弃的记录数
+     */
+    uint64_t dropped() const noexcept { return _impl->dropped(); }
+
 private:
     std::unique_ptr< CLoggerImpl > _impl;  // 日志实现类智能指针
 };
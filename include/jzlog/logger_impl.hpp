@@ -3,9 +3,19 @@
  * @brief 日志记录器实现类
  */
 #pragma once
+#include "jzlog/core/deferred_record.h"
+#include "jzlog/core/log_backend.h"
 #include "jzlog/core/log_level.h"
 #include "jzlog/core/log_record.h"
+#include "jzlog/core/logger_config.h"
+#include "jzlog/core/pattern_formatter.h"
+#include "jzlog/core/source_location.h"
 #include "jzlog/sinks/sink.h"
+#include "jzlog/utils/clock.h"
+#include "jzlog/utils/fixed_buffer.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdio>
 #include <memory>
 #include <string>
@@ -28,6 +38,24 @@ public:
      */
     explicit CLoggerImpl() noexcept {}
 
+    /**
+     * @brief 构造函数（带配置）
+     * @param config 日志记录器配置
+     * @note DEFERRED 模式下格式串必须具有静态存储期，且应在开始记录日志前添加 sink
+     */
+    explicit CLoggerImpl( const LoggerConfig& config ) : _clock( config.clock ) {
+        if ( _clock == utils::ClockSource::TSC ) {
+            // 在构造时完成校准，避免首条日志承担校准开销
+            utils::CTscClock::instance();
+        }
+        if ( config.mode == LogMode::DEFERRED ) {
+            _backend = std::make_unique< CLogBackend >(
+                config, [ this ]( const char* data, size_t len ) {
+                    consume( data, len );
+                } );
+        }
+    }
+
     /**
      * @brief 拷贝构造函数（已删除）
      */
@@ -49,11 +77,33 @@ public:
     CLoggerImpl& operator=( CLoggerImpl&& oth ) = delete;
 
     /**
-     * @brief 析构函数
+     * @brief 析构函数，DEFERRED 模式下先处理完队列中剩余的记录
      */
-    ~CLoggerImpl() = default;
+    ~CLoggerImpl() {
+        if ( _backend ) {
+            _backend->stop();
+        }
+    }
 
 public:
+    /**
+     * @brief 在指定源码位置记录日志，供日志宏使用
+     * @tparam Args 可变模板参数类型
+     * @param level 日志级别
+     * @param location 调用点源码位置（静态存储期）
+     * @param fmt 格式化字符串
+     * @param args 格式化参数
+     * @return 成功返回 true，失败返回 false
+     */
+    template < class... Args >
+    inline bool log( LogLevel level, const SourceLocation& location, std::string_view fmt,
+                     Args&&... args ) const {
+        if ( !should_log( level ) ) {
+            return false;
+        }
+        return add_record( level, location, fmt, std::forward< Args >( args )... );
+    }
+
     /**
      * @brief 记录 INFO 级别日志
      * @tparam Args 可变模板参数类型
@@ -63,7 +113,11 @@ public:
      */
     template < class... Args >
     inline bool info( std::string_view fmt, Args&&... args ) const {
-        return add_record( LogLevel ::INFO, fmt, std::forward< Args >( args )... );
+        if ( !should_log( LogLevel::INFO ) ) {
+            return false;
+        }
+        return add_record( LogLevel::INFO, kUnknownLocation, fmt,
+                           std::forward< Args >( args )... );
     }
 
     /**
@@ -75,7 +129,11 @@ public:
      */
     template < class... Args >
     inline bool trace( std::string_view fmt, Args&&... args ) const {
-        return add_record( LogLevel::TRACE, fmt, std::forward< Args >( args )... );
+        if ( !should_log( LogLevel::TRACE ) ) {
+            return false;
+        }
+        return add_record( LogLevel::TRACE, kUnknownLocation, fmt,
+                           std::forward< Args >( args )... );
     }
 
     /**
@@ -87,7 +145,11 @@ public:
      */
     template < class... Args >
     inline bool debug( std::string_view fmt, Args&&... args ) const {
-        return add_record( LogLevel::DEBUG, fmt, std::forward< Args >( args )... );
+        if ( !should_log( LogLevel::DEBUG ) ) {
+            return false;
+        }
+        return add_record( LogLevel::DEBUG, kUnknownLocation, fmt,
+                           std::forward< Args >( args )... );
     }
 
     /**
@@ -99,7 +161,11 @@ public:
      */
     template < class... Args >
     inline bool warn( std::string_view fmt, Args&&... args ) const {
-        return add_record( LogLevel::WARN, fmt, std::forward< Args >( args )... );
+        if ( !should_log( LogLevel::WARN ) ) {
+            return false;
+        }
+        return add_record( LogLevel::WARN, kUnknownLocation, fmt,
+                           std::forward< Args >( args )... );
     }
 
     /**
@@ -111,7 +177,11 @@ public:
      */
     template < class... Args >
     inline bool error( std::string_view fmt, Args&&... args ) const {
-        return add_record( LogLevel::ERROR, fmt, std::forward< Args >( args )... );
+        if ( !should_log( LogLevel::ERROR ) ) {
+            return false;
+        }
+        return add_record( LogLevel::ERROR, kUnknownLocation, fmt,
+                           std::forward< Args >( args )... );
     }
 
     /**
@@ -123,7 +193,11 @@ public:
      */
     template < class... Args >
     inline bool fatal( std::string_view fmt, Args&&... args ) const {
-        return add_record( LogLevel::FATAL, fmt, std::forward< Args >( args )... );
+        if ( !should_log( LogLevel::FATAL ) ) {
+            return false;
+        }
+        return add_record( LogLevel::FATAL, kUnknownLocation, fmt,
+                           std::forward< Args >( args )... );
     }
 
     /**
@@ -136,62 +210,222 @@ public:
             return false;
         }
         _sinks.emplace_back( std::move( sink ) );
+        update_min_level();
         return true;
     }
 
+    /**
+     * @brief 设置日志记录器级别，与各 sink 的级别共同决定最低有效级别
+     * @param level 日志级别
+     */
+    void set_level( LogLevel level ) noexcept {
+        _level = level;
+        update_min_level();
+    }
+
+    /**
+     * @brief 获取日志记录器级别
+     * @return 日志记录器级别
+     */
+    LogLevel level() const noexcept { return _level; }
+
+    /**
+     * @brief 重新计算最低有效级别
+     * @note add_sink() 与 set_level() 会自动调用；在外部直接修改 sink 级别后需手动调用
+     */
+    void update_min_level() noexcept {
+        LogLevel min_sink_level = LogLevel::OFF;
+        for ( auto& sink : _sinks ) {
+            min_sink_level = std::min( min_sink_level, sink->level() );
+        }
+        _min_level.store( std::max( _level, min_sink_level ), std::memory_order_relaxed );
+    }
+
+    /**
+     * @brief 判断该级别是否可能被记录，禁用的调用只需一次 relaxed 读和一次分支
+     * @param level 日志级别
+     * @return 可能被记录返回 true，否则返回 false
+     */
+    inline bool should_log( LogLevel level ) const noexcept {
+        return level >= _min_level.load( std::memory_order_relaxed );
+    }
+
+    /**
+     * @brief 获取 DEFERRED 模式下因环形缓冲区溢出被丢弃的记录数
+     * @return 丢弃的记录数，SYNC 模式下恒为 0
+     */
+    uint64_t dropped() const noexcept { return _backend ? _backend->dropped() : 0; }
+
 private:
     /**
      * @brief 将日志记录写入所有输出目标
+     * @details 提供格式化器的 sink 按模式串分组：每种模式串最多渲染一次（惰性，只在有 sink
+     *          接受该级别时渲染），渲染结果保存在线程局部字符串中（容量保留复用），
+     *          再通过 write_formatted() 交给所有使用相同模式串的 sink。
+     *          超过 kMaxSharedLayouts 种模式串时，其余 sink 退化为 write()。
      * @param record 日志记录
      * @return 所有输出目标都成功返回 true，否则返回 false
      */
-    bool log( LogRecord&& record ) const {
+    bool log( const LogRecord& record ) const {
+        thread_local std::array< std::string, kMaxSharedLayouts > tls_lines;
+
+        std::array< const CPatternFormatter*, kMaxSharedLayouts > layouts{};
+        size_t                                                    layout_count = 0;
+
         bool all_success = true;
         for ( auto& sink : _sinks ) {
-            if ( !sink->write( record ) ) {
-                all_success = false;
+            const CPatternFormatter* formatter = sink->formatter();
+            if ( formatter == nullptr || !sink->should_log( record._level ) ) {
+                all_success = sink->write( record ) && all_success;
+                continue;
             }
+
+            size_t idx = 0;
+            while ( idx < layout_count && layouts[ idx ] != formatter &&
+                    layouts[ idx ]->pattern() != formatter->pattern() ) {
+                ++idx;
+            }
+            if ( idx == layout_count ) {
+                if ( layout_count == kMaxSharedLayouts ) {
+                    all_success = sink->write( record ) && all_success;
+                    continue;
+                }
+                tls_lines[ idx ].clear();
+                formatter->format_to( record, tls_lines[ idx ] );
+                layouts[ idx ] = formatter;
+                ++layout_count;
+            }
+            all_success = sink->write_formatted( record, tls_lines[ idx ] ) && all_success;
         }
         return all_success;
     }
 
     /**
      * @brief 添加日志记录
+     * @details 先按时钟源采集时间戳，再单次格式化到线程局部的 FixedBuffer，
+     *          并复用线程局部的 LogRecord，稳态下不触碰堆；只有消息超过 kSmallBuffer
+     *          时才直接格式化到 record._message（其容量随后被保留复用）。
+     *          注意：sink 在 write() 中不应再通过同一线程记录日志。
      * @tparam Args 可变模板参数类型
      * @param level 日志级别
+     * @param location 调用点源码位置
      * @param fmt 格式化字符串
      * @param args 格式化参数
      * @return 成功返回 true，失败返回 false
      */
     template < class... Args >
-    bool add_record( LogLevel level, std::string_view fmt, Args&&... args ) const {
-        int required = snprintf( nullptr, 0, fmt.data(), std::forward< Args >( args )... );
+    bool add_record( LogLevel level, const SourceLocation& location, std::string_view fmt,
+                     Args&&... args ) const {
+        uint64_t ticks = utils::now_ticks( _clock );
+        if ( _backend ) {
+            return add_deferred( level, location, ticks, fmt, args... );
+        }
+
+        thread_local utils::FixedBuffer< utils::kSmallBuffer > tls_buffer;
+        thread_local LogRecord                                 tls_record;
+
+        tls_buffer.reset();
+        int required = snprintf( tls_buffer.current(), tls_buffer.avail(), fmt.data(), args... );
 
         if ( required < 0 ) {
             return false;
         }
 
-        std::vector< char > buf;
-        LogRecord           record;
+        LogRecord& record = tls_record;
 
         try {
-            buf.resize( required + 1, 0 );
-            snprintf( buf.data(), required + 1, fmt.data(), std::forward< Args >( args )... );
+            if ( static_cast< size_t >( required ) < tls_buffer.avail() ) {
+                tls_buffer.add( required );
+                record._message.assign( tls_buffer.data(), tls_buffer.length() );
+            } else {
+                record._message.resize( required );
+                snprintf( record._message.data(), required + 1, fmt.data(), args... );
+            }
 
-            record._function  = __func__;
-            record._line      = __LINE__;
+            record._timestamp = utils::to_time_point( _clock, ticks );
+            record._file      = location._file;
+            record._function  = location._function;
+            record._line      = location._line;
             record._thread_id = std::this_thread::get_id();
-            record._message   = std::string( buf.data(), required );
             record._level     = level;
 
-            return log( std::move( record ) );
+            return log( record );
         } catch ( ... ) {
             return false;
         }
     }
 
+    /**
+     * @brief 判断是否有输出目标接受该级别的日志
+     * @param level 日志级别
+     * @return 至少一个输出目标接受返回 true，否则返回 false
+     */
+    bool any_sink_accepts( LogLevel level ) const noexcept {
+        for ( auto& sink : _sinks ) {
+            if ( sink->should_log( level ) ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 添加延迟格式化的日志记录，只编码参数，不做格式化
+     * @tparam Args 可变模板参数类型
+     * @param level 日志级别
+     * @param location 调用点源码位置（静态存储期）
+     * @param ticks 时间戳原始计数
+     * @param fmt 格式化字符串（要求静态存储期）
+     * @param args 格式化参数
+     * @return 成功写入环形缓冲区返回 true，被丢弃返回 false
+     */
+    template < class... Args >
+    bool add_deferred( LogLevel level, const SourceLocation& location, uint64_t ticks,
+                       std::string_view fmt, const Args&... args ) const {
+        size_t size = deferred::encoded_size( args... );
+        return _backend->push( size, [ & ]( char* dst ) {
+            deferred::encode( dst, size, level, location, ticks, fmt.data(), args... );
+        } );
+    }
+
+    /**
+     * @brief 在后台线程中格式化一条二进制记录并写入输出目标
+     * @param data 记录起始地址
+     * @param len 记录长度
+     */
+    void consume( const char* data, size_t len ) {
+        if ( len < sizeof( deferred::RecordHeader ) ) {
+            return;
+        }
+
+        auto header = deferred::read_header( data );
+        if ( !should_log( header._level ) || !any_sink_accepts( header._level ) ) {
+            return;
+        }
+
+        LogRecord& record = _deferred_record;
+        if ( !deferred::format_message( data, record._message ) ) {
+            return;
+        }
+        record._timestamp = utils::to_time_point( _clock, header._ticks );
+        record._file      = header._location->_file;
+        record._function  = header._location->_function;
+        record._line      = header._location->_line;
+        record._thread_id = header._thread_id;
+        record._level     = header._level;
+
+        log( record );
+    }
+
 private:
+    static constexpr size_t kMaxSharedLayouts = 4;  // 单条记录最多共享渲染的模式串种类数
+
     std::vector< std::unique_ptr< sinks::ISink > > _sinks;  // 日志输出目标列表
+    LogLevel                       _level{ LogLevel::TRACE };     // 日志记录器级别
+    std::atomic< LogLevel >        _min_level{ LogLevel::OFF };   // 最低有效级别缓存（含各 sink）
+    utils::ClockSource             _clock{ utils::ClockSource::SYSTEM };  // 时间戳时钟源
+    LogRecord                      _deferred_record;              // 后台线程复用的日志记录
+    std::unique_ptr< CLogBackend > _backend;                      // 后台线程，仅 DEFERRED 模式
 };
 
 }  // namespace jzlog
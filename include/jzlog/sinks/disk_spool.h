@@ -0,0 +1,157 @@
+/**
+ * @file disk_spool.h
+ * @brief 网络发送失败时暂存批次的磁盘队列
+ *
+ * 目录下的分段文件 spool_NNNNNNNNNNNNNNNN.seg 按编号顺序组成一个只追加的先进先出队列，每个批次
+ * 以 16 字节的记录头（魔数、载荷长度、记录数）开头。尾分段写满 segment_bytes 后换新分段，读完的
+ * 头分段被删除；读取位置（分段编号与偏移）写入 cursor 文件，重启后从断点继续。尾分段末尾因进程
+ * 退出而残缺的批次在打开时被截掉。队列总大小不超过 max_bytes，超出时拒绝新批次。
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <sys/uio.h>
+#include <vector>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+/**
+ * @class CDiskSpool
+ * @brief 分段的只追加磁盘队列
+ * @note 非线程安全，调用方需串行化所有调用
+ */
+class CDiskSpool {
+public:
+    /**
+     * @brief 构造函数，打开或恢复目录下已有的队列
+     * @param dir 队列目录，不存在时创建
+     * @param max_bytes 队列总大小上限（字节，含记录头）
+     * @param segment_bytes 单个分段的大小（字节）
+     */
+    explicit CDiskSpool( std::string dir, size_t max_bytes, size_t segment_bytes ) noexcept;
+
+    /**
+     * @brief 拷贝构造函数（已删除）
+     */
+    CDiskSpool( const CDiskSpool& ) = delete;
+
+    /**
+     * @brief 拷贝赋值运算符（已删除）
+     */
+    CDiskSpool& operator=( const CDiskSpool& ) = delete;
+
+    /**
+     * @brief 析构函数，关闭分段与读取位置文件
+     */
+    ~CDiskSpool();
+
+    /**
+     * @brief 判断队列是否可用
+     * @return 目录与尾分段打开成功返回 true
+     */
+    bool valid() const noexcept { return _tail_fd >= 0; }
+
+    /**
+     * @brief 追加一个批次
+     * @param iov 批次数据
+     * @param count iovec 个数
+     * @param records 批次中的记录数
+     * @return 成功返回 true，超过 max_bytes 或写入失败返回 false
+     */
+    bool push( const struct iovec* iov, int count, uint32_t records ) noexcept;
+
+    /**
+     * @brief 读取队首批次，不移出队列
+     * @param payload 返回批次数据（容量保留复用）
+     * @param records 返回批次中的记录数
+     * @return 队列非空返回 true
+     */
+    bool front( std::string& payload, uint32_t& records ) noexcept;
+
+    /**
+     * @brief 移出 front() 读到的队首批次并持久化读取位置
+     */
+    void pop() noexcept;
+
+    /**
+     * @brief 判断队列是否为空
+     * @return 没有待读取的批次返回 true
+     */
+    bool empty() const noexcept { return _bytes == 0; }
+
+    /**
+     * @brief 获取队列中待读取的字节数
+     * @return 字节数（含记录头）
+     */
+    uint64_t bytes() const noexcept { return _bytes; }
+
+private:
+    /**
+     * @struct Segment
+     * @brief 分段文件
+     */
+    struct Segment {
+        uint64_t _id{ 0 };    // 分段编号
+        uint64_t _size{ 0 };  // 已写入大小
+    };
+
+    /**
+     * @brief 扫描目录恢复分段列表与读取位置，截掉尾分段末尾残缺的批次
+     */
+    void recover() noexcept;
+
+    /**
+     * @brief 查找分段中最后一个完整批次的结尾
+     * @param fd 分段文件描述符
+     * @param offset 开始扫描的偏移
+     * @param size 分段大小
+     * @return 有效数据的结尾偏移
+     */
+    uint64_t valid_end( int fd, uint64_t offset, uint64_t size ) const noexcept;
+
+    /**
+     * @brief 以编号 id 新建尾分段并打开
+     * @param id 分段编号
+     * @return 成功返回 true
+     */
+    bool open_tail( uint64_t id ) noexcept;
+
+    /**
+     * @brief 删除已读完的头分段，尾分段读完时清空重用
+     */
+    void advance_head() noexcept;
+
+    /**
+     * @brief 将读取位置写入 cursor 文件
+     */
+    void save_cursor() noexcept;
+
+    /**
+     * @brief 获取分段文件路径
+     * @param id 分段编号
+     * @return 文件路径
+     */
+    std::string segment_path( uint64_t id ) const;
+
+private:
+    std::string                 _dir;            // 队列目录
+    uint64_t                    _max_bytes;      // 队列总大小上限
+    uint64_t                    _segment_bytes;  // 单个分段的大小
+    std::deque< Segment >       _segments;       // 分段列表，队首为头分段
+    int                         _tail_fd;        // 尾分段文件描述符
+    int                         _head_fd;        // 头分段只读描述符，读取时按需打开
+    uint64_t                    _head_offset;    // 头分段中的读取偏移
+    uint64_t                    _front_size;     // front() 读到的批次大小（含记录头），0 表示未读取
+    uint64_t                    _bytes;          // 待读取的字节数
+    int                         _cursor_fd;      // 读取位置文件描述符
+    std::vector< struct iovec > _iov;            // push() 的 iovec 缓存
+};
+
+}  // namespace sinks
+}  // namespace jzlog
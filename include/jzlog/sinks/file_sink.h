@@ -6,12 +6,15 @@
 #include "jzlog/archive_manager/archive_manager.h"
 #include "jzlog/core/log_level.h"
 #include "jzlog/core/log_record.h"
-#include "jzlog/utils/fixed_buffer.h"
+#include "jzlog/core/pattern_formatter.h"
+#include "jzlog/sinks/uring_writer.h"
+#include "jzlog/utils/buffer_pool.h"
 #include "sink.h"
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
-#include <fstream>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -26,6 +29,110 @@ using namespace loglevel;
 
 constexpr int              DEFAULT_FILE_SIZE{ 100 * 1024 * 1024 };
 constexpr std::string_view DEFAULT_FILE_PATH{ "/home/carbon/workspace/logger/log" };
+constexpr size_t           DEFAULT_BUFFER_SIZE{ 4 * 1024 * 1024 };
+constexpr size_t           DEFAULT_POOL_SIZE{ 4 };  // 缓冲区池最多保留的空闲缓冲区数
+// 文件索引清单：每次分配新文件名时原子地写入日期与索引，构造时只读取清单并探测其后少量文件名即可
+// 确定下一个索引；清单缺失、损坏或落后过多时才遍历整个目录
+constexpr std::string_view MANIFEST_FILE_NAME{ ".jzlog_manifest" };
+
+/**
+ * @enum FileWriteBackend
+ * @brief 文件写入后端
+ */
+enum class FileWriteBackend : int
+{
+    WRITEV = 0,  // 后台线程以 writev 同步写入
+    IO_URING     // io_uring 异步写入，多个缓冲区同时在途；不可用时退回 WRITEV
+};
+
+constexpr uint32_t DEFAULT_SYNC_INTERVAL_MS{ 1000 };    // PERIODIC 策略的默认同步间隔（毫秒）
+constexpr uint32_t DEFAULT_COMMIT_WINDOW_US{ 200 };     // 默认持久化请求合并窗口（微秒）
+constexpr uint32_t DEFAULT_SYNC_TIMEOUT_MS{ 5000 };     // SYNC_ON_LEVEL 默认等待持久化上限（毫秒）
+constexpr uint32_t SYNC_RETRY_INTERVAL_MS{ 10 };        // fdatasync 失败后的初始重试间隔（毫秒）
+constexpr uint32_t SYNC_MAX_RETRY_INTERVAL_MS{ 1000 };  // fdatasync 重试间隔上限（毫秒）
+
+/**
+ * @enum DurabilityPolicy
+ * @brief 落盘持久化策略
+ */
+enum class DurabilityPolicy : int
+{
+    NONE = 0,      // 只写入页缓存，从不 fdatasync
+    PERIODIC,      // 每隔 sync_interval_ms 对有新数据的文件 fdatasync 一次
+    GROUP_COMMIT,  // 每条记录都请求持久化，合并窗口内的请求共用一次 fdatasync
+    SYNC_ON_LEVEL  // 不低于 sync_level 的记录请求持久化，并阻塞到持久化完成后才返回
+};
+
+/**
+ * @enum RotationPolicy
+ * @brief 日志文件滚动触发条件
+ */
+enum class RotationPolicy : int
+{
+    SIZE = 0,     // 当前文件达到 fileSize 时滚动
+    TIME,         // 到达 rotation_interval 的时间边界时滚动
+    SIZE_OR_TIME  // 两者任一满足时滚动
+};
+
+/**
+ * @enum RotationInterval
+ * @brief 按时间滚动的周期，边界取本地时间的整点或零点
+ */
+enum class RotationInterval : int
+{
+    DAILY = 0,  // 每天零点
+    HOURLY      // 每个整点
+};
+
+/**
+ * @brief 计算 now 之后的下一个滚动时间边界
+ * @param interval 滚动周期
+ * @param now 当前时间
+ * @return 下一个本地时间整点（HOURLY）或零点（DAILY）
+ */
+std::chrono::system_clock::time_point next_rotation_time(
+    RotationInterval interval, std::chrono::system_clock::time_point now ) noexcept;
+
+constexpr size_t   DEFAULT_MAX_QUEUED_BYTES{ 64 * 1024 * 1024 };  // 默认待写入积压上限（字节）
+constexpr uint32_t DEFAULT_BLOCK_TIMEOUT_MS{ 1000 };              // 默认积压满时的等待上限（毫秒）
+
+/**
+ * @enum BacklogPolicy
+ * @brief 待写入积压达到上限时的处理策略
+ */
+enum class BacklogPolicy : int
+{
+    BLOCK_TIMEOUT = 0,  // 等待积压回落，超过 block_timeout_ms 后丢弃当前记录
+    DROP_NEWEST,        // 直接丢弃当前记录
+    DROP_LOWEST_LEVEL   // 积压每增加 1/5 多丢弃一个最低级别，WARN 以下在 80% 时全部丢弃；
+                        // 积压满时 ERROR 及以上按 BLOCK_TIMEOUT 处理
+};
+
+/**
+ * @struct FileSinkConfig
+ * @brief 文件 Sink 的写入配置
+ */
+struct FileSinkConfig {
+    FileWriteBackend backend{ FileWriteBackend::WRITEV };             // 写入后端
+    unsigned         uring_depth{ DEFAULT_URING_DEPTH };              // io_uring 最多同时在途的写入数
+    DurabilityPolicy durability{ DurabilityPolicy::NONE };            // 持久化策略
+    uint32_t         sync_interval_ms{ DEFAULT_SYNC_INTERVAL_MS };    // PERIODIC 同步间隔（毫秒）
+    uint32_t         commit_window_us{ DEFAULT_COMMIT_WINDOW_US };    // 持久化请求合并窗口（微秒）
+    LogLevel         sync_level{ LogLevel::ERROR };                   // SYNC_ON_LEVEL 触发级别
+    uint32_t         sync_timeout_ms{ DEFAULT_SYNC_TIMEOUT_MS };      // SYNC_ON_LEVEL 等待上限（毫秒），0 不限
+    RotationPolicy   rotation{ RotationPolicy::SIZE_OR_TIME };        // 滚动触发条件
+    RotationInterval rotation_interval{ RotationInterval::DAILY };    // 按时间滚动的周期
+    // 已换出未写完的缓冲区数不超过 max_queued_bytes / bufSize（至少 1 个），超出时按 backlog_policy
+    // 处理。内存上限约为 ( max_queued_bytes / bufSize + 3 + uring_depth + DEFAULT_POOL_SIZE ) * bufSize
+    size_t           max_queued_bytes{ DEFAULT_MAX_QUEUED_BYTES };    // 待写入积压上限（字节）
+    BacklogPolicy    backlog_policy{ BacklogPolicy::BLOCK_TIMEOUT };  // 积压满时的处理策略
+    uint32_t         block_timeout_ms{ DEFAULT_BLOCK_TIMEOUT_MS };    // BLOCK_TIMEOUT 等待上限（毫秒）
+    // 每写满一个窗口用 sync_file_range 发起该窗口的异步写回，把脏页平摊成稳定的小批量写回
+    size_t           writeback_window{ 0 };                           // 异步写回窗口（字节），0 表示不启用
+    // 落后写回一个窗口以上的数据按窗口等待写回完成后以 posix_fadvise(DONTNEED) 移出页缓存，旧文件
+    // 关闭前整体移出；io_uring 下尚未完成的在途写入不受影响
+    size_t           drop_cache_window{ 0 };                          // 移出页缓存窗口（字节），0 表示不启用
+};
 
 /**
  * @class CFileSink
@@ -33,9 +140,9 @@ constexpr std::string_view DEFAULT_FILE_PATH{ "/home/carbon/workspace/logger/log
  */
 class CFileSink final : public ISink {
 public:
-    using Buffer    = utils::FixedBuffer< utils::kLargeBuffer >;  // 缓冲区类型
-    using BufferPtr = std::unique_ptr< Buffer >;                  // 缓冲区指针类型
-    using BufferVec = std::vector< BufferPtr >;                   // 缓冲区向量类型
+    using Buffer    = utils::CBuffer;                  // 缓冲区类型
+    using BufferPtr = utils::CBufferPool::BufferPtr;  // 缓冲区指针类型
+    using BufferVec = std::vector< BufferPtr >;       // 缓冲区向量类型
 
 public:
     /**
@@ -47,23 +154,26 @@ public:
      * @brief 构造函数（带目录路径）
      * @param level 日志级别
      * @param fileSize 单个日志文件最大大小
-     * @param bufSize 缓冲区大小
+     * @param bufSize 缓冲区大小，为 0 时使用 DEFAULT_BUFFER_SIZE
      * @param dir 日志文件存储目录
      * @param enable 是否启用
+     * @param config 写入配置
      */
     explicit CFileSink( LogLevel level, uint32_t fileSize, uint32_t bufSize, std::string dir,
-                        bool enable ) noexcept;
+                        bool enable, const FileSinkConfig& config = FileSinkConfig{} ) noexcept;
 
     /**
      * @brief 构造函数（带归档配置）
      * @param level 日志级别
      * @param fileSize 单个日志文件最大大小
-     * @param bufSize 缓冲区大小
+     * @param bufSize 缓冲区大小，为 0 时使用 DEFAULT_BUFFER_SIZE
      * @param enable 是否启用
      * @param archiveConfig 归档配置
+     * @param config 写入配置
      */
     explicit CFileSink( LogLevel level, uint32_t fileSize, uint32_t bufSize, bool enable,
-                        const ArchiveConfig& archiveConfig ) noexcept;
+                        const ArchiveConfig&  archiveConfig,
+                        const FileSinkConfig& config = FileSinkConfig{} ) noexcept;
 
     /**
      * @brief 拷贝构造函数（已删除）
@@ -92,6 +202,20 @@ public:
      */
     bool write( const LogRecord& r ) noexcept override;
 
+    /**
+     * @brief 获取日志行格式化器
+     * @return 格式化器
+     */
+    const CPatternFormatter* formatter() const noexcept override;
+
+    /**
+     * @brief 写入已渲染好的日志行
+     * @param r 日志记录
+     * @param line 渲染结果
+     * @return 成功返回 true，失败返回 false
+     */
+    bool write_formatted( const LogRecord& r, std::string_view line ) noexcept override;
+
     /**
      * @brief 刷新缓冲区
      * @return 成功返回 true，失败返回 false
@@ -117,7 +241,66 @@ public:
      */
     bool should_log( LogLevel lvl ) const noexcept override;
 
+    /**
+     * @brief 设置日志行格式模式串，应在开始记录日志前调用
+     * @param pattern 模式串，占位符见 CPatternFormatter
+     */
+    void set_pattern( std::string_view pattern );
+
+    /**
+     * @brief 获取实际使用的写入后端
+     * @return 请求 IO_URING 但环建立失败时返回 WRITEV
+     */
+    FileWriteBackend backend() const noexcept;
+
+    /**
+     * @brief 获取写入序号
+     * @return 写入序号（缓冲区代数 << 32 | 代内偏移），单调递增；写入之后读取的序号覆盖
+     *         本线程已写入的记录
+     */
+    uint64_t sequence() const noexcept;
+
+    /**
+     * @brief 获取已持久化的写入序号
+     * @return 已 fdatasync 的写入序号；写入失败后不再推进
+     */
+    uint64_t durable_sequence() const noexcept;
+
+    /**
+     * @brief 请求持久化并等待 seq 之前的数据落盘
+     * @param seq 写入序号
+     * @return 已持久化返回 true；策略为 NONE、sink 已停止、写入失败或等待期间 fdatasync 失败时
+     *         返回 false
+     */
+    bool wait_durable( uint64_t seq ) noexcept;
 
+    /**
+     * @brief 请求持久化并在超时前等待 seq 之前的数据落盘
+     * @param seq 写入序号
+     * @param timeout 超时时间
+     * @return 已持久化返回 true；超时、策略为 NONE、sink 已停止、写入失败或等待期间 fdatasync
+     *         失败时返回 false
+     */
+    bool wait_durable_for( uint64_t seq, std::chrono::milliseconds timeout ) noexcept;
+
+    /**
+     * @brief 获取已执行的 fdatasync 次数
+     * @return fdatasync 次数
+     */
+    uint64_t sync_count() const noexcept;
+
+    /**
+     * @brief 获取因积压满被丢弃的记录总数
+     * @return 丢弃的记录数
+     */
+    uint64_t dropped() const noexcept;
+
+    /**
+     * @brief 获取某一级别因积压满被丢弃的记录数
+     * @param level 日志级别（TRACE ~ FATAL）
+     * @return 丢弃的记录数
+     */
+    uint64_t dropped( LogLevel level ) const noexcept;
 
     /**
      * @brief 析构函数
@@ -143,24 +326,263 @@ public:
     bool enabled() const noexcept override;
 
 private:
+    static constexpr size_t kLevelCount = static_cast< size_t >( LogLevel::FATAL ) + 1;  // 级别数
+
+    using DropCounters = std::array< std::atomic< uint64_t >, kLevelCount >;  // 各级别丢弃计数
+
     /**
-     * @brief 创建新的日志文件
+     * @struct Slot
+     * @brief 当前缓冲区槽位
+     * @details 代数 g 使用槽位 g & 1。生产者经 utils::reserve_copy 在锁外拷贝并递增提交数，只有
+     *          预留越过末尾的线程才加锁换出缓冲区；后台线程写入前等待上一代的提交数追上换出时的
+     *          预留数，更早的代在其槽位被复用前已全部结束拷贝
+     */
+    struct Slot {
+        BufferPtr               _buffer;           // 当前缓冲区，换出后移入 _buffers
+        Buffer*                 _raw{ nullptr };   // 缓冲区，换出后仍供在途拷贝使用
+        uint64_t                _capacity{ 0 };    // 容量，无缓冲区时为 0
+        uint64_t                _generation{ 0 };  // 代数
+        std::atomic< uint32_t > _committed{ 0 };   // 已结束的预留数（模 2^20）
+        std::atomic< uint32_t > _expected{ 0 };    // 换出时的预留数
+    };
+
+    /**
+     * @struct LogFile
+     * @brief 已打开的日志文件
+     */
+    struct LogFile {
+        int         _fd{ -1 };   // 文件描述符，打开失败时为 -1
+        std::string _name;       // 文件名（YYYYMMDD_NNN）
+        std::string _date;       // 文件名中的日期
+        uint64_t    _size{ 0 };  // 打开时的文件大小
+    };
+
+    /**
+     * @brief 同步创建新的日志文件并设为当前文件
+     * @note 只在构造时调用，之后的滚动由 rotate_file_() 完成
      */
     void create_new_file() noexcept;
 
     /**
-     * @brief 格式化日志记录
-     * @param r 日志记录
-     * @return 格式化后的字符串
+     * @brief 分配下一个文件名并打开日志文件
+     * @return 打开的文件，失败时 _fd 为 -1
      */
-    std::string format_log_record( const LogRecord& r );
+    LogFile open_log_file() noexcept;
 
     /**
-     * @brief 将缓冲区内容刷新到文件
-     * @param buffer 缓冲区指针
-     * @return 成功返回 true，失败返回 false
+     * @brief 等待正在打开的备用文件，取出与当前日期一致的备用文件并唤醒准备线程补充
+     * @param file 返回备用文件
+     * @return 备用文件可用返回 true，否则返回 false
+     */
+    bool take_standby( LogFile& file ) noexcept;
+
+    /**
+     * @brief 替换过期的备用文件并在缺少时打开新的备用文件
+     * @return 备用文件可用返回 true，打开失败返回 false
+     * @note 只在准备线程中调用
+     */
+    bool refill_standby() noexcept;
+
+    /**
+     * @brief 将旧文件描述符交给准备线程关闭
+     * @param fd 文件描述符
+     */
+    void retire_fd( int fd ) noexcept;
+
+    /**
+     * @brief 关闭备用文件，文件为空时一并删除
+     * @param file 备用文件
      */
-    bool flush_buffer_to_file( BufferPtr buffer ) noexcept;
+    void discard_file( LogFile& file ) noexcept;
+
+    /**
+     * @brief 到达时间边界时滚动：先补充备用文件并写出缓冲区，再换入备用文件
+     */
+    void rotate_on_time() noexcept;
+
+    /**
+     * @brief 准备线程主函数：补充备用文件、关闭旧文件、按时间边界滚动
+     * @details 滚动所需的下一个日志文件由本线程提前打开，写入线程滚动时只需换入备用文件的描述符
+     */
+    void prepare_thread() noexcept;
+
+    /**
+     * @brief 是否按文件大小滚动
+     * @return 策略为 SIZE 或 SIZE_OR_TIME 时返回 true
+     */
+    bool size_rotation() const noexcept;
+
+    /**
+     * @brief 按窗口发起当前文件的异步写回，并把已写回的窗口移出页缓存
+     * @note 调用方需持有 _file_mutex
+     */
+    void manage_page_cache() noexcept;
+
+    /**
+     * @brief 关闭日志文件，启用 drop_cache_window 时先等待写回并把整个文件移出页缓存
+     * @param fd 文件描述符
+     */
+    void close_log_fd( int fd ) noexcept;
+
+    /**
+     * @brief 将一批缓冲区写入文件，写完后归还缓冲区池
+     * @details 只获取一次 _file_mutex，相邻缓冲区合并为一次 writev 提交；
+     *          需要滚动文件时先提交已合并的部分再滚动。
+     * @param buffers 待写入的缓冲区，返回时被清空
+     * @return 全部写入成功返回 true，否则返回 false
+     */
+    bool flush_buffers_to_file( BufferVec& buffers ) noexcept;
+
+    /**
+     * @brief 将一批缓冲区按文件偏移提交给 io_uring，完成后归还缓冲区池
+     * @param buffers 待写入的缓冲区，返回时被清空
+     * @note 调用方需持有 _file_mutex
+     */
+    void submit_buffers_to_uring( BufferVec& buffers ) noexcept;
+
+    /**
+     * @brief 等待所有 io_uring 在途写入完成
+     * @return 写入全部成功返回 true，否则返回 false
+     */
+    bool drain_uring() noexcept;
+
+    /**
+     * @brief 换出当前缓冲区，等待拷贝结束后把所有待写入缓冲区写入文件
+     * @param write_buffers 复用的缓冲区向量
+     * @param seq 返回换出时的写入序号，此前的数据均已提交写入
+     * @return 写入全部成功返回 true，否则返回 false
+     * @note 调用方需持有 _drain_mutex
+     */
+    bool write_pending( BufferVec& write_buffers, uint64_t& seq ) noexcept;
+
+    /**
+     * @brief 登记持久化请求并唤醒后台线程
+     * @param seq 写入序号
+     * @return 策略为 NONE 或已发生写入失败时返回 false
+     */
+    bool request_sync( uint64_t seq ) noexcept;
+
+    /**
+     * @brief 把请求持久化的最大序号提高到 seq，后台线程可能在等待时加锁唤醒
+     * @param seq 写入序号
+     */
+    void raise_sync_request( uint64_t seq ) noexcept;
+
+    /**
+     * @brief 等待持久化的条件是否已有结果
+     * @param seq 写入序号
+     * @param failures 开始等待时的 fdatasync 失败次数
+     * @note 调用方需持有 _durable_mutex
+     */
+    bool durable_settled( uint64_t seq, uint64_t failures ) const noexcept;
+
+    /**
+     * @brief 是否有需要 fdatasync 的持久化请求；写入失败后已持久化序号不再推进，请求随之作废
+     */
+    bool sync_pending() const noexcept;
+
+    /**
+     * @brief 记录写入失败：已持久化序号不再推进，唤醒所有等待者
+     */
+    void fail_writes() noexcept;
+
+    /**
+     * @brief fdatasync 当前文件，seq 之前的写入全部成功时把已持久化序号推进到 seq
+     * @param seq 已提交写入的序号
+     * @param written seq 之前的写入是否全部成功
+     * @return fdatasync 成功返回 true；失败时唤醒等待者并返回 false
+     */
+    bool sync_to( uint64_t seq, bool written ) noexcept;
+
+    /**
+     * @brief 预留空间并在锁外拷贝一行日志，缓冲区写满时换出
+     * @param line 日志行
+     * @param level 日志级别，积压满时用于丢弃计数
+     * @param seq 返回该行的写入序号
+     * @return 成功返回 true，记录被丢弃或缓冲区不可用时返回 false
+     * @note 超过缓冲区大小的行交给 append_large()
+     */
+    bool append( std::string_view line, LogLevel level, uint64_t& seq ) noexcept;
+
+    /**
+     * @brief 把超过缓冲区大小的行放入按实际长度分配的独立缓冲区，排在此前所有记录之后
+     * @details 先换出当前缓冲区（即使为空）开启新的一代，再把独立缓冲区追加到待写入队列，
+     *          写入时与相邻缓冲区合并在同一次 writev（或按偏移提交给 io_uring），不占用池中的
+     *          缓冲区；积压按其覆盖的缓冲区个数计入。
+     * @param line 日志行
+     * @param level 日志级别
+     * @param seq 返回该行的写入序号
+     * @return 成功返回 true，记录被丢弃或内存不足时返回 false
+     */
+    bool append_large( std::string_view line, LogLevel level, uint64_t& seq ) noexcept;
+
+    /**
+     * @brief 换出当前缓冲区后把一个独立缓冲区追加到待写入队列，不检查积压上限
+     * @param buffer 缓冲区
+     * @param weight 计入积压的缓冲区个数
+     * @param seq 返回该缓冲区的写入序号
+     * @return 成功返回 true，缓冲区不可用或内存不足时返回 false
+     * @note 调用方需持有 _buffer_mutex
+     */
+    bool enqueue_buffer( BufferPtr buffer, size_t weight, uint64_t& seq ) noexcept;
+
+    /**
+     * @brief 积压加上 weight 个缓冲区后是否超过上限
+     * @param weight 新增的缓冲区数
+     * @return 超过上限且积压非空返回 true
+     * @note 调用方需持有 _buffer_mutex
+     */
+    bool backlog_full( size_t weight ) const noexcept;
+
+    /**
+     * @brief 缓冲区在积压中所占的个数，独立缓冲区按覆盖的池缓冲区个数计
+     * @param buffer 缓冲区
+     * @return 缓冲区个数
+     */
+    size_t backlog_weight( const Buffer& buffer ) const noexcept;
+
+    /**
+     * @brief 预留越过末尾的线程换出代数为 generation 的缓冲区，已被其他线程换出时直接返回
+     * @details 积压达到上限时按 backlog_policy 等待或丢弃当前记录
+     * @param generation 放不下时预留字中的代数（模 256）
+     * @param level 当前记录的级别
+     * @return 新的当前缓冲区可用返回 true；记录被丢弃或缓冲区不可用时返回 false
+     */
+    bool swap_full_buffer( uint32_t generation, LogLevel level ) noexcept;
+
+    /**
+     * @brief DROP_LOWEST_LEVEL 策略下按积压比例判断是否丢弃该级别
+     * @param level 日志级别
+     * @return 应丢弃返回 true
+     */
+    bool shed_level( LogLevel level ) const noexcept;
+
+    /**
+     * @brief 记录一次丢弃
+     * @param level 被丢弃记录的级别
+     */
+    void count_drop( LogLevel level ) noexcept;
+
+    /**
+     * @brief 把上次报告以来的丢弃计数作为一条 WARN 记录写入日志
+     * @note 只在后台线程中调用；报告越过积压上限直接入队，不会等待积压下降
+     */
+    void report_dropped() noexcept;
+
+    /**
+     * @brief 将当前缓冲区移入待写入队列，并从备用缓冲区或缓冲区池补充
+     * @return 新的当前缓冲区可用返回 true，否则返回 false
+     * @note 调用方需持有 _buffer_mutex
+     */
+    bool swap_current_buffer() noexcept;
+
+    /**
+     * @brief 把缓冲区装入槽位作为代数为 generation 的当前缓冲区
+     * @param slot 槽位，上一次使用时的拷贝须已全部结束
+     * @param generation 代数
+     * @param buffer 缓冲区，可为空
+     */
+    void install_buffer( Slot& slot, uint64_t generation, BufferPtr buffer ) noexcept;
 
     /**
      * @brief 滚动日志文件
@@ -168,7 +590,8 @@ private:
     void rotate_file();
 
     /**
-     * @brief 滚动日志文件（内部实现）
+     * @brief 滚动日志文件（内部实现），优先换入备用文件
+     * @note 调用方需持有 _file_mutex
      */
     void rotate_file_();
 
@@ -188,10 +611,23 @@ private:
     void work_thread() noexcept;
 
     /**
-     * @brief 初始化文件索引
+     * @brief 初始化文件索引，优先读取清单，不可用时遍历目录
      */
     void init_file_idx() noexcept;
 
+    /**
+     * @brief 从清单恢复今天的最大文件索引
+     * @param today 今天的日期字符串
+     * @return 清单可用返回 true，缺失、损坏或落后过多返回 false
+     */
+    bool load_manifest( const std::string& today ) noexcept;
+
+    /**
+     * @brief 以临时文件加 rename 原子地更新清单
+     * @note 调用方需持有 _standby_mutex
+     */
+    void save_manifest() noexcept;
+
     /**
      * @brief 获取当前日期字符串
      * @return 日期字符串（格式：YYYYMMDD）
@@ -203,19 +639,46 @@ private:
     uint32_t                                      _file_size;        // 单个日志文件最大大小
     std::string                                   _file_path;        // 日志文件存储目录路径
     std::string                                   _cur_file_name;    // 当前日志文件文件名
-    uint32_t                                      _cur_file_size;    // 当前日志文件已写入大小
-    BufferPtr                                     _current_buffer;   // 当前写入缓冲区
+    uint64_t                                      _cur_file_size;    // 当前日志文件已写入大小
+    uint64_t                                      _writeback_off;    // 尚未发起写回的起始偏移（_file_mutex）
+    uint64_t                                      _dropped_off;      // 尚未移出页缓存的起始偏移（_file_mutex）
+    utils::CBufferPool                            _buffer_pool;      // 缓冲区池
+    std::unique_ptr< CUringWriter >               _uring;            // io_uring 写入器，未启用时为空
+    std::array< Slot, 2 >                         _slots;            // 当前缓冲区槽位
+    std::atomic< uint64_t >                       _reserve;          // 预留字
+    uint64_t                                      _generation;       // 当前代数（_buffer_mutex）
     BufferPtr                                     _next_buffer;      // 备用缓冲区
     BufferVec                                     _buffers;          // 待写入的缓冲区队列
-    std::mutex                                    _buffer_mutex;     // 缓冲区互斥锁
+    mutable std::mutex                            _buffer_mutex;     // 缓冲区互斥锁
     std::condition_variable                       _cond;             // 条件变量，用于工作线程
-    std::ofstream                                 _file_stream;      // 文件输出流
-    int                                           _cur_idx;          // 当前文件索引
-    std::string                                   _cur_date_str;     // 当前日期字符串
+    int                                           _fd;               // 日志文件描述符
+    int                                           _cur_idx;          // 最近分配的文件索引（_standby_mutex）
+    std::string                                   _cur_date_str;     // 最近分配的文件日期（_standby_mutex）
     std::thread                                   _thread;           // 后台工作线程
     std::atomic< bool >                           _running;          // 线程运行标志
     std::mutex                                    _file_mutex;       // 文件操作互斥锁
     std::unique_ptr< CArchiveManager >            _archive_manager;  // 归档管理器
+    CPatternFormatter                             _formatter;        // 日志行格式化器
+    FileSinkConfig                                _config;           // 写入配置
+    std::mutex                                    _drain_mutex;      // 串行化换出与写入文件
+    std::atomic< uint64_t >                       _sync_request;     // 请求持久化的最大序号
+    std::atomic< uint64_t >                       _durable_seq;      // 已持久化序号
+    std::atomic< uint64_t >                       _sync_count;       // fdatasync 次数
+    std::atomic< bool >                           _write_failed;     // 曾有写入失败，已持久化序号不再推进
+    uint64_t                                      _sync_failures;    // 同步失败次数（_durable_mutex）
+    std::mutex                                    _durable_mutex;    // 持久化通知互斥锁
+    std::condition_variable                       _durable_cond;     // 持久化通知条件变量
+    LogFile                                       _standby;          // 备用文件（_standby_mutex）
+    bool                                          _standby_opening;  // 准备线程正在打开备用文件（_standby_mutex）
+    std::vector< int >                            _retired_fds;      // 待关闭的旧文件（_standby_mutex）
+    std::mutex                                    _standby_mutex;    // 备用文件互斥锁
+    std::condition_variable                       _standby_cond;     // 准备线程条件变量
+    std::thread                                   _prepare_thread;   // 备用文件准备线程
+    size_t                                        _max_queued;       // 积压上限（缓冲区数）
+    std::atomic< size_t >                         _queued;           // 已换出尚未写完的缓冲区数
+    std::condition_variable                       _space_cond;       // 积压回落通知（_buffer_mutex）
+    DropCounters                                  _dropped;          // 各级别丢弃数，积压清空后写成一条 WARN 记录
+    std::array< uint64_t, kLevelCount >           _reported;         // 已报告的丢弃数（后台线程）
 };
 }  // namespace sinks
 }  // namespace jzlog
@@ -0,0 +1,94 @@
+/**
+ * @file frame_receiver.h
+ * @brief 分帧协议（net_frame.h）的参考接收端
+ *
+ * 逐帧读取：校验帧头与载荷 CRC-32C，按帧头中的编码解压，按 (session, seq) 丢弃重连后重发的帧，
+ * 新帧交给回调后回复累计确认。去重状态跨连接保留。
+ */
+#pragma once
+
+#include "jzlog/sinks/net_frame.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+/**
+ * @enum ReceiveResult
+ * @brief 一个连接结束的原因
+ */
+enum class ReceiveResult : int {
+    CLOSED,       // 对端关闭连接
+    BAD_HEADER,   // 帧头无效
+    BAD_CRC,      // 载荷校验失败
+    BAD_PAYLOAD,  // 载荷解压失败
+    CUT,          // 按 cut_after() 收下一帧后不确认即断开
+    ACK_FAILED,   // 确认发送失败
+};
+
+/**
+ * @class CFrameReceiver
+ * @brief 分帧协议接收端
+ * @note 非线程安全，同一时刻只服务一个连接
+ */
+class CFrameReceiver {
+public:
+    using Handler = std::function< void( const FrameHeader&, const std::string& ) >;
+
+public:
+    /**
+     * @brief 构造函数
+     * @param handler 每个新帧（不含重发的重复帧）解压后的日志行回调
+     */
+    explicit CFrameReceiver( Handler handler );
+
+    /**
+     * @brief 第 frames 帧（跨连接计数）收下后不确认，直接结束该连接，只生效一次
+     * @param frames 帧数，0 表示不断开
+     * @note 用于模拟确认丢失
+     */
+    void cut_after( size_t frames ) noexcept;
+
+    /**
+     * @brief 服务一个连接直到其结束，不关闭 fd
+     * @param fd 已连接的 socket
+     * @return 连接结束的原因
+     * @note 回调抛出的异常原样传出
+     */
+    ReceiveResult serve( int fd );
+
+    /**
+     * @brief 获取交给回调的新帧数
+     */
+    uint64_t frames() const noexcept;
+
+    /**
+     * @brief 获取丢弃的重复帧数
+     */
+    uint64_t duplicates() const noexcept;
+
+    /**
+     * @brief 获取收到的压缩帧数（含重复帧）
+     */
+    uint64_t compressed() const noexcept;
+
+private:
+    Handler                        _handler;          // 新帧回调
+    std::map< uint64_t, uint64_t > _last_seq;         // 每个会话已收到的最大帧序号
+    size_t                         _cut_after{ 0 };   // 收下第几帧后断开，0 表示不断开
+    size_t                         _received{ 0 };    // 已收下的帧数（含重复帧）
+    uint64_t                       _frames{ 0 };      // 新帧数
+    uint64_t                       _duplicates{ 0 };  // 重复帧数
+    uint64_t                       _compressed{ 0 };  // 压缩帧数（含重复帧）
+    std::string                    _payload;          // 载荷缓冲区
+    std::string                    _raw;              // 解压缓冲区
+};
+
+}  // namespace sinks
+}  // namespace jzlog
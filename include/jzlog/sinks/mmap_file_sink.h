@@ -0,0 +1,225 @@
+/**
+ * @file mmap_file_sink.h
+ * @brief 内存映射文件日志 Sink 实现类
+ *
+ * 每个日志分段在创建时用 fallocate 预分配到滚动大小并以 MAP_SHARED 映射。生产者线程对一个
+ * 64 位预留字做一次 fetch_add 取得写入位置，随后直接 memcpy 到映射区，写入路径上没有锁、
+ * 没有系统调用，也没有后台线程。数据写入映射即进入页缓存，进程崩溃后已写入的记录仍保留在文件中
+ * （此时文件尾部是预分配的零字节）；正常滚动或析构时文件截断为实际长度。
+ *
+ * 预留字布局见 utils/reserve_word.h。分段存放在两个槽位中，代数 g 使用槽位 g & 1。越过分段
+ * 末尾的生产者负责滚动：把预留字换成下一代的初值后，等待旧分段的提交数追上旧预留字中的预留数，
+ * 再截断并解除映射。
+ *
+ * 分段创建或预分配失败（如磁盘已满）时记录被丢弃并计入 dropped()，按 MMAP_RETRY_INTERVAL_MS
+ * 起指数退避，退避期内写入直接丢弃，不再预留空间或重复创建文件。
+ */
+#pragma once
+
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/core/pattern_formatter.h"
+#include "jzlog/sinks/sink.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+constexpr uint32_t MMAP_RETRY_INTERVAL_MS{ 100 };       // 分段创建失败后的初始重试间隔（毫秒）
+constexpr uint32_t MMAP_MAX_RETRY_INTERVAL_MS{ 5000 };  // 分段创建重试间隔上限（毫秒）
+
+/**
+ * @class CMmapFileSink
+ * @brief 内存映射文件日志 Sink 实现类，生产者无锁写入预分配的日志分段
+ */
+class CMmapFileSink final : public ISink {
+public:
+    /**
+     * @brief 构造函数
+     * @param level 日志级别
+     * @param fileSize 单个日志分段大小（预分配并映射的字节数）
+     * @param dir 日志文件存储目录
+     */
+    explicit CMmapFileSink( LogLevel level, uint32_t fileSize, std::string dir ) noexcept;
+
+    /**
+     * @brief 拷贝构造函数（已删除）
+     */
+    CMmapFileSink( const CMmapFileSink& ) = delete;
+
+    /**
+     * @brief 拷贝赋值运算符（已删除）
+     */
+    CMmapFileSink& operator=( const CMmapFileSink& ) = delete;
+
+    /**
+     * @brief 移动构造函数（已删除）
+     */
+    CMmapFileSink( CMmapFileSink&& ) = delete;
+
+    /**
+     * @brief 移动赋值运算符（已删除）
+     */
+    CMmapFileSink& operator=( CMmapFileSink&& ) = delete;
+
+    /**
+     * @brief 析构函数，截断当前分段到实际长度
+     * @note 析构时不能再有线程写入
+     */
+    ~CMmapFileSink();
+
+    /**
+     * @brief 写入日志记录
+     * @param r 日志记录
+     * @return 成功返回 true，失败返回 false
+     */
+    bool write( const LogRecord& r ) noexcept override;
+
+    /**
+     * @brief 获取日志行格式化器
+     * @return 格式化器
+     */
+    const CPatternFormatter* formatter() const noexcept override;
+
+    /**
+     * @brief 写入已渲染好的日志行
+     * @param r 日志记录
+     * @param line 渲染结果
+     * @return 成功返回 true，分段创建失败或单行超过分段大小时返回 false
+     */
+    bool write_formatted( const LogRecord& r, std::string_view line ) noexcept override;
+
+    /**
+     * @brief 刷新缓冲区
+     * @return 总是返回 true
+     * @note 写入映射区的数据已在页缓存中，无需刷新
+     */
+    bool flush() noexcept override;
+
+    /**
+     * @brief 获取丢弃的记录数
+     * @return 分段创建失败或处于重试退避期而丢弃的记录总数
+     */
+    uint64_t dropped() const noexcept;
+
+    /**
+     * @brief 设置日志级别
+     * @param lvl 日志级别
+     */
+    void set_level( LogLevel lvl ) noexcept override;
+
+    /**
+     * @brief 获取日志级别
+     * @return 当前日志级别
+     */
+    LogLevel level() const noexcept override;
+
+    /**
+     * @brief 判断是否应该记录该级别的日志
+     * @param lvl 日志级别
+     * @return 应该记录返回 true，否则返回 false
+     */
+    bool should_log( LogLevel lvl ) const noexcept override;
+
+    /**
+     * @brief 设置日志行格式模式串，应在开始记录日志前调用
+     * @param pattern 模式串，占位符见 CPatternFormatter
+     */
+    void set_pattern( std::string_view pattern );
+
+    /**
+     * @brief 设置是否启用
+     * @param enabled 启用状态
+     */
+    void set_enabled( bool enabled ) noexcept override;
+
+    /**
+     * @brief 获取启用状态
+     * @return 启用返回 true，否则返回 false
+     */
+    bool enabled() const noexcept override;
+
+private:
+    /**
+     * @struct Segment
+     * @brief 一个已映射的日志分段
+     */
+    struct Segment {
+        int                     _fd{ -1 };            // 文件描述符
+        char*                   _base{ nullptr };     // 映射起始地址
+        uint64_t                _capacity{ 0 };       // 映射大小
+        std::atomic< uint32_t > _committed{ 0 };      // 已结束的预留数（模 2^20）
+        std::atomic< uint64_t > _used{ UINT64_MAX };  // 越过末尾的预留起点，即有效长度
+    };
+
+    /**
+     * @brief 预留空间并拷贝数据，必要时滚动分段
+     * @param data 数据指针
+     * @param len 数据长度
+     * @return 成功返回 true，失败返回 false
+     */
+    bool append( const char* data, size_t len ) noexcept;
+
+    /**
+     * @brief 把代数 gen 的分段滚动到下一代，已被其他线程滚动时直接返回
+     * @param gen 越过末尾时观察到的代数
+     * @return 新分段可用返回 true，否则返回 false
+     */
+    bool rotate( uint32_t gen ) noexcept;
+
+    /**
+     * @brief 创建、预分配并映射新的分段文件
+     * @param seg 目标槽位
+     * @return 成功返回 true，失败返回 false
+     */
+    bool open_segment( Segment& seg ) noexcept;
+
+    /**
+     * @brief 分段创建失败后按指数退避安排下一次重试
+     * @note 调用方需持有 _rotate_mutex（构造函数除外）
+     */
+    void schedule_retry() noexcept;
+
+    /**
+     * @brief 解除映射并把分段文件截断到有效长度
+     * @param seg 分段
+     * @param reserved 预留字中的已预留字节数
+     */
+    void close_segment( Segment& seg, uint64_t reserved ) noexcept;
+
+    /**
+     * @brief 生成下一个分段文件名（YYYYMMDD_NNN）
+     * @return 文件名
+     */
+    std::string next_file_name() noexcept;
+
+    /**
+     * @brief 初始化文件索引，接续目录中当天已有的最大编号
+     */
+    void init_file_idx() noexcept;
+
+private:
+    LogLevel                 _level;          // 日志过滤级别
+    uint32_t                 _file_size;      // 单个日志分段大小
+    std::string              _file_path;      // 日志文件存储目录路径
+    std::string              _cur_date_str;   // 当前日期字符串
+    int                      _cur_idx;        // 当前文件索引
+    std::atomic< uint64_t >  _reserve;        // 预留字
+    std::array< Segment, 2 > _segments;       // 分段槽位
+    std::mutex               _rotate_mutex;   // 滚动互斥锁
+    uint32_t                 _retry_backoff;  // 重试退避倍数（_rotate_mutex）
+    std::atomic< int64_t >   _retry_at;       // 重试时刻（steady_clock 纳秒），0 表示未失败
+    std::atomic< uint64_t >  _dropped;        // 丢弃的记录数
+    CPatternFormatter        _formatter;      // 日志行格式化器
+};
+
+}  // namespace sinks
+}  // namespace jzlog
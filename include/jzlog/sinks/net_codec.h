@@ -0,0 +1,117 @@
+/**
+ * @file net_codec.h
+ * @brief 网络帧载荷的压缩与解压
+ *
+ * FrameCodec::LZ 为内置的 LZ77 字节流编码（与 LZ4 块格式相同的序列布局）：每个序列由 1 字节 token
+ * （高 4 位字面量长度、低 4 位匹配长度减 4，取 15 时后接若干 255 累加的扩展字节）、字面量、
+ * 2 字节小端匹配偏移组成，最后一个序列只有字面量。匹配以 4 字节哈希查找，偏移不超过 65535，
+ * level 1/2/3 对应 12/14/16 位哈希表、每桶 1/2/4 个候选位置，越大压缩率越高、越慢。
+ *
+ * FrameCodec::ZSTD 在构建时找到 libzstd（定义 JZLOG_HAVE_ZSTD）才可用，level 即 zstd 压缩级别。
+ */
+#pragma once
+
+#include "jzlog/sinks/net_frame.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+/**
+ * @brief 判断编码在当前构建中是否可用
+ * @param codec 编码
+ * @return 可用返回 true
+ */
+bool codec_available( FrameCodec codec ) noexcept;
+
+/**
+ * @brief 解压帧载荷
+ * @param codec 帧头中的编码
+ * @param src 载荷
+ * @param len 载荷字节数
+ * @param dst 输出缓冲区，至少 raw_len 字节
+ * @param raw_len 帧头中的解码后字节数
+ * @return 解出恰好 raw_len 字节返回 true，数据损坏或编码不可用返回 false
+ */
+bool decompress_payload( FrameCodec codec, const char* src, size_t len, char* dst,
+                         size_t raw_len ) noexcept;
+
+/**
+ * @class CFrameCompressor
+ * @brief 帧载荷压缩器，持有哈希表或 zstd 上下文供重复使用
+ * @note 非线程安全
+ */
+class CFrameCompressor {
+public:
+    /**
+     * @brief 构造函数
+     * @param codec 编码，不可用时 valid() 返回 false
+     * @param level 压缩级别
+     */
+    explicit CFrameCompressor( FrameCodec codec, int level ) noexcept;
+
+    /**
+     * @brief 拷贝构造函数（已删除）
+     */
+    CFrameCompressor( const CFrameCompressor& ) = delete;
+
+    /**
+     * @brief 拷贝赋值运算符（已删除）
+     */
+    CFrameCompressor& operator=( const CFrameCompressor& ) = delete;
+
+    /**
+     * @brief 析构函数，释放 zstd 上下文
+     */
+    ~CFrameCompressor();
+
+    /**
+     * @brief 判断压缩器是否可用
+     * @return 编码可用且初始化成功返回 true
+     */
+    bool valid() const noexcept;
+
+    /**
+     * @brief 获取编码
+     * @return 编码
+     */
+    FrameCodec codec() const noexcept { return _codec; }
+
+    /**
+     * @brief 获取压缩 len 字节所需的最大输出字节数
+     * @param len 输入字节数
+     * @return 输出缓冲区大小上限
+     */
+    size_t bound( size_t len ) const noexcept;
+
+    /**
+     * @brief 压缩一段连续数据
+     * @param src 输入
+     * @param len 输入字节数
+     * @param dst 输出缓冲区
+     * @param cap 输出缓冲区大小，不小于 bound( len ) 时保证成功
+     * @return 压缩后的字节数，输出空间不足或出错返回 0
+     */
+    size_t compress( const char* src, size_t len, char* dst, size_t cap ) noexcept;
+
+private:
+    /**
+     * @brief 以内置 LZ 编码压缩
+     */
+    size_t compress_lz( const uint8_t* src, size_t len, uint8_t* dst, size_t cap ) noexcept;
+
+private:
+    FrameCodec              _codec;      // 编码
+    int                     _level;      // 压缩级别
+    unsigned                _hash_bits;  // LZ 哈希表位数
+    unsigned                _ways;       // LZ 每个哈希桶保存的候选位置数
+    std::vector< uint32_t > _table;      // LZ 哈希表：哈希值到输入偏移
+    void*                   _zstd_ctx;   // zstd 压缩上下文
+};
+
+}  // namespace sinks
+}  // namespace jzlog
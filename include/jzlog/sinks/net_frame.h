@@ -0,0 +1,96 @@
+/**
+ * @file net_frame.h
+ * @brief 网络 Sink 的分帧协议
+ *
+ * 发送方把每个批次编码为一帧：FRAME_HEADER_SIZE 字节的帧头后接载荷。帧头各字段均为网络字节序：
+ *
+ *     偏移  长度  字段
+ *     0     4     magic       FRAME_MAGIC
+ *     4     1     version     FRAME_VERSION
+ *     5     1     codec       载荷编码（FrameCodec）
+ *     6     2     flags       保留，写 0
+ *     8     4     length      载荷字节数
+ *     12    4     raw_length  解码后的载荷字节数，未编码时等于 length
+ *     16    4     records     批次中的记录数
+ *     20    4     crc         载荷的 CRC-32C
+ *     24    8     session     发送方会话标识，每个 sink 实例随机生成
+ *     32    8     seq         帧序号，同一会话内从 1 开始连续递增
+ *
+ * 接收方每收到一个完整且校验通过的帧回复 ACK_SIZE 字节的累计确认（magic ACK_MAGIC、4 字节保留、
+ * 8 字节 seq），表示该会话中序号不大于 seq 的帧都已收到。重连后发送方从最早的未确认帧开始重发，
+ * 接收方按 (session, seq) 丢弃已收过的帧后照常确认。
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+constexpr uint32_t FRAME_MAGIC{ 0x4a5a4e46 };             // "JZNF"
+constexpr uint32_t ACK_MAGIC{ 0x4a5a414b };               // "JZAK"
+constexpr uint8_t  FRAME_VERSION{ 1 };                    // 协议版本
+constexpr size_t   FRAME_HEADER_SIZE{ 40 };               // 帧头字节数
+constexpr size_t   ACK_SIZE{ 16 };                        // 确认字节数
+constexpr size_t   MAX_FRAME_LENGTH{ 64 * 1024 * 1024 };  // 接收方接受的最大载荷及解码后字节数
+
+/**
+ * @enum FrameCodec
+ * @brief 帧载荷编码
+ */
+enum class FrameCodec : uint8_t {
+    NONE = 0,  // 未编码的日志行
+    LZ   = 1,  // 内置 LZ 编码，见 net_codec.h
+    ZSTD = 2,  // zstd 帧，构建时找到 libzstd 才可用
+};
+
+/**
+ * @struct FrameHeader
+ * @brief 解码后的帧头
+ */
+struct FrameHeader {
+    FrameCodec codec{ FrameCodec::NONE };  // 载荷编码
+    uint32_t   length{ 0 };                // 载荷字节数
+    uint32_t   raw_length{ 0 };            // 解码后的载荷字节数
+    uint32_t   records{ 0 };               // 记录数
+    uint32_t   crc{ 0 };                   // 载荷的 CRC-32C
+    uint64_t   session{ 0 };               // 会话标识
+    uint64_t   seq{ 0 };                   // 帧序号
+};
+
+/**
+ * @brief 编码帧头
+ * @param header 帧头
+ * @param out 输出缓冲区，至少 FRAME_HEADER_SIZE 字节
+ */
+void encode_frame_header( const FrameHeader& header, char* out ) noexcept;
+
+/**
+ * @brief 解码帧头
+ * @param in 输入数据，至少 FRAME_HEADER_SIZE 字节
+ * @param header 返回帧头
+ * @return magic、版本与编码正确，length 与 raw_length 不超过 MAX_FRAME_LENGTH，且未编码时两者
+ *         相等返回 true
+ */
+bool decode_frame_header( const char* in, FrameHeader& header ) noexcept;
+
+/**
+ * @brief 编码累计确认
+ * @param seq 已收到的最大连续帧序号
+ * @param out 输出缓冲区，至少 ACK_SIZE 字节
+ */
+void encode_ack( uint64_t seq, char* out ) noexcept;
+
+/**
+ * @brief 解码累计确认
+ * @param in 输入数据，至少 ACK_SIZE 字节
+ * @param seq 返回确认的帧序号
+ * @return magic 正确返回 true
+ */
+bool decode_ack( const char* in, uint64_t& seq ) noexcept;
+
+}  // namespace sinks
+}  // namespace jzlog
@@ -1,16 +1,47 @@
 /**
  * @file network_sink.h
  * @brief 网络日志 Sink 实现类（TCP + 自动重连 + 批量发送 + 压缩传输）
+ *
+ * 生产者只在 _buffer_mutex 内追加已渲染的日志行；发送方（后台线程或 flush 的调用方）持有
+ * _send_mutex，在 _buffer_mutex 内把当前批次换入发送缓冲区后释放该锁，再在锁外发送。连接失败后
+ * 按指数退避记录下一次重连时间，不在任何线程中睡眠等待，写入不会被网络 I/O 或重连阻塞。
+ *
+ * 已渲染的日志行直接拷贝进池化的定长发送块（NETWORK_CHUNK_SIZE），批次是发送块链，发送时整条链
+ * 组成 iovec 由 sendmsg 一次提交，不再拼接成连续字符串；超过块大小的行单独分配一个等长的块。
+ * 批次不小于 set_zerocopy_threshold() 设置的字节数时以 MSG_ZEROCOPY 发送，收到内核的完成通知后
+ * 发送块才归还池中。
+ *
+ * 每个批次按 net_frame.h 的协议编为一帧发送，帧保留在未确认窗口中直到收集端累计确认；窗口达到
+ * ACK_WINDOW_FRAMES 帧或 MAX_PENDING_BYTES 字节时等待确认，超过 SOCKET_SEND_TIMEOUT_MS 未收到
+ * 确认按断线处理。重连后先按序重发未确认的帧，收集端按 (session, seq) 去重，发送中途断开的帧
+ * 整帧重发而不会在流中留下残缺的行。
+ *
+ * set_compression() 启用后，不小于 min_bytes 的批次在编帧时整体压缩（内置 LZ 或 zstd），压缩后
+ * 节省不到 1/8 的批次按原文发送，并按指数退避跳过后续若干批次再尝试；stats() 给出压缩率和每批
+ * 压缩耗费的 CPU 时间。
+ *
+ * 启用磁盘队列（enable_spool）后，断线期间的批次写入 CDiskSpool 而不是留在内存；重连并重发
+ * 未确认的帧后，按 replay_bytes_per_sec 限速回放磁盘队列，回放完之前的新批次排在队列末尾，
+ * 保证顺序。析构时仍未确认的帧也写入磁盘队列，下次启动以新会话重发，收集端可能收到重复的帧。
  */
 #pragma once
 
 #include "jzlog/core/log_level.h"
 #include "jzlog/core/log_record.h"
+#include "jzlog/core/pattern_formatter.h"
+#include "jzlog/sinks/disk_spool.h"
+#include "jzlog/sinks/net_codec.h"
+#include "jzlog/sinks/net_frame.h"
 #include "jzlog/sinks/sink.h"
+#include "jzlog/utils/buffer_pool.h"
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
@@ -28,14 +59,80 @@ constexpr uint32_t         DEFAULT_RETRY_INTERVAL_MS{ 5000 };
 constexpr uint32_t         MAX_RETRY_INTERVAL_MS{ 60000 };
 constexpr uint32_t         SOCKET_SEND_TIMEOUT_MS{ 5000 };
 constexpr int              DEFAULT_SOCKET_BUFFER_SIZE{ 64 * 1024 };
+constexpr size_t           NETWORK_CHUNK_SIZE{ 64 * 1024 };        // 发送块大小
+constexpr size_t           NETWORK_POOL_SIZE{ 16 };                // 最多保留的空闲发送块数
+constexpr size_t           MAX_PENDING_BYTES{ 16 * 1024 * 1024 };  // 批次与未发出数据各自的上限
+constexpr size_t           ACK_WINDOW_FRAMES{ 32 };                // 最多保留的未确认帧数
 constexpr std::string_view DEFAULT_HOST{ "127.0.0.1" };
 constexpr uint16_t         DEFAULT_PORT{ 9999 };
 
+constexpr size_t DEFAULT_SPOOL_MAX_BYTES{ 1024ULL * 1024 * 1024 };  // 默认磁盘队列上限
+constexpr size_t DEFAULT_SPOOL_SEGMENT_BYTES{ 64 * 1024 * 1024 };   // 默认磁盘队列分段大小
+constexpr size_t DEFAULT_SPOOL_REPLAY_RATE{ 8 * 1024 * 1024 };      // 默认回放速率（字节/秒）
+
+constexpr size_t DEFAULT_COMPRESS_MIN_BYTES{ 4 * 1024 };  // 默认参与压缩的最小批次字节数
+
+/**
+ * @struct CompressionConfig
+ * @brief 网络 Sink 的批次压缩配置
+ */
+struct CompressionConfig {
+    FrameCodec codec{ FrameCodec::LZ };                  // 编码，NONE 表示关闭压缩
+    int        level{ 1 };                               // 压缩级别：LZ 为 1-3，ZSTD 为 zstd 级别
+    size_t     min_bytes{ DEFAULT_COMPRESS_MIN_BYTES };  // 小于该字节数的批次不压缩
+};
+
+/**
+ * @struct NetworkStats
+ * @brief 网络 Sink 的发送统计
+ */
+struct NetworkStats {
+    uint64_t frames{ 0 };       // 已编帧的批次数
+    uint64_t attempted{ 0 };    // 执行过压缩的批次数
+    uint64_t compressed{ 0 };   // 以压缩结果发送的批次数
+    uint64_t raw_bytes{ 0 };    // 执行过压缩的批次的原文字节数
+    uint64_t wire_bytes{ 0 };   // 这些批次实际发送的载荷字节数
+    uint64_t compress_ns{ 0 };  // 压缩耗费的线程 CPU 时间（纳秒）
+
+    /**
+     * @brief 获取压缩率
+     * @return 发送字节数与原文字节数之比，未压缩过时为 1
+     */
+    double ratio() const noexcept {
+        return raw_bytes == 0 ? 1.0 : static_cast< double >( wire_bytes ) / raw_bytes;
+    }
+
+    /**
+     * @brief 获取每批压缩耗费的 CPU 时间
+     * @return 纳秒，未压缩过时为 0
+     */
+    double compress_ns_per_batch() const noexcept {
+        return attempted == 0 ? 0.0 : static_cast< double >( compress_ns ) / attempted;
+    }
+};
+
+/**
+ * @struct SpoolConfig
+ * @brief 网络 Sink 的磁盘队列配置
+ */
+struct SpoolConfig {
+    std::string dir;                                                // 队列目录
+    size_t      max_bytes{ DEFAULT_SPOOL_MAX_BYTES };               // 队列总大小上限（字节）
+    size_t      segment_bytes{ DEFAULT_SPOOL_SEGMENT_BYTES };       // 单个分段大小（字节）
+    size_t      replay_bytes_per_sec{ DEFAULT_SPOOL_REPLAY_RATE };  // 回放速率，0 表示不限速
+};
+
 /**
  * @class CNetworkSink
  * @brief 网络日志 Sink 实现类，支持 TCP 连接、自动重连、批量发送和压缩传输
  */
 class CNetworkSink final : public ISink {
+public:
+    using Clock     = std::chrono::steady_clock;         // 重连计时时钟
+    using Buffer    = utils::CBuffer;                    // 发送块类型
+    using BufferPtr = utils::CBufferPool::BufferPtr;     // 发送块指针类型
+    using BufferVec = std::vector< BufferPtr >;          // 发送块链类型
+
 public:
     /**
      * @brief 默认构造函数
@@ -83,6 +180,20 @@ public:
      */
     bool write( const LogRecord& r ) noexcept override;
 
+    /**
+     * @brief 获取日志行格式化器
+     * @return 格式化器
+     */
+    const CPatternFormatter* formatter() const noexcept override;
+
+    /**
+     * @brief 写入已渲染好的日志行
+     * @param r 日志记录
+     * @param line 渲染结果
+     * @return 成功返回 true，失败返回 false
+     */
+    bool write_formatted( const LogRecord& r, std::string_view line ) noexcept override;
+
     /**
      * @brief 刷新缓冲区
      * @return 成功返回 true，失败返回 false
@@ -108,6 +219,12 @@ public:
      */
     bool should_log( LogLevel lvl ) const noexcept override;
 
+    /**
+     * @brief 设置日志行格式模式串，应在开始记录日志前调用
+     * @param pattern 模式串，占位符见 CPatternFormatter
+     */
+    void set_pattern( std::string_view pattern );
+
     /**
      * @brief 设置是否启用
      * @param enabled 启用状态
@@ -120,12 +237,59 @@ public:
      */
     bool enabled() const noexcept override;
 
+    /**
+     * @brief 设置使用 MSG_ZEROCOPY 发送的批次大小下限
+     * @param bytes 批次字节数下限，0 表示不使用（默认）
+     * @note 内核不支持 SO_ZEROCOPY 时自动退回普通发送
+     */
+    void set_zerocopy_threshold( size_t bytes ) noexcept;
+
+    /**
+     * @brief 启用磁盘队列，断线期间的批次写入磁盘并在重连后按序限速回放
+     * @param config 队列配置，目录中已有的队列会被恢复并在连接后回放
+     * @return 队列可用返回 true
+     */
+    bool enable_spool( const SpoolConfig& config ) noexcept;
+
+    /**
+     * @brief 设置批次压缩
+     * @param config 压缩配置，codec 为 NONE 时关闭压缩
+     * @return 编码可用返回 true，不可用时保持原设置并返回 false
+     */
+    bool set_compression( const CompressionConfig& config ) noexcept;
+
+    /**
+     * @brief 获取发送统计
+     * @return 统计快照
+     */
+    NetworkStats stats() const noexcept;
+
+    /**
+     * @brief 获取丢弃的记录数
+     * @return 积压超过 MAX_PENDING_BYTES、磁盘队列已满或析构时仍未确认而丢弃的记录总数
+     */
+    uint64_t dropped() const noexcept;
+
     /**
      * @brief 析构函数
      */
     ~CNetworkSink();
 
 private:
+    /**
+     * @struct Frame
+     * @brief 已编号、等待收集端确认的帧
+     */
+    struct Frame {
+        uint64_t                              _seq{ 0 };                   // 帧序号
+        uint32_t                              _records{ 0 };               // 记录数
+        size_t                                _bytes{ 0 };                 // 载荷字节数
+        size_t                                _raw_bytes{ 0 };             // 解码后的载荷字节数
+        FrameCodec                            _codec{ FrameCodec::NONE };  // 载荷编码
+        std::array< char, FRAME_HEADER_SIZE > _header{};                   // 已编码的帧头
+        BufferVec                             _chunks;                     // 载荷发送块
+    };
+
     /**
      * @brief 建立 TCP 连接
      * @return 成功返回 true，失败返回 false
@@ -138,13 +302,127 @@ private:
     void disconnect() noexcept;
 
     /**
-     * @brief 自动重连（指数退避）
+     * @brief 断开连接并按指数退避安排下一次重连时间
      */
     void auto_reconnect() noexcept;
 
     /**
-     * @brief 批量发送日志
+     * @brief 换出当前批次并在缓冲区锁外发送
+     * @return 发送成功或无数据返回 true，失败返回 false
+     */
+    bool send_pending() noexcept;
+
+    /**
+     * @brief 将当前批次移入发送缓冲区
+     * @note 调用方需持有 _send_mutex
+     */
+    void swap_batch() noexcept;
+
+    /**
+     * @brief 把一行追加到批次末尾的发送块，空间不足时接上新的发送块
+     * @param line 日志行
+     * @return 成功返回 true，内存不足返回 false
+     * @note 调用方需持有 _buffer_mutex
+     */
+    bool append_line( std::string_view line ) noexcept;
+
+    /**
+     * @brief 把发送块编为下一帧追加到未确认窗口
+     * @param chunks 载荷发送块，成功时被移入帧中
+     * @param bytes 载荷字节数
+     * @param records 记录数
+     * @return 成功返回 true，内存不足返回 false
+     */
+    bool push_frame( BufferVec& chunks, size_t bytes, size_t records ) noexcept;
+
+    /**
+     * @brief 按压缩配置压缩发送块，压缩后的数据放回池化的发送块
+     * @param chunks 发送块，压缩成功时被替换为压缩结果
+     * @param bytes 载荷字节数，压缩成功时更新为压缩后的字节数
+     * @return 实际使用的编码，未压缩返回 FrameCodec::NONE
+     */
+    FrameCodec compress_chunks( BufferVec& chunks, size_t& bytes ) noexcept;
+
+    /**
+     * @brief 以 sendmsg 发送帧头与载荷，部分发送时从断点继续
+     * @param frame 帧
+     * @param zerocopy 是否使用 MSG_ZEROCOPY
+     * @return 全部发出返回 true，否则返回 false
+     */
+    bool send_frame( const Frame& frame, bool zerocopy ) noexcept;
+
+    /**
+     * @brief 在新连接上按序重发全部未确认的帧
+     * @return 全部发出返回 true，否则返回 false
+     */
+    bool resend_unacked() noexcept;
+
+    /**
+     * @brief 读取收集端的累计确认并释放已确认的帧
+     * @param wait 为 true 时阻塞到至少释放一帧，最长 SOCKET_SEND_TIMEOUT_MS
+     * @return 连接正常返回 true，对端关闭、超时或协议错误返回 false
+     */
+    bool read_acks( bool wait ) noexcept;
+
+    /**
+     * @brief 等待未确认窗口容得下一个新帧
+     * @param bytes 新帧的载荷字节数
+     * @return 有空位返回 true，等待确认失败返回 false
+     */
+    bool wait_window( size_t bytes ) noexcept;
+
+    /**
+     * @brief 等待全部未确认的帧被确认
+     * @return 全部确认返回 true，未连接或等待失败返回 false
+     */
+    bool wait_acked() noexcept;
+
+    /**
+     * @brief 清空未确认窗口：启用磁盘队列时写入队列，否则计入丢弃
+     */
+    void release_unacked() noexcept;
+
+    /**
+     * @brief 等待已提交的 MSG_ZEROCOPY 发送全部完成
+     * @return 全部完成返回 true，超时或出错返回 false
+     */
+    bool wait_zerocopy() noexcept;
+
+    /**
+     * @brief 清空发送块链并把发送块归还池中
+     */
+    void release_send_chain() noexcept;
+
+    /**
+     * @brief 把发送块写入磁盘队列
+     * @param chunks 发送块
+     * @param records 记录数
+     * @return 成功返回 true，队列已满或写入失败返回 false
+     */
+    bool spool_chunks( const BufferVec& chunks, size_t records ) noexcept;
+
+    /**
+     * @brief 把帧的原文写入磁盘队列，压缩过的帧先解压
+     * @param frame 帧
+     * @return 成功返回 true，否则返回 false
+     */
+    bool spool_frame( const Frame& frame ) noexcept;
+
+    /**
+     * @brief 把发送块链写入磁盘队列，写入失败时计入丢弃
+     */
+    void spool_send_chain() noexcept;
+
+    /**
+     * @brief 按回放速率把磁盘队列中的批次编帧发送
+     * @return 连接正常返回 true，发送失败返回 false
+     */
+    bool replay_spool() noexcept;
+
+    /**
+     * @brief 发送发送缓冲区中的数据，未到重连时间时直接返回
      * @return 成功返回 true，失败返回 false
+     * @note 调用方需持有 _send_mutex，不得持有 _buffer_mutex
      */
     bool send_batch() noexcept;
 
@@ -153,13 +431,6 @@ private:
      */
     void work_thread() noexcept;
 
-    /**
-     *brief 格式化日志记录
-     * @param r 日志记录
-     * @return 格式化后的字符串
-     */
-    std::string format_log_record( const LogRecord& r );
-
     /**
      * @brief 设置 socket 超时
      * @param timeout_ms 超时时间（毫秒）
@@ -179,18 +450,60 @@ private:
     int                 _socket_fd;              // Socket 文件描述符
     std::atomic< bool > _connected;              // 连接状态
 
-    size_t                   _batch_size;        // 批量大小
-    uint32_t                 _batch_timeout_ms;  // 批量超时（毫秒）
-    std::vector< LogRecord > _batch_buffer;      // 批量缓冲区
-    std::mutex               _buffer_mutex;      // 缓冲区互斥锁
+    size_t      _batch_size;                     // 批量大小
+    uint32_t    _batch_timeout_ms;               // 批量超时（毫秒）
+    utils::CBufferPool _pool;                    // 发送块池
+    BufferVec          _batch;                   // 当前批次（已渲染的日志行）
+    size_t             _batch_bytes;             // 当前批次字节数
+    size_t             _batch_count;             // 当前批次中的记录数
+    std::mutex         _buffer_mutex;            // 缓冲区互斥锁
+
+    BufferVec             _send_chain;           // 发送块链（_send_mutex）
+    size_t                _send_bytes;           // 发送块链字节数（_send_mutex）
+    size_t                _send_count;           // 发送块链中的记录数（_send_mutex）
+    std::mutex            _send_mutex;           // 串行化换出与发送
+    std::atomic< size_t > _zerocopy_threshold;   // MSG_ZEROCOPY 批次大小下限，0 表示不使用
+    bool                  _zerocopy;             // 当前连接已启用 SO_ZEROCOPY（_send_mutex）
+    uint32_t              _zc_issued;            // 当前连接已提交的零拷贝发送数（_send_mutex）
+    uint32_t              _zc_completed;         // 当前连接已完成的零拷贝发送数（_send_mutex）
+
+    uint64_t                     _session;        // 会话标识
+    uint64_t                     _next_seq;       // 上一个已分配的帧序号（_send_mutex）
+    std::deque< Frame >          _unacked;        // 未确认窗口，队首最早（_send_mutex）
+    size_t                       _unacked_bytes;  // 未确认窗口的载荷字节数（_send_mutex）
+    std::array< char, ACK_SIZE > _ack_buffer;     // 未读完的确认（_send_mutex）
+    size_t                       _ack_fill;       // _ack_buffer 中已读的字节数（_send_mutex）
 
-    uint32_t _retry_interval_ms;                 // 重连间隔（毫秒）
-    uint32_t _retry_backoff;                     // 退避倍数
+    std::unique_ptr< CFrameCompressor > _compressor;          // 压缩器，未启用时为空（_send_mutex）
+    size_t                              _compress_min_bytes;  // 参与压缩的最小批次字节数
+    uint32_t                            _compress_backoff;    // 压缩效果差时跳过的批次数
+    uint32_t                            _compress_skip;       // 剩余跳过的批次数（_send_mutex）
+    std::string                         _compress_input;      // 多个发送块拼接后的压缩输入
+    std::string                         _compress_output;     // 压缩输出缓冲区（_send_mutex）
+    std::atomic< uint64_t >             _stat_frames;         // 已编帧的批次数
+    std::atomic< uint64_t >             _stat_attempted;      // 执行过压缩的批次数
+    std::atomic< uint64_t >             _stat_compressed;     // 以压缩结果发送的批次数
+    std::atomic< uint64_t >             _stat_raw_bytes;      // 执行过压缩的原文字节数
+    std::atomic< uint64_t >             _stat_wire_bytes;     // 执行过压缩的发送字节数
+    std::atomic< uint64_t >             _stat_compress_ns;    // 压缩耗费的线程 CPU 时间
+
+    std::unique_ptr< CDiskSpool > _spool;          // 磁盘队列，未启用时为空（_send_mutex）
+    size_t                        _replay_rate;    // 回放速率（字节/秒），0 表示不限速
+    double                        _replay_budget;  // 本轮可回放的字节数（_send_mutex）
+    Clock::time_point             _replay_at;      // 上次补充回放额度的时间（_send_mutex）
+    std::string                   _replay_buffer;  // 回放读取缓冲区（_send_mutex）
+
+    uint32_t                _retry_interval_ms;  // 重连间隔（毫秒）
+    uint32_t                _retry_backoff;      // 退避倍数
+    Clock::time_point       _retry_at;           // 下一次允许重连的时间（_send_mutex）
+    std::atomic< uint64_t > _dropped;            // 丢弃的记录数
 
     std::thread             _thread;             // 后台工作线程
     std::atomic< bool >     _running;            // 线程运行标志
     std::condition_variable _cond;               // 条件变量
     std::atomic< bool >     _enabled;            // 启用状态
+
+    CPatternFormatter _formatter;                // 日志行格式化器
 };
 
 }  // namespace sinks
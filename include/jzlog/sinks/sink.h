@@ -6,9 +6,13 @@
 
 #include "jzlog/core/log_level.h"
 #include "jzlog/core/log_record.h"
+#include <string_view>
 
 namespace jzlog
 {
+
+class CPatternFormatter;
+
 namespace sinks
 {
 
@@ -30,6 +34,25 @@ public:
      */
     virtual bool write( const LogRecord& record ) = 0;
 
+    /**
+     * @brief 获取 sink 使用的日志行格式化器
+     * @return 格式化器，不使用模式串格式化的 sink 返回 nullptr
+     * @note 返回非空的 sink，日志记录器会按模式串把记录只渲染一次，
+     *       再通过 write_formatted() 交给所有使用相同模式串的 sink
+     */
+    virtual const CPatternFormatter* formatter() const noexcept { return nullptr; }
+
+    /**
+     * @brief 写入已按 formatter() 渲染好的日志行
+     * @param record 日志记录
+     * @param line 渲染结果，只在本次调用期间有效
+     * @return 成功返回 true，失败返回 false
+     */
+    virtual bool write_formatted( const LogRecord& record, std::string_view line ) {
+        (void)line;
+        return write( record );
+    }
+
     /**
      * @brief 刷新倒缓冲区
      * @return 成功返回 true，失败返回 false
@@ -0,0 +1,169 @@
+/**
+ * @file uring_writer.h
+ * @brief 基于 io_uring 的异步文件写入器
+ *
+ * 直接通过 io_uring_setup/io_uring_enter 系统调用驱动提交队列与完成队列，不依赖 liburing。
+ * 每个缓冲区按显式偏移提交为一条 IORING_OP_WRITE，多条写入可同时在途而不会乱序落盘；
+ * 完成事件到达时缓冲区归还缓冲区池。环建立失败（内核过旧或 io_uring 被禁用）时 valid()
+ * 返回 false，由调用方退回同步写入路径；运行中发现内核不支持写入操作时改用 pwrite 写完。
+ */
+#pragma once
+
+#include "jzlog/utils/buffer_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+constexpr unsigned DEFAULT_URING_DEPTH{ 8 };  // 默认最多同时在途的写入数
+
+/**
+ * @class CUringWriter
+ * @brief 基于 io_uring 的异步文件写入器
+ * @note 非线程安全，调用方需串行化所有调用
+ */
+class CUringWriter {
+public:
+    using BufferPtr = utils::CBufferPool::BufferPtr;  // 缓冲区指针类型
+
+public:
+    /**
+     * @brief 构造函数
+     * @param pool 完成后归还缓冲区的缓冲区池
+     * @param depth 最多同时在途的写入数
+     */
+    explicit CUringWriter( utils::CBufferPool& pool, unsigned depth ) noexcept;
+
+    /**
+     * @brief 拷贝构造函数（已删除）
+     */
+    CUringWriter( const CUringWriter& ) = delete;
+
+    /**
+     * @brief 拷贝赋值运算符（已删除）
+     */
+    CUringWriter& operator=( const CUringWriter& ) = delete;
+
+    /**
+     * @brief 析构函数，等待所有在途写入完成
+     */
+    ~CUringWriter();
+
+    /**
+     * @brief 判断写入器是否可用
+     * @return 环已建立且未遇到内核不支持的操作时返回 true
+     */
+    bool valid() const noexcept { return _ring_fd >= 0 && !_unsupported; }
+
+    /**
+     * @brief 提交一个缓冲区的写入，在途写入已满时先等待一个完成事件
+     * @param fd 文件描述符
+     * @param offset 写入的文件偏移
+     * @param buffer 缓冲区，完成后归还缓冲区池
+     * @note 写入只被准备好，在下一次 reap()/drain() 或需要等待空闲槽位时一并提交；
+     *       环不可用时退回同步 pwrite
+     */
+    void write( int fd, uint64_t offset, BufferPtr buffer ) noexcept;
+
+    /**
+     * @brief 提交已准备的写入并回收已到达的完成事件，不阻塞
+     */
+    void reap() noexcept;
+
+    /**
+     * @brief 等待所有在途写入完成
+     * @return 自上次 drain() 以来的写入全部成功返回 true
+     * @note 环失效后最多等待 5 秒，仍未完成的写入被放弃（缓冲区泄漏）并返回 false
+     */
+    bool drain() noexcept;
+
+    /**
+     * @brief 获取在途写入数
+     * @return 在途写入数
+     */
+    size_t in_flight() const noexcept { return _in_flight; }
+
+private:
+    /**
+     * @struct Slot
+     * @brief 一条在途写入
+     */
+    struct Slot {
+        BufferPtr _buffer;       // 缓冲区
+        int       _fd{ -1 };     // 文件描述符
+        uint64_t  _offset{ 0 };  // 缓冲区起始位置对应的文件偏移
+        size_t    _done{ 0 };    // 已写入的字节数
+    };
+
+    /**
+     * @brief 为槽位剩余数据准备一条提交队列项
+     * @param index 槽位下标
+     */
+    void prepare( unsigned index ) noexcept;
+
+    /**
+     * @brief 提交已准备的提交队列项，并可选地等待完成事件
+     * @details 系统调用失败时标记为不支持，撤回尚未提交的提交队列项并以 pwrite 写完；
+     *          已提交的写入保留缓冲区，等到完成事件后再归还
+     * @param wait_nr 至少等待的完成事件数
+     * @return 系统调用成功返回 true
+     */
+    bool enter( unsigned wait_nr ) noexcept;
+
+    /**
+     * @brief 以 pwrite 同步写完槽位剩余数据并结束该写入
+     * @param index 槽位下标
+     */
+    void write_sync( unsigned index ) noexcept;
+
+    /**
+     * @brief 处理完成队列中的所有事件
+     */
+    void process_completions() noexcept;
+
+    /**
+     * @brief 结束一条写入，归还缓冲区
+     * @param index 槽位下标
+     */
+    void finish( unsigned index ) noexcept;
+
+    /**
+     * @brief 放弃仍在内核中的写入：缓冲区不归还缓冲区池，避免被重新填充后又被迟到的写入落盘
+     */
+    void abandon_submitted() noexcept;
+
+    /**
+     * @brief 释放环相关资源
+     */
+    void close_ring() noexcept;
+
+private:
+    utils::CBufferPool&     _pool;                  // 缓冲区池
+    int                     _ring_fd{ -1 };         // io_uring 文件描述符
+    void*                   _sq_ring{ nullptr };    // 提交队列环映射
+    void*                   _cq_ring{ nullptr };    // 完成队列环映射（单映射时与提交队列相同）
+    void*                   _sqes{ nullptr };       // 提交队列项数组映射
+    size_t                  _sq_ring_size{ 0 };     // 提交队列环映射大小
+    size_t                  _cq_ring_size{ 0 };     // 完成队列环映射大小
+    size_t                  _sqes_size{ 0 };        // 提交队列项数组映射大小
+    unsigned*               _sq_tail{ nullptr };    // 提交队列尾
+    unsigned*               _sq_mask{ nullptr };    // 提交队列掩码
+    unsigned*               _sq_array{ nullptr };   // 提交队列下标数组
+    unsigned*               _cq_head{ nullptr };    // 完成队列头
+    unsigned*               _cq_tail{ nullptr };    // 完成队列尾
+    unsigned*               _cq_mask{ nullptr };    // 完成队列掩码
+    void*                   _cqes{ nullptr };       // 完成队列项数组
+    unsigned                _to_submit{ 0 };        // 已准备未提交的提交队列项数
+    size_t                  _in_flight{ 0 };        // 在途写入数
+    bool                    _unsupported{ false };  // 内核不支持写入操作，已退回 pwrite
+    bool                    _all_success{ true };   // 自上次 drain() 以来的写入是否全部成功
+    std::vector< Slot >     _slots;                 // 写入槽位
+    std::vector< unsigned > _free_slots;            // 空闲槽位下标
+};
+
+}  // namespace sinks
+}  // namespace jzlog
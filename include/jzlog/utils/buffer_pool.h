@@ -0,0 +1,213 @@
+/**
+ * @file buffer_pool.h
+ * @brief 运行期定长缓冲区与有界缓冲区池
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace jzlog
+{
+namespace utils
+{
+
+constexpr size_t kPageSize = 4096;  // 预触页面时的步长
+
+/**
+ * @class CBuffer
+ * @brief 容量在运行期确定的定长缓冲区
+ */
+class CBuffer {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 容量（字节）
+     * @note 内存不做值初始化，首次写入时才产生缺页；需要时调用 prefault()
+     */
+    explicit CBuffer( size_t capacity ) :
+        _data( new char[ capacity ] ),
+        _capacity( capacity ),
+        _size( 0 ) {}
+
+    /**
+     * @brief 拷贝构造函数（已删除）
+     */
+    CBuffer( const CBuffer& ) = delete;
+
+    /**
+     * @brief 拷贝赋值运算符（已删除）
+     */
+    CBuffer& operator=( const CBuffer& ) = delete;
+
+    /**
+     * @brief 追加数据
+     * @param buf 数据指针
+     * @param len 数据长度
+     * @return 成功返回 true，空间不足返回 false
+     */
+    bool append( const char* buf, size_t len ) noexcept {
+        if ( avail() < len || buf == nullptr ) {
+            return false;
+        }
+        std::memcpy( _data.get() + _size, buf, len );
+        _size += len;
+        return true;
+    }
+
+    /**
+     * @brief 获取数据指针
+     * @return 数据指针
+     */
+    [[nodiscard]] const char* data() const noexcept { return _data.get(); }
+
+    /**
+     * @brief 获取可写数据指针，用于并发预留后直接拷贝到指定偏移
+     * @return 数据指针
+     */
+    [[nodiscard]] char* data() noexcept { return _data.get(); }
+
+    /**
+     * @brief 获取已用长度
+     * @return 已用长度
+     */
+    size_t length() const noexcept { return _size; }
+
+    /**
+     * @brief 获取剩余空间
+     * @return 剩余空间
+     */
+    size_t avail() const noexcept { return _capacity - _size; }
+
+    /**
+     * @brief 获取容量
+     * @return 容量
+     */
+    size_t capacity() const noexcept { return _capacity; }
+
+    /**
+     * @brief 重置缓冲区
+     */
+    void reset() noexcept { _size = 0; }
+
+    /**
+     * @brief 在直接写入 data() 之后设置已用长度
+     * @param len 已用长度，超过容量时截为容量
+     */
+    void set_length( size_t len ) noexcept { _size = len < _capacity ? len : _capacity; }
+
+    /**
+     * @brief 逐页写入，提前完成缺页
+     */
+    void prefault() noexcept {
+        for ( size_t off = 0; off < _capacity; off += kPageSize ) {
+            _data[ off ] = 0;
+        }
+    }
+
+private:
+    std::unique_ptr< char[] > _data;      // 数据区
+    size_t                    _capacity;  // 容量
+    size_t                    _size;      // 已用大小
+};
+
+/**
+ * @class CBufferPool
+ * @brief 有界缓冲区池
+ *
+ * 池中最多保留 max_free 个空闲缓冲区，构造时预先分配并预触 prefault_count 个。
+ * 池空时 acquire() 临时分配新缓冲区，保证写入方不因池耗尽而失败；
+ * 归还时超出上限的缓冲区直接释放，因此突发流量过后常驻内存会回落到上限以内。
+ */
+class CBufferPool {
+public:
+    using BufferPtr = std::unique_ptr< CBuffer >;  // 缓冲区指针类型
+
+    /**
+     * @brief 构造函数
+     * @param buffer_size 每个缓冲区的容量（字节）
+     * @param max_free 最多保留的空闲缓冲区数
+     * @param prefault_count 预先分配并预触的缓冲区数（不超过 max_free）
+     */
+    CBufferPool( size_t buffer_size, size_t max_free, size_t prefault_count ) :
+        _buffer_size( buffer_size ),
+        _max_free( max_free ),
+        _free(),
+        _mutex() {
+        _free.reserve( max_free );
+        for ( size_t i = 0; i < prefault_count && i < max_free; ++i ) {
+            auto buffer = std::make_unique< CBuffer >( buffer_size );
+            buffer->prefault();
+            _free.emplace_back( std::move( buffer ) );
+        }
+    }
+
+    /**
+     * @brief 拷贝构造函数（已删除）
+     */
+    CBufferPool( const CBufferPool& ) = delete;
+
+    /**
+     * @brief 拷贝赋值运算符（已删除）
+     */
+    CBufferPool& operator=( const CBufferPool& ) = delete;
+
+    /**
+     * @brief 取出一个空缓冲区
+     * @return 缓冲区，内存不足时返回 nullptr
+     */
+    BufferPtr acquire() noexcept {
+        {
+            std::lock_guard< std::mutex > lock{ _mutex };
+            if ( !_free.empty() ) {
+                BufferPtr buffer = std::move( _free.back() );
+                _free.pop_back();
+                return buffer;
+            }
+        }
+        return BufferPtr( new ( std::nothrow ) CBuffer( _buffer_size ) );
+    }
+
+    /**
+     * @brief 归还缓冲区，超出上限时直接释放
+     * @param buffer 缓冲区
+     */
+    void release( BufferPtr buffer ) noexcept {
+        if ( !buffer || buffer->capacity() != _buffer_size ) {
+            return;
+        }
+        buffer->reset();
+        std::lock_guard< std::mutex > lock{ _mutex };
+        if ( _free.size() < _max_free ) {
+            _free.emplace_back( std::move( buffer ) );
+        }
+    }
+
+    /**
+     * @brief 获取每个缓冲区的容量
+     * @return 容量（字节）
+     */
+    size_t buffer_size() const noexcept { return _buffer_size; }
+
+    /**
+     * @brief 获取当前空闲缓冲区数
+     * @return 空闲缓冲区数
+     */
+    size_t free_count() const noexcept {
+        std::lock_guard< std::mutex > lock{ _mutex };
+        return _free.size();
+    }
+
+private:
+    const size_t             _buffer_size;  // 每个缓冲区的容量
+    const size_t             _max_free;     // 最多保留的空闲缓冲区数
+    std::vector< BufferPtr > _free;         // 空闲缓冲区
+    mutable std::mutex       _mutex;        // 互斥锁
+};
+
+}  // namespace utils
+}  // namespace jzlog
@@ -0,0 +1,154 @@
+/**
+ * @file clock.h
+ * @brief 时间戳时钟源：system_clock、CLOCK_REALTIME_COARSE 与校准后的 TSC
+ *
+ * 调用线程只采集原始计数（now_ticks），转换为墙上时间（to_time_point）可以推迟到
+ * 后台线程完成。三种时钟源的原始计数都是 uint64_t，记录布局保持一致。
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define JZLOG_HAS_RDTSC 1
+#endif
+
+namespace jzlog
+{
+namespace utils
+{
+
+/**
+ * @enum ClockSource
+ * @brief 时间戳时钟源
+ */
+enum class ClockSource : int
+{
+    SYSTEM = 0,       // std::chrono::system_clock，原始计数为纳秒
+    REALTIME_COARSE,  // CLOCK_REALTIME_COARSE（精度为内核 tick），原始计数为纳秒
+    TSC               // rdtsc 计数，启动时校准一次，由后台线程换算为墙上时间
+};
+
+/**
+ * @class CTscClock
+ * @brief 校准后的 TSC 时钟
+ *
+ * 校准时记录一对 (TSC, 墙上时间纳秒) 基准点，并测量每个 TSC 计数对应的纳秒数；
+ * 之后的换算只需一次乘加。不支持 rdtsc 的平台退化为 steady_clock 纳秒计数。
+ */
+class CTscClock {
+public:
+    /**
+     * @brief 获取全局实例，首次调用时完成校准（约 10 毫秒）
+     * @return 全局实例
+     */
+    static const CTscClock& instance() {
+        static const CTscClock clock;
+        return clock;
+    }
+
+    /**
+     * @brief 读取原始计数
+     * @return 原始计数
+     */
+    static uint64_t rdtsc() noexcept {
+#ifdef JZLOG_HAS_RDTSC
+        return __rdtsc();
+#else
+        return static_cast< uint64_t >(
+            std::chrono::steady_clock::now().time_since_epoch().count() );
+#endif
+    }
+
+    /**
+     * @brief 将原始计数换算为自纪元以来的纳秒数
+     * @param ticks 原始计数
+     * @return 纳秒数
+     */
+    int64_t to_epoch_ns( uint64_t ticks ) const noexcept {
+        auto delta = static_cast< double >( static_cast< int64_t >( ticks - _base_ticks ) );
+        return _base_ns + static_cast< int64_t >( delta * _ns_per_tick );
+    }
+
+    /**
+     * @brief 获取每个计数对应的纳秒数
+     * @return 纳秒数
+     */
+    double ns_per_tick() const noexcept { return _ns_per_tick; }
+
+private:
+    CTscClock() {
+        auto     wall0  = std::chrono::system_clock::now();
+        auto     start  = std::chrono::steady_clock::now();
+        uint64_t ticks0 = rdtsc();
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+        auto     end    = std::chrono::steady_clock::now();
+        uint64_t ticks1 = rdtsc();
+
+        auto elapsed_ns =
+            std::chrono::duration_cast< std::chrono::nanoseconds >( end - start ).count();
+        _ns_per_tick = ticks1 > ticks0 ? static_cast< double >( elapsed_ns ) / ( ticks1 - ticks0 )
+                                       : 1.0;
+        _base_ticks  = ticks0;
+        _base_ns     = std::chrono::duration_cast< std::chrono::nanoseconds >(
+                       wall0.time_since_epoch() )
+                       .count();
+    }
+
+private:
+    uint64_t _base_ticks{ 0 };     // 基准点 TSC 计数
+    int64_t  _base_ns{ 0 };        // 基准点墙上时间（纳秒）
+    double   _ns_per_tick{ 1.0 };  // 每个计数对应的纳秒数
+};
+
+/**
+ * @brief 采集当前时间的原始计数
+ * @param source 时钟源
+ * @return 原始计数
+ */
+inline uint64_t now_ticks( ClockSource source ) noexcept {
+    switch ( source ) {
+    case ( ClockSource::TSC ):
+        return CTscClock::rdtsc();
+#ifdef CLOCK_REALTIME_COARSE
+    case ( ClockSource::REALTIME_COARSE ): {
+        struct timespec ts;
+        clock_gettime( CLOCK_REALTIME_COARSE, &ts );
+        return static_cast< uint64_t >( ts.tv_sec ) * 1000000000ULL +
+               static_cast< uint64_t >( ts.tv_nsec );
+    }
+#endif
+    default:
+        return static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >(
+                                            std::chrono::system_clock::now().time_since_epoch() )
+                                            .count() );
+    }
+}
+
+/**
+ * @brief 将原始计数换算为墙上时间
+ * @param source 时钟源
+ * @param ticks now_ticks() 的结果
+ * @return 墙上时间
+ */
+inline std::chrono::system_clock::time_point to_time_point( ClockSource source,
+                                                            uint64_t    ticks ) noexcept {
+    int64_t ns = source == ClockSource::TSC ? CTscClock::instance().to_epoch_ns( ticks )
+                                            : static_cast< int64_t >( ticks );
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast< std::chrono::system_clock::duration >(
+            std::chrono::nanoseconds( ns ) ) );
+}
+
+}  // namespace utils
+}  // namespace jzlog
@@ -0,0 +1,108 @@
+/**
+ * @file fd_writer.h
+ * @brief 基于文件描述符的完整写入（writev/pwrite，处理短写与 EINTR）
+ */
+#pragma once
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace jzlog
+{
+namespace utils
+{
+
+#ifdef IOV_MAX
+constexpr int kMaxIovecs = IOV_MAX;  // 单次 writev 的最大 iovec 数
+#else
+constexpr int kMaxIovecs = 1024;     // 单次 writev 的最大 iovec 数
+#endif
+
+/**
+ * @brief 将 iovec 数组全部写入 fd
+ * @details 每次最多提交 kMaxIovecs 个 iovec；短写时跳过已写完的 iovec 并调整首个未写完
+ *          iovec 的起点后继续，被信号中断（EINTR）时重试。
+ * @param fd 文件描述符
+ * @param iov iovec 数组，写入过程中会被修改
+ * @param count iovec 个数
+ * @return 全部写入返回 true，出错返回 false（errno 保留出错原因）
+ */
+inline bool write_fully( int fd, struct iovec* iov, int count ) noexcept {
+    while ( count > 0 ) {
+        // 跳过长度为 0 的 iovec，避免 writev 返回 0 时误判为无进展
+        if ( iov->iov_len == 0 ) {
+            ++iov;
+            --count;
+            continue;
+        }
+
+        ssize_t written = ::writev( fd, iov, count < kMaxIovecs ? count : kMaxIovecs );
+        if ( written < 0 ) {
+            if ( errno == EINTR ) {
+                continue;
+            }
+            return false;
+        }
+
+        auto remain = static_cast< size_t >( written );
+        while ( count > 0 && remain >= iov->iov_len ) {
+            remain -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if ( count > 0 ) {
+            iov->iov_base = static_cast< char* >( iov->iov_base ) + remain;
+            iov->iov_len -= remain;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 将一段连续内存全部写入 fd
+ * @param fd 文件描述符
+ * @param data 数据指针
+ * @param len 数据长度
+ * @return 全部写入返回 true，出错返回 false
+ */
+inline bool write_fully( int fd, const char* data, size_t len ) noexcept {
+    struct iovec iov;
+    iov.iov_base = const_cast< char* >( data );
+    iov.iov_len  = len;
+    return write_fully( fd, &iov, 1 );
+}
+
+/**
+ * @brief 将一段连续内存全部写入 fd 的指定偏移处，不改变文件位置
+ * @param fd 文件描述符（不能以 O_APPEND 打开）
+ * @param data 数据指针
+ * @param len 数据长度
+ * @param offset 文件偏移
+ * @return 全部写入返回 true，出错返回 false（errno 保留出错原因）
+ */
+inline bool pwrite_fully( int fd, const char* data, size_t len, off_t offset ) noexcept {
+    while ( len > 0 ) {
+        ssize_t written = ::pwrite( fd, data, len, offset );
+        if ( written < 0 ) {
+            if ( errno == EINTR ) {
+                continue;
+            }
+            return false;
+        }
+        if ( written == 0 ) {
+            errno = EIO;
+            return false;
+        }
+        data += written;
+        len -= static_cast< size_t >( written );
+        offset += written;
+    }
+    return true;
+}
+
+}  // namespace utils
+}  // namespace jzlog
@@ -99,6 +99,31 @@ public:
         return true;
     }
 
+    /**
+     * @brief 获取当前写入位置指针，用于直接格式化到缓冲区
+     * @return 写入位置指针
+     */
+    [[nodiscard]] char* current() noexcept { return _data.data() + _size; }
+
+    /**
+     * @brief 在直接写入 current() 之后推进已用大小
+     * @param len 写入长度
+     * @return 成功返回 true，超出可用空间返回 false
+     */
+    bool add( size_t len ) noexcept {
+        if ( avail() < len ) {
+            return false;
+        }
+        _size += len;
+        return true;
+    }
+
+    /**
+     * @brief 获取缓冲区总容量
+     * @return 总容量
+     */
+    static constexpr size_t capacity() noexcept { return _N; }
+
     /**
      * @brief 重置缓冲区
      */
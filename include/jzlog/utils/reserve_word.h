@@ -0,0 +1,138 @@
+/**
+ * @file reserve_word.h
+ * @brief 无锁空间预留使用的 64 位预留字
+ *
+ * 生产者对预留字做一次 fetch_add( reserve_claim( len ) )，即可同时登记一次预留并取得写入偏移，
+ * 返回值中的代数标识偏移所属的缓冲区（或分段）。换代时把预留字换成下一代的初值，旧值中的
+ * 预留数就是旧缓冲区上需要等待结束的拷贝数。
+ *
+ * | 位     | 含义                            |
+ * |--------|---------------------------------|
+ * | 63..44 | 本代已开始的预留数（模 2^20）   |
+ * | 43..36 | 代数（模 256）                  |
+ * | 35..0  | 本代已预留的字节数              |
+ *
+ * 预留数放在最高位，溢出时直接移出字外而不会污染代数；比较预留数与提交数时两边都取模 2^20，
+ * 只要同时在途的拷贝少于 2^20 个即可正确判断。
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace jzlog
+{
+namespace utils
+{
+
+constexpr unsigned kReserveOffsetBits  = 36;  // 已预留字节数所占位数
+constexpr unsigned kReserveGenBits     = 8;   // 代数所占位数
+constexpr unsigned kReserveWriterShift = kReserveOffsetBits + kReserveGenBits;  // 预留数起始位
+constexpr uint64_t kReserveOffsetMask  = ( uint64_t{ 1 } << kReserveOffsetBits ) - 1;
+constexpr uint32_t kReserveGenMask     = ( uint32_t{ 1 } << kReserveGenBits ) - 1;
+constexpr uint32_t kReserveWriterMask  = ( uint32_t{ 1 } << ( 64 - kReserveWriterShift ) ) - 1;
+
+/**
+ * @brief 构造某一代的初始预留字
+ * @param generation 代数（只保留低 8 位）
+ * @return 预留字
+ */
+constexpr uint64_t make_reserve_word( uint64_t generation ) noexcept {
+    return ( generation & kReserveGenMask ) << kReserveOffsetBits;
+}
+
+/**
+ * @brief 预留 len 字节时加到预留字上的增量
+ * @param len 字节数
+ * @return 增量
+ */
+constexpr uint64_t reserve_claim( size_t len ) noexcept {
+    return ( uint64_t{ 1 } << kReserveWriterShift ) + len;
+}
+
+/**
+ * @brief 取出已预留字节数
+ */
+constexpr uint64_t reserve_bytes( uint64_t word ) noexcept { return word & kReserveOffsetMask; }
+
+/**
+ * @brief 取出代数（模 256）
+ */
+constexpr uint32_t reserve_generation( uint64_t word ) noexcept {
+    return static_cast< uint32_t >( word >> kReserveOffsetBits ) & kReserveGenMask;
+}
+
+/**
+ * @brief 取出已开始的预留数（模 2^20）
+ */
+constexpr uint32_t reserve_writers( uint64_t word ) noexcept {
+    return static_cast< uint32_t >( word >> kReserveWriterShift );
+}
+
+/**
+ * @brief 等待提交数追上预留数
+ * @param committed 提交计数器
+ * @param expected 换代时取出的预留数
+ */
+inline void wait_reserve_commits( const std::atomic< uint32_t >& committed,
+                                  uint32_t                       expected ) noexcept {
+    while ( ( committed.load( std::memory_order_acquire ) & kReserveWriterMask ) != expected ) {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @struct ReserveTarget
+ * @brief 某一代预留写入的目标空间
+ */
+struct ReserveTarget {
+    char*                    base;       // 起始地址，nullptr 表示该代没有可写空间
+    uint64_t                 capacity;   // 容量
+    std::atomic< uint32_t >* committed;  // 该代的提交计数器
+};
+
+/**
+ * @brief 登记一次预留并结束它：空间足够时拷贝数据，否则越过末尾，两种情况都在最后提交
+ *
+ * 预留偏移单调递增，越过末尾的预留中只有一个起点不超过容量，它就是该代的有效长度，
+ * mark_length 只在这一次预留上、提交之前调用。登记前先读取预留字，已放不下时不再登记，
+ * 换代被拒绝（积压满、分段无法创建）期间偏移不会继续增长而进位到代数。
+ *
+ * @param reserve 预留字
+ * @param data 数据指针
+ * @param len 数据长度
+ * @param capacity 每一代的容量上限
+ * @param target 以代数为参数，返回该代的 ReserveTarget
+ * @param mark_length 以有效长度为参数，记录该代的有效长度
+ * @param word 输出登记前的预留字，其中含本次预留的代数与偏移
+ * @return 已拷贝返回 true；该代空间不足返回 false，调用方按 word 中的代数换代后重试
+ */
+template < typename Target, typename MarkLength >
+bool reserve_copy( std::atomic< uint64_t >& reserve, const char* data, size_t len,
+                   uint64_t capacity, Target&& target, MarkLength&& mark_length,
+                   uint64_t& word ) noexcept {
+    // 未登记的预留不计入提交数，有效长度由换代时的已预留字节数决定
+    word = reserve.load( std::memory_order_acquire );
+    if ( reserve_bytes( word ) + len > capacity ) {
+        return false;
+    }
+
+    word = reserve.fetch_add( reserve_claim( len ), std::memory_order_acq_rel );
+    uint64_t      offset = reserve_bytes( word );
+    ReserveTarget dest   = target( reserve_generation( word ) );
+
+    bool copied = dest.base != nullptr && offset + len <= dest.capacity;
+    if ( copied ) {
+        std::memcpy( dest.base + offset, data, len );
+    } else if ( dest.base != nullptr && offset <= dest.capacity ) {
+        mark_length( offset );
+    }
+    dest.committed->fetch_add( 1, std::memory_order_release );
+    return copied;
+}
+
+}  // namespace utils
+}  // namespace jzlog
@@ -0,0 +1,192 @@
+/**
+ * @file spsc_ring.h
+ * @brief 单生产者单消费者无锁环形缓冲区（变长记录）
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace jzlog
+{
+namespace utils
+{
+
+constexpr size_t kCacheLineSize = 64;  // 缓存行大小
+
+/**
+ * @class CSpscRing
+ * @brief 单生产者单消费者无锁环形缓冲区
+ *
+ * 每条记录以 8 字节头部（记录长度）开头，整体按 8 字节对齐。
+ * 尾部剩余空间不足以容纳一条完整记录时，写入回绕标记并从头开始写，
+ * 因此消费者拿到的每条记录都是连续内存。单条记录最大为容量的一半。
+ */
+class CSpscRing {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 容量（字节），向上取整为 2 的幂，最小 4096
+     */
+    explicit CSpscRing( size_t capacity ) :
+        _capacity( round_up_pow2( capacity ) ),
+        _mask( _capacity - 1 ),
+        _data( std::make_unique< char[] >( _capacity ) ) {}
+
+    /**
+     * @brief 拷贝构造函数（已删除）
+     */
+    CSpscRing( const CSpscRing& ) = delete;
+
+    /**
+     * @brief 拷贝赋值运算符（已删除）
+     */
+    CSpscRing& operator=( const CSpscRing& ) = delete;
+
+    /**
+     * @brief 获取容量
+     * @return 容量（字节）
+     */
+    size_t capacity() const noexcept { return _capacity; }
+
+    /**
+     * @brief 获取单条记录的最大长度
+     * @return 最大长度（字节）
+     */
+    size_t max_record_size() const noexcept { return _capacity / 2 - kHeaderSize; }
+
+    /**
+     * @brief 生产者：预留 len 字节的连续空间
+     * @param len 记录长度
+     * @return 成功返回写入地址，空间不足返回 nullptr
+     * @note 写入完成后必须调用 commit()，且两次调用之间不能再次 reserve()
+     */
+    char* reserve( size_t len ) noexcept {
+        if ( len > max_record_size() ) {
+            return nullptr;
+        }
+
+        size_t need   = align( kHeaderSize + len );
+        size_t head   = _head.load( std::memory_order_relaxed );
+        size_t pos    = head & _mask;
+        size_t tail   = _cached_tail;
+        size_t remain = _capacity - pos;
+        size_t total  = need > remain ? remain + need : need;
+
+        if ( _capacity - ( head - tail ) < total ) {
+            tail         = _tail.load( std::memory_order_acquire );
+            _cached_tail = tail;
+            if ( _capacity - ( head - tail ) < total ) {
+                return nullptr;
+            }
+        }
+
+        if ( need > remain ) {
+            store_header( pos, kWrapMarker );
+            head += remain;
+            pos   = 0;
+        }
+
+        _pending_head = head + need;
+        _pending_pos  = pos;
+        _pending_len  = len;
+        return _data.get() + pos + kHeaderSize;
+    }
+
+    /**
+     * @brief 生产者：发布最近一次 reserve() 的记录
+     */
+    void commit() noexcept {
+        store_header( _pending_pos, _pending_len );
+        _head.store( _pending_head, std::memory_order_release );
+    }
+
+    /**
+     * @brief 消费者：获取队首记录
+     * @param len 输出记录长度
+     * @return 记录地址，队列为空返回 nullptr
+     */
+    const char* front( size_t& len ) noexcept {
+        size_t tail = _tail.load( std::memory_order_relaxed );
+        for ( ;; ) {
+            if ( tail == _cached_head ) {
+                _cached_head = _head.load( std::memory_order_acquire );
+                if ( tail == _cached_head ) {
+                    return nullptr;
+                }
+            }
+
+            size_t   pos    = tail & _mask;
+            uint64_t header = load_header( pos );
+            if ( header == kWrapMarker ) {
+                tail += _capacity - pos;
+                _tail.store( tail, std::memory_order_release );
+                continue;
+            }
+
+            len = static_cast< size_t >( header );
+            return _data.get() + pos + kHeaderSize;
+        }
+    }
+
+    /**
+     * @brief 消费者：弹出队首记录
+     * @param len front() 返回的记录长度
+     */
+    void pop( size_t len ) noexcept {
+        size_t tail = _tail.load( std::memory_order_relaxed );
+        _tail.store( tail + align( kHeaderSize + len ), std::memory_order_release );
+    }
+
+    /**
+     * @brief 判断是否为空（消费者调用）
+     * @return 空返回 true，否则返回 false
+     */
+    bool empty() const noexcept {
+        return _tail.load( std::memory_order_relaxed ) == _head.load( std::memory_order_acquire );
+    }
+
+private:
+    static constexpr size_t   kHeaderSize = 8;           // 记录头部大小
+    static constexpr uint64_t kWrapMarker = UINT64_MAX;  // 回绕标记
+
+    static constexpr size_t align( size_t n ) noexcept { return ( n + 7 ) & ~size_t{ 7 }; }
+
+    static size_t round_up_pow2( size_t n ) noexcept {
+        size_t cap = 4096;
+        while ( cap < n ) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    void store_header( size_t pos, uint64_t header ) noexcept {
+        std::memcpy( _data.get() + pos, &header, sizeof( header ) );
+    }
+
+    uint64_t load_header( size_t pos ) const noexcept {
+        uint64_t header{ 0 };
+        std::memcpy( &header, _data.get() + pos, sizeof( header ) );
+        return header;
+    }
+
+private:
+    const size_t              _capacity;  // 容量（2 的幂）
+    const size_t              _mask;      // 索引掩码
+    std::unique_ptr< char[] > _data;      // 数据区
+
+    alignas( kCacheLineSize ) std::atomic< size_t > _head{ 0 };  // 写位置（生产者）
+    size_t _cached_tail{ 0 };   // 生产者缓存的读位置
+    size_t _pending_head{ 0 };  // 待发布的写位置
+    size_t _pending_pos{ 0 };   // 待发布记录的偏移
+    size_t _pending_len{ 0 };   // 待发布记录的长度
+
+    alignas( kCacheLineSize ) std::atomic< size_t > _tail{ 0 };  // 读位置（消费者）
+    size_t _cached_head{ 0 };  // 消费者缓存的写位置
+};
+
+}  // namespace utils
+}  // namespace jzlog
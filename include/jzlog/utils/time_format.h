@@ -0,0 +1,246 @@
+/**
+ * @file time_format.h
+ * @brief 带缓存的时间戳格式化
+ *
+ * 每个线程缓存当前秒已渲染好的 "YYYY-MM-DD HH:MM:SS" 前缀，以及当前时段的 UTC 偏移。
+ * 同一秒内的记录只需拷贝前缀并写入小数部分；跨秒时由 UTC 偏移算术推导本地日历时间，
+ * 只有跨时段才调用一次 localtime_r，避免每条记录都获取时区锁。
+ *
+ * 时段取 15 分钟而不是 1 小时：部分时区（如 Australia/Lord_Howe）的切换发生在半点。
+ * 运行期修改 TZ 后，新时区在下一个时段才会生效。
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+namespace jzlog
+{
+namespace utils
+{
+
+/**
+ * @enum TimePrecision
+ * @brief 时间戳小数部分精度
+ */
+enum class TimePrecision : int
+{
+    SECONDS = 0,  // YYYY-MM-DD HH:MM:SS
+    MILLIS,       // YYYY-MM-DD HH:MM:SS.mmm
+    MICROS        // YYYY-MM-DD HH:MM:SS.uuuuuu
+};
+
+constexpr size_t  kTimestampPrefixSize = 19;   // "YYYY-MM-DD HH:MM:SS" 的长度
+constexpr size_t  kMaxTimestampSize    = 26;   // 微秒精度时间戳的长度
+constexpr size_t  kUtcOffsetSize       = 6;    // "+HH:MM" 的长度
+constexpr int64_t kUtcOffsetPeriod     = 900;  // UTC 偏移缓存时段（秒）
+
+namespace detail
+{
+
+/**
+ * @brief 向 dst 写入 width 位十进制数（左补零）
+ */
+inline void write_digits( char* dst, uint32_t value, int width ) noexcept {
+    for ( int i = width - 1; i >= 0; --i ) {
+        dst[ i ] = static_cast< char >( '0' + value % 10 );
+        value /= 10;
+    }
+}
+
+/**
+ * @brief 向下取整除法（支持负数）
+ */
+inline int64_t floor_div( int64_t a, int64_t b ) noexcept {
+    int64_t q = a / b;
+    return ( a % b != 0 && ( ( a < 0 ) != ( b < 0 ) ) ) ? q - 1 : q;
+}
+
+/**
+ * @brief 由纪元以来的天数计算公历日期（Howard Hinnant 算法）
+ */
+inline void civil_from_days( int64_t days, int& year, unsigned& month, unsigned& day ) noexcept {
+    days += 719468;
+    const int64_t  era = floor_div( days, 146097 );
+    const unsigned doe = static_cast< unsigned >( days - era * 146097 );
+    const unsigned yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+    const unsigned doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+    const unsigned mp  = ( 5 * doy + 2 ) / 153;
+    day                = doy - ( 153 * mp + 2 ) / 5 + 1;
+    month              = mp < 10 ? mp + 3 : mp - 9;
+    year               = static_cast< int >( yoe + era * 400 + ( month <= 2 ) );
+}
+
+/**
+ * @brief 由公历日期计算纪元以来的天数
+ */
+inline int64_t days_from_civil( int year, unsigned month, unsigned day ) noexcept {
+    year -= month <= 2;
+    const int64_t  era = floor_div( year, 400 );
+    const unsigned yoe = static_cast< unsigned >( year - era * 400 );
+    const unsigned doy = ( 153 * ( month > 2 ? month - 3 : month + 9 ) + 2 ) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast< int64_t >( doe ) - 719468;
+}
+
+/**
+ * @struct TimestampCache
+ * @brief 线程局部的时间戳缓存
+ */
+struct TimestampCache {
+    int64_t _second{ INT64_MIN };               // 已缓存前缀对应的 UTC 秒
+    int64_t _period{ INT64_MIN };               // 已缓存偏移对应的 UTC 时段
+    int32_t _offset{ 0 };                       // UTC 偏移（秒）
+    char    _prefix[ kTimestampPrefixSize ]{};  // 已渲染的 "YYYY-MM-DD HH:MM:SS"
+
+    /**
+     * @brief 获取 UTC 偏移，每个时段调用一次 localtime_r
+     * @param second UTC 秒
+     * @return UTC 偏移（秒）
+     */
+    int32_t offset( int64_t second ) noexcept {
+        int64_t period = floor_div( second, kUtcOffsetPeriod );
+        if ( period != _period ) {
+            std::time_t time = static_cast< std::time_t >( second );
+            std::tm     tm_buf{};
+#ifdef _WIN32
+            localtime_s( &tm_buf, &time );
+#else
+            localtime_r( &time, &tm_buf );
+#endif
+            int64_t local = days_from_civil( tm_buf.tm_year + 1900, tm_buf.tm_mon + 1,
+                                             tm_buf.tm_mday ) *
+                                86400 +
+                            tm_buf.tm_hour * 3600 + tm_buf.tm_min * 60 + tm_buf.tm_sec;
+            _offset = static_cast< int32_t >( local - second );
+            _period = period;
+        }
+        return _offset;
+    }
+
+    /**
+     * @brief 获取 second 对应的已渲染前缀，跨秒时重新渲染
+     * @param second UTC 秒
+     * @return 前缀地址（kTimestampPrefixSize 字节）
+     */
+    const char* prefix( int64_t second ) noexcept {
+        if ( second != _second ) {
+            int64_t local = second + offset( second );
+            int64_t days  = floor_div( local, 86400 );
+            auto    sod   = static_cast< uint32_t >( local - days * 86400 );
+
+            int      year{ 0 };
+            unsigned month{ 0 };
+            unsigned day{ 0 };
+            civil_from_days( days, year, month, day );
+
+            write_digits( _prefix, static_cast< uint32_t >( year ), 4 );
+            _prefix[ 4 ] = '-';
+            write_digits( _prefix + 5, month, 2 );
+            _prefix[ 7 ] = '-';
+            write_digits( _prefix + 8, day, 2 );
+            _prefix[ 10 ] = ' ';
+            write_digits( _prefix + 11, sod / 3600, 2 );
+            _prefix[ 13 ] = ':';
+            write_digits( _prefix + 14, sod / 60 % 60, 2 );
+            _prefix[ 16 ] = ':';
+            write_digits( _prefix + 17, sod % 60, 2 );
+            _second = second;
+        }
+        return _prefix;
+    }
+};
+
+/**
+ * @brief 获取调用线程的时间戳缓存
+ */
+inline TimestampCache& timestamp_cache() noexcept {
+    thread_local TimestampCache cache;
+    return cache;
+}
+
+/**
+ * @brief 拆分时间点为 UTC 秒和秒内微秒
+ */
+inline void split( std::chrono::system_clock::time_point tp, int64_t& second,
+                   uint32_t& micros ) noexcept {
+    int64_t us =
+        std::chrono::duration_cast< std::chrono::microseconds >( tp.time_since_epoch() ).count();
+    second = floor_div( us, 1000000 );
+    micros = static_cast< uint32_t >( us - second * 1000000 );
+}
+
+}  // namespace detail
+
+/**
+ * @brief 获取时间戳的字符长度
+ * @param precision 精度
+ * @return 字符长度
+ */
+constexpr size_t timestamp_size( TimePrecision precision ) noexcept {
+    return precision == TimePrecision::MICROS   ? kTimestampPrefixSize + 7
+           : precision == TimePrecision::MILLIS ? kTimestampPrefixSize + 4
+                                                : kTimestampPrefixSize;
+}
+
+/**
+ * @brief 将时间点格式化为本地时间 "YYYY-MM-DD HH:MM:SS[.mmm|.uuuuuu]"
+ * @param tp 时间点
+ * @param precision 小数部分精度
+ * @param dst 目标地址，至少 timestamp_size( precision ) 字节，不写入结尾 '\0'
+ * @return 写入的字节数
+ */
+inline size_t format_timestamp( std::chrono::system_clock::time_point tp, TimePrecision precision,
+                                char* dst ) noexcept {
+    int64_t  second{ 0 };
+    uint32_t micros{ 0 };
+    detail::split( tp, second, micros );
+
+    std::memcpy( dst, detail::timestamp_cache().prefix( second ), kTimestampPrefixSize );
+    switch ( precision ) {
+    case ( TimePrecision::MILLIS ):
+        dst[ kTimestampPrefixSize ] = '.';
+        detail::write_digits( dst + kTimestampPrefixSize + 1, micros / 1000, 3 );
+        break;
+    case ( TimePrecision::MICROS ):
+        dst[ kTimestampPrefixSize ] = '.';
+        detail::write_digits( dst + kTimestampPrefixSize + 1, micros, 6 );
+        break;
+    default:
+        break;
+    }
+    return timestamp_size( precision );
+}
+
+/**
+ * @brief 获取时间点所在时区的 UTC 偏移（按时段缓存）
+ * @param tp 时间点
+ * @return UTC 偏移（秒）
+ */
+inline int32_t utc_offset( std::chrono::system_clock::time_point tp ) noexcept {
+    int64_t  second{ 0 };
+    uint32_t micros{ 0 };
+    detail::split( tp, second, micros );
+    return detail::timestamp_cache().offset( second );
+}
+
+/**
+ * @brief 将 UTC 偏移格式化为 "+HH:MM"
+ * @param offset UTC 偏移（秒）
+ * @param dst 目标地址，至少 kUtcOffsetSize 字节，不写入结尾 '\0'
+ * @return 写入的字节数
+ */
+inline size_t format_utc_offset( int32_t offset, char* dst ) noexcept {
+    dst[ 0 ]         = offset < 0 ? '-' : '+';
+    uint32_t minutes = static_cast< uint32_t >( offset < 0 ? -offset : offset ) / 60;
+    detail::write_digits( dst + 1, minutes / 60, 2 );
+    dst[ 3 ] = ':';
+    detail::write_digits( dst + 4, minutes % 60, 2 );
+    return kUtcOffsetSize;
+}
+
+}  // namespace utils
+}  // namespace jzlog
@@ -0,0 +1,176 @@
+#include "jzlog/core/log_backend.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace jzlog
+{
+
+namespace
+{
+constexpr size_t   kMaxBatchPerRing = 1024;  // 每轮从单个环形缓冲区取出的最大记录数
+constexpr uint32_t kIdleWaitMs      = 10;    // 空闲时的最长等待时间（毫秒）
+
+std::atomic< uint64_t > g_next_backend_id{ 1 };  // 后台实例 ID 生成器
+
+/**
+ * @struct ThreadRings
+ * @brief 线程局部的环形缓冲区表，线程退出时标记其所有环形缓冲区为已关闭
+ */
+struct ThreadRings {
+    std::vector< std::pair< uint64_t, CLogBackend::RingPtr > > _rings;  // 后台 ID -> 环形缓冲区
+    uint64_t                   _last_id{ 0 };     // 最近使用的后台 ID
+    CLogBackend::ProducerRing* _last{ nullptr };  // 最近使用的环形缓冲区
+
+    ~ThreadRings() {
+        for ( auto& entry : _rings ) {
+            entry.second->_closed.store( true, std::memory_order_release );
+        }
+    }
+};
+
+thread_local ThreadRings t_rings;
+}  // anonymous namespace
+
+CLogBackend::CLogBackend( const LoggerConfig& config, Handler handler ) noexcept :
+    _id( g_next_backend_id.fetch_add( 1 ) ),
+    _ring_size( config.ring_size ),
+    _overflow_policy( config.overflow_policy ),
+    _handler( std::move( handler ) ),
+    _rings(),
+    _snapshot(),
+    _rings_changed( false ),
+    _sleeping( false ),
+    _dropped( 0 ),
+    _running( true ) {
+    _thread = std::thread( &CLogBackend::work_thread, this );
+}
+
+CLogBackend::ProducerRing* CLogBackend::local_ring() noexcept {
+    auto& local = t_rings;
+    if ( local._last_id == _id ) {
+        return local._last;
+    }
+
+    for ( auto& entry : local._rings ) {
+        if ( entry.first == _id ) {
+            local._last_id = _id;
+            local._last    = entry.second.get();
+            return local._last;
+        }
+    }
+
+    try {
+        local._rings.erase( std::remove_if( local._rings.begin(), local._rings.end(),
+                                            []( const auto& entry ) {
+                                                return entry.second->_orphaned.load();
+                                            } ),
+                            local._rings.end() );
+
+        auto ring = std::make_shared< ProducerRing >( _ring_size );
+        {
+            std::lock_guard lock{ _rings_mutex };
+            _rings.push_back( ring );
+            _rings_changed.store( true, std::memory_order_release );
+        }
+        local._rings.emplace_back( _id, ring );
+        local._last_id = _id;
+        local._last    = ring.get();
+        return local._last;
+    } catch ( ... ) {
+        return nullptr;
+    }
+}
+
+void CLogBackend::wake() noexcept {
+    {
+        std::lock_guard lock{ _wait_mutex };
+    }
+    _cond.notify_one();
+}
+
+size_t CLogBackend::drain() noexcept {
+    if ( _rings_changed.exchange( false, std::memory_order_acq_rel ) ) {
+        std::lock_guard lock{ _rings_mutex };
+        _snapshot = _rings;
+    }
+
+    size_t count   = 0;
+    bool   reclaim = false;
+    for ( auto& slot : _snapshot ) {
+        size_t len = 0;
+        size_t n   = 0;
+        while ( n < kMaxBatchPerRing ) {
+            const char* data = slot->_ring.front( len );
+            if ( data == nullptr ) {
+                break;
+            }
+            try {
+                _handler( data, len );
+            } catch ( ... ) {}
+            slot->_ring.pop( len );
+            ++n;
+        }
+        count += n;
+
+        if ( slot->_closed.load( std::memory_order_acquire ) && slot->_ring.empty() ) {
+            reclaim = true;
+        }
+    }
+
+    if ( reclaim ) {
+        std::lock_guard lock{ _rings_mutex };
+        _rings.erase( std::remove_if( _rings.begin(), _rings.end(),
+                                      []( const RingPtr& slot ) {
+                                          return slot->_closed.load( std::memory_order_acquire ) &&
+                                                 slot->_ring.empty();
+                                      } ),
+                      _rings.end() );
+        _snapshot = _rings;
+    }
+    return count;
+}
+
+void CLogBackend::work_thread() noexcept {
+    while ( _running.load( std::memory_order_relaxed ) ) {
+        if ( drain() > 0 ) {
+            continue;
+        }
+
+        std::unique_lock lock{ _wait_mutex };
+        _sleeping.store( true );
+        bool pending = std::any_of( _snapshot.begin(), _snapshot.end(), []( const RingPtr& slot ) {
+            return !slot->_ring.empty();
+        } );
+        if ( !pending && _running.load( std::memory_order_relaxed ) ) {
+            _cond.wait_for( lock, std::chrono::milliseconds( kIdleWaitMs ) );
+        }
+        _sleeping.store( false );
+    }
+
+    while ( drain() > 0 ) {}
+}
+
+void CLogBackend::stop() noexcept {
+    if ( _running.exchange( false ) ) {
+        wake();
+        if ( _thread.joinable() ) {
+            _thread.join();
+        }
+
+        std::lock_guard lock{ _rings_mutex };
+        for ( auto& slot : _rings ) {
+            slot->_orphaned.store( true );
+        }
+    }
+}
+
+CLogBackend::~CLogBackend() { stop(); }
+
+}  // namespace jzlog
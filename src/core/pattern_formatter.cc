@@ -0,0 +1,142 @@
+#include "jzlog/core/pattern_formatter.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace jzlog
+{
+
+namespace
+{
+// 秒级前缀 "YYYY-MM-DD HH:MM:SS" 中各字段的位置
+constexpr uint32_t kYearOffset   = 0;
+constexpr uint32_t kMonthOffset  = 5;
+constexpr uint32_t kDayOffset    = 8;
+constexpr uint32_t kHourOffset   = 11;
+constexpr uint32_t kMinuteOffset = 14;
+constexpr uint32_t kSecondOffset = 17;
+
+constexpr std::string_view kPrefixLayout{ "YYYY-MM-DD HH:MM:SS" };  // 前缀中分隔符的位置
+}  // anonymous namespace
+
+CPatternFormatter::CPatternFormatter( std::string_view pattern ) { set_pattern( pattern ); }
+
+void CPatternFormatter::set_pattern( std::string_view pattern ) {
+    _pattern.assign( pattern.data(), pattern.size() );
+    _literals.clear();
+    _steps.clear();
+    _needs_time = false;
+
+    for ( size_t i = 0; i < pattern.size(); ++i ) {
+        char c = pattern[ i ];
+        if ( c != '%' || i + 1 == pattern.size() ) {
+            add_literal( &pattern[ i ], 1 );
+            continue;
+        }
+
+        char flag = pattern[ ++i ];
+        switch ( flag ) {
+        case 'Y':
+            add_datetime( kYearOffset, 4 );
+            break;
+        case 'm':
+            add_datetime( kMonthOffset, 2 );
+            break;
+        case 'd':
+            add_datetime( kDayOffset, 2 );
+            break;
+        case 'H':
+            add_datetime( kHourOffset, 2 );
+            break;
+        case 'M':
+            add_datetime( kMinuteOffset, 2 );
+            break;
+        case 'S':
+            add_datetime( kSecondOffset, 2 );
+            break;
+        case 'e':
+            _steps.push_back( { StepType::MILLIS, 0, 0 } );
+            _needs_time = true;
+            break;
+        case 'f':
+            _steps.push_back( { StepType::MICROS, 0, 0 } );
+            _needs_time = true;
+            break;
+        case 'z':
+            _steps.push_back( { StepType::UTC_OFFSET, 0, 0 } );
+            _needs_time = true;
+            break;
+        case 'l':
+            _steps.push_back( { StepType::LEVEL, 0, 0 } );
+            break;
+        case 't':
+            _steps.push_back( { StepType::THREAD, 0, 0 } );
+            break;
+        case 'v':
+            _steps.push_back( { StepType::MESSAGE, 0, 0 } );
+            break;
+        case 's':
+            _steps.push_back( { StepType::FILE_NAME, 0, 0 } );
+            break;
+        case 'g':
+            _steps.push_back( { StepType::FILE_PATH, 0, 0 } );
+            break;
+        case '!':
+            _steps.push_back( { StepType::FUNCTION, 0, 0 } );
+            break;
+        case '#':
+            _steps.push_back( { StepType::LINE, 0, 0 } );
+            break;
+        case 'n':
+            add_literal( "\n", 1 );
+            break;
+        case '%':
+            add_literal( "%", 1 );
+            break;
+        default:
+            add_literal( &pattern[ i - 1 ], 2 );
+            break;
+        }
+    }
+}
+
+void CPatternFormatter::add_literal( const char* data, size_t len ) {
+    // 紧跟日期时间切片、且与前缀中分隔符相同的字符并入切片，
+    // 使 "%Y-%m-%d %H:%M:%S" 编译为一次 19 字节的拷贝
+    while ( len > 0 && !_steps.empty() && _steps.back()._type == StepType::DATETIME ) {
+        Step&    last = _steps.back();
+        uint32_t end  = last._offset + last._length;
+        if ( end >= kPrefixLayout.size() || kPrefixLayout[ end ] != *data ||
+             ( *data >= 'A' && *data <= 'Z' ) ) {
+            break;
+        }
+        ++last._length;
+        ++data;
+        --len;
+    }
+    if ( len == 0 ) {
+        return;
+    }
+
+    if ( !_steps.empty() && _steps.back()._type == StepType::LITERAL &&
+         _steps.back()._offset + _steps.back()._length == _literals.size() ) {
+        _steps.back()._length += static_cast< uint32_t >( len );
+    } else {
+        _steps.push_back( { StepType::LITERAL, static_cast< uint32_t >( _literals.size() ),
+                            static_cast< uint32_t >( len ) } );
+    }
+    _literals.append( data, len );
+}
+
+void CPatternFormatter::add_datetime( uint32_t offset, uint32_t length ) {
+    _needs_time = true;
+    if ( !_steps.empty() && _steps.back()._type == StepType::DATETIME &&
+         _steps.back()._offset + _steps.back()._length == offset ) {
+        _steps.back()._length += length;
+        return;
+    }
+    _steps.push_back( { StepType::DATETIME, offset, length } );
+}
+
+}  // namespace jzlog
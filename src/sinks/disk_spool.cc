@@ -0,0 +1,361 @@
+#include "jzlog/sinks/disk_spool.h"
+#include "jzlog/utils/fd_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+namespace
+{
+constexpr uint32_t kSpoolMagic      = 0x4a5a5350;  // "JZSP"
+constexpr char     kCursorName[]    = "cursor";     // 读取位置文件名
+constexpr char     kSegmentPrefix[] = "spool_";     // 分段文件名前缀
+constexpr char     kSegmentSuffix[] = ".seg";       // 分段文件名后缀
+
+/**
+ * @struct SpoolHeader
+ * @brief 批次记录头
+ */
+struct SpoolHeader {
+    uint32_t _magic;     // 魔数
+    uint32_t _length;    // 载荷长度
+    uint32_t _records;   // 记录数
+    uint32_t _reserved;  // 保留，写 0
+};
+static_assert( sizeof( SpoolHeader ) == 16, "spool header must be 16 bytes" );
+
+/**
+ * @struct SpoolCursor
+ * @brief cursor 文件内容
+ */
+struct SpoolCursor {
+    uint64_t _id;      // 头分段编号
+    uint64_t _offset;  // 头分段中的读取偏移
+};
+
+bool read_fully( int fd, void* data, size_t len, uint64_t offset ) noexcept {
+    auto* out = static_cast< char* >( data );
+    while ( len > 0 ) {
+        ssize_t n = ::pread( fd, out, len, static_cast< off_t >( offset ) );
+        if ( n < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( n <= 0 ) {
+            return false;
+        }
+        out += n;
+        len -= static_cast< size_t >( n );
+        offset += static_cast< uint64_t >( n );
+    }
+    return true;
+}
+
+bool parse_segment_id( const std::string& name, uint64_t& id ) noexcept {
+    size_t prefix = sizeof( kSegmentPrefix ) - 1;
+    size_t suffix = sizeof( kSegmentSuffix ) - 1;
+    if ( name.size() <= prefix + suffix || name.compare( 0, prefix, kSegmentPrefix ) != 0 ||
+         name.compare( name.size() - suffix, suffix, kSegmentSuffix ) != 0 ) {
+        return false;
+    }
+    id = 0;
+    for ( size_t i = prefix; i < name.size() - suffix; ++i ) {
+        if ( name[ i ] < '0' || name[ i ] > '9' ) {
+            return false;
+        }
+        id = id * 10 + static_cast< uint64_t >( name[ i ] - '0' );
+    }
+    return true;
+}
+}  // anonymous namespace
+
+CDiskSpool::CDiskSpool( std::string dir, size_t max_bytes, size_t segment_bytes ) noexcept :
+    _dir( std::move( dir ) ),
+    _max_bytes( max_bytes ),
+    _segment_bytes( std::max< uint64_t >( segment_bytes, sizeof( SpoolHeader ) ) ),
+    _segments(),
+    _tail_fd( -1 ),
+    _head_fd( -1 ),
+    _head_offset( 0 ),
+    _front_size( 0 ),
+    _bytes( 0 ),
+    _cursor_fd( -1 ),
+    _iov() {
+    std::error_code ec;
+    std::filesystem::create_directories( _dir, ec );
+
+    std::string cursor_path = _dir + "/" + kCursorName;
+    _cursor_fd              = ::open( cursor_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+    if ( _cursor_fd < 0 ) {
+        std::cerr << "failed to open spool cursor: " << strerror( errno ) << std::endl;
+        return;
+    }
+    recover();
+}
+
+CDiskSpool::~CDiskSpool() {
+    for ( int fd : { _tail_fd, _head_fd, _cursor_fd } ) {
+        if ( fd >= 0 ) {
+            ::close( fd );
+        }
+    }
+}
+
+void CDiskSpool::recover() noexcept {
+    std::vector< uint64_t > ids;
+    std::error_code         ec;
+    for ( const auto& entry : std::filesystem::directory_iterator( _dir, ec ) ) {
+        uint64_t id = 0;
+        if ( parse_segment_id( entry.path().filename().string(), id ) ) {
+            try {
+                ids.push_back( id );
+            } catch ( ... ) {}
+        }
+    }
+    std::sort( ids.begin(), ids.end() );
+
+    SpoolCursor cursor{ 0, 0 };
+    bool        has_cursor = read_fully( _cursor_fd, &cursor, sizeof( cursor ), 0 );
+
+    for ( uint64_t id : ids ) {
+        std::string path = segment_path( id );
+        // 读取位置之前的分段已经发送完毕，只是来不及删除
+        if ( has_cursor && id < cursor._id ) {
+            ::unlink( path.c_str() );
+            continue;
+        }
+        struct stat st;
+        if ( ::stat( path.c_str(), &st ) != 0 ) {
+            continue;
+        }
+        try {
+            _segments.push_back( Segment{ id, static_cast< uint64_t >( st.st_size ) } );
+        } catch ( ... ) {}
+    }
+
+    if ( !_segments.empty() && has_cursor && _segments.front()._id == cursor._id ) {
+        _head_offset = std::min( cursor._offset, _segments.front()._size );
+    }
+
+    uint64_t next_id = has_cursor ? cursor._id : 0;
+    if ( !_segments.empty() ) {
+        // 尾分段重新以追加方式打开，截掉末尾残缺的批次
+        Segment&    tail = _segments.back();
+        std::string path = segment_path( tail._id );
+        _tail_fd         = ::open( path.c_str(), O_RDWR | O_APPEND | O_CLOEXEC );
+        if ( _tail_fd >= 0 ) {
+            uint64_t start = _segments.size() == 1 ? _head_offset : 0;
+            uint64_t end   = valid_end( _tail_fd, start, tail._size );
+            if ( end != tail._size && ::ftruncate( _tail_fd, static_cast< off_t >( end ) ) == 0 ) {
+                tail._size = end;
+            }
+        }
+        next_id = tail._id + 1;
+    }
+
+    for ( const auto& seg : _segments ) {
+        _bytes += seg._size;
+    }
+    _bytes -= std::min( _bytes, _head_offset );
+
+    if ( _tail_fd < 0 ) {
+        open_tail( next_id );
+    }
+}
+
+uint64_t CDiskSpool::valid_end( int fd, uint64_t offset, uint64_t size ) const noexcept {
+    while ( offset + sizeof( SpoolHeader ) <= size ) {
+        SpoolHeader header;
+        if ( !read_fully( fd, &header, sizeof( header ), offset ) || header._magic != kSpoolMagic ||
+             offset + sizeof( header ) + header._length > size ) {
+            break;
+        }
+        offset += sizeof( header ) + header._length;
+    }
+    return offset;
+}
+
+bool CDiskSpool::open_tail( uint64_t id ) noexcept {
+    std::string path;
+    try {
+        path = segment_path( id );
+        _segments.push_back( Segment{ id, 0 } );
+    } catch ( ... ) {
+        return false;
+    }
+
+    _tail_fd = ::open( path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644 );
+    if ( _tail_fd < 0 ) {
+        std::cerr << "failed to create spool segment: " << strerror( errno ) << std::endl;
+        _segments.pop_back();
+        return false;
+    }
+    return true;
+}
+
+bool CDiskSpool::push( const struct iovec* iov, int count, uint32_t records ) noexcept {
+    if ( _tail_fd < 0 ) {
+        return false;
+    }
+
+    uint64_t length = 0;
+    for ( int i = 0; i < count; ++i ) {
+        length += iov[ i ].iov_len;
+    }
+    uint64_t total = sizeof( SpoolHeader ) + length;
+    if ( length > UINT32_MAX || _bytes + total > _max_bytes ) {
+        return false;
+    }
+
+    if ( _segments.back()._size > 0 && _segments.back()._size + total > _segment_bytes ) {
+        // 头分段仍在读取时保留其只读描述符，尾分段直接关闭
+        ::close( _tail_fd );
+        _tail_fd = -1;
+        if ( !open_tail( _segments.back()._id + 1 ) ) {
+            return false;
+        }
+    }
+
+    SpoolHeader header{ kSpoolMagic, static_cast< uint32_t >( length ), records, 0 };
+    try {
+        _iov.clear();
+        _iov.push_back( { &header, sizeof( header ) } );
+        _iov.insert( _iov.end(), iov, iov + count );
+    } catch ( ... ) {
+        return false;
+    }
+
+    Segment& tail = _segments.back();
+    if ( !utils::write_fully( _tail_fd, _iov.data(), static_cast< int >( _iov.size() ) ) ) {
+        std::cerr << "failed to write spool segment: " << strerror( errno ) << std::endl;
+        // 撤销写了一半的批次，保持分段内记录完整
+        if ( ::ftruncate( _tail_fd, static_cast< off_t >( tail._size ) ) != 0 ) {
+            std::cerr << "failed to truncate spool segment: " << strerror( errno ) << std::endl;
+        }
+        return false;
+    }
+    tail._size += total;
+    _bytes += total;
+    return true;
+}
+
+bool CDiskSpool::front( std::string& payload, uint32_t& records ) noexcept {
+    while ( _bytes > 0 && !_segments.empty() ) {
+        Segment& head = _segments.front();
+        if ( _head_offset + sizeof( SpoolHeader ) > head._size ) {
+            if ( _segments.size() == 1 ) {
+                return false;
+            }
+            advance_head();
+            continue;
+        }
+
+        if ( _head_fd < 0 ) {
+            std::string path = segment_path( head._id );
+            _head_fd         = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+            if ( _head_fd < 0 ) {
+                std::cerr << "failed to open spool segment: " << strerror( errno ) << std::endl;
+                return false;
+            }
+        }
+
+        SpoolHeader header;
+        if ( !read_fully( _head_fd, &header, sizeof( header ), _head_offset ) ||
+             header._magic != kSpoolMagic ||
+             _head_offset + sizeof( header ) + header._length > head._size ) {
+            // 分段损坏时放弃其余部分
+            std::cerr << "corrupt spool segment " << head._id << ", skipping" << std::endl;
+            _bytes -= std::min( _bytes, head._size - _head_offset );
+            _head_offset = head._size;
+            if ( _segments.size() == 1 ) {
+                return false;
+            }
+            advance_head();
+            continue;
+        }
+
+        try {
+            payload.resize( header._length );
+        } catch ( ... ) {
+            return false;
+        }
+        if ( !read_fully( _head_fd, payload.data(), header._length,
+                          _head_offset + sizeof( header ) ) ) {
+            std::cerr << "failed to read spool segment: " << strerror( errno ) << std::endl;
+            return false;
+        }
+        records     = header._records;
+        _front_size = sizeof( header ) + header._length;
+        return true;
+    }
+    return false;
+}
+
+void CDiskSpool::pop() noexcept {
+    if ( _front_size == 0 ) {
+        return;
+    }
+    _head_offset += _front_size;
+    _bytes -= std::min( _bytes, _front_size );
+    _front_size = 0;
+
+    if ( _head_offset >= _segments.front()._size ) {
+        advance_head();
+    }
+    save_cursor();
+}
+
+void CDiskSpool::advance_head() noexcept {
+    if ( _head_fd >= 0 ) {
+        ::close( _head_fd );
+        _head_fd = -1;
+    }
+
+    Segment& head = _segments.front();
+    if ( _segments.size() == 1 ) {
+        // 尾分段已读完：清空后继续追加，避免为每次断线新建分段
+        if ( _tail_fd >= 0 && ::ftruncate( _tail_fd, 0 ) == 0 ) {
+            head._size   = 0;
+            _head_offset = 0;
+        }
+        return;
+    }
+
+    ::unlink( segment_path( head._id ).c_str() );
+    _segments.pop_front();
+    _head_offset = 0;
+    save_cursor();
+}
+
+void CDiskSpool::save_cursor() noexcept {
+    if ( _cursor_fd < 0 || _segments.empty() ) {
+        return;
+    }
+    SpoolCursor cursor{ _segments.front()._id, _head_offset };
+    if ( !utils::pwrite_fully( _cursor_fd, reinterpret_cast< const char* >( &cursor ),
+                               sizeof( cursor ), 0 ) ) {
+        std::cerr << "failed to save spool cursor: " << strerror( errno ) << std::endl;
+    }
+}
+
+std::string CDiskSpool::segment_path( uint64_t id ) const {
+    char name[ 48 ];
+    std::snprintf( name, sizeof( name ), "%s%016" PRIu64 "%s", kSegmentPrefix, id, kSegmentSuffix );
+    return _dir + "/" + name;
+}
+
+}  // namespace sinks
+}  // namespace jzlog
@@ -2,12 +2,20 @@
 #include "jzlog/archive_manager/archive_manager.h"
 #include "jzlog/core/log_level.h"
 #include "jzlog/core/log_record.h"
-#include "jzlog/utils/fixed_buffer.h"
+#include "jzlog/sinks/uring_writer.h"
+#include "jzlog/utils/buffer_pool.h"
+#include "jzlog/utils/fd_writer.h"
+#include "jzlog/utils/reserve_word.h"
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cerrno>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
+#include <fcntl.h>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
@@ -15,11 +23,15 @@
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <system_error>
 #include <thread>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 #include <utility>
 
 namespace jzlog
@@ -38,45 +50,203 @@ std::optional< std::tm > safe_localtime( std::time_t time ) {
 #endif
     return tm_buf;
 }
+
+constexpr int kWriteBatchSize = 64;  // 单次 writev 合并的最大缓冲区数
+
+size_t buffer_size_or_default( uint32_t buf_size ) noexcept {
+    return buf_size == 0 ? DEFAULT_BUFFER_SIZE : static_cast< size_t >( buf_size );
+}
+
+size_t max_queued_buffers( const FileSinkConfig& config, uint32_t buf_size ) noexcept {
+    return std::max< size_t >( 1, config.max_queued_bytes / buffer_size_or_default( buf_size ) );
+}
+
+std::unique_ptr< CUringWriter > make_uring_writer( const FileSinkConfig& config,
+                                                   utils::CBufferPool& pool ) noexcept {
+    if ( config.backend != FileWriteBackend::IO_URING ) {
+        return nullptr;
+    }
+    std::unique_ptr< CUringWriter > writer{ new ( std::nothrow )
+                                                CUringWriter( pool, config.uring_depth ) };
+    if ( !writer || !writer->valid() ) {
+        return nullptr;
+    }
+    return writer;
+}
+
+constexpr int kManifestProbeLimit = 8;  // 清单之后最多探测的文件数，超出时遍历目录
+
+std::string log_file_name( const std::string& date, int idx ) {
+    char buf[ 16 ];
+    std::snprintf( buf, sizeof( buf ), "_%03d", idx );
+    return date + buf;
+}
+
+uint64_t page_align( size_t window ) noexcept {
+    uint64_t page = static_cast< uint64_t >( ::sysconf( _SC_PAGESIZE ) );
+    return ( static_cast< uint64_t >( window ) + page - 1 ) / page * page;
+}
 }  // anonymous namespace
 
+std::chrono::system_clock::time_point next_rotation_time(
+    RotationInterval interval, std::chrono::system_clock::time_point now ) noexcept {
+    auto tm = safe_localtime( std::chrono::system_clock::to_time_t( now ) );
+    if ( !tm.has_value() ) {
+        return now + std::chrono::hours{ 1 };
+    }
+    tm->tm_min = 0;
+    tm->tm_sec = 0;
+    if ( interval == RotationInterval::HOURLY ) {
+        tm->tm_hour += 1;
+    } else {
+        tm->tm_hour = 0;
+        tm->tm_mday += 1;
+    }
+    // 由 mktime 归一化溢出的字段并判断夏令时
+    tm->tm_isdst = -1;
+    return std::chrono::system_clock::from_time_t( std::mktime( &tm.value() ) );
+}
+
 CFileSink::CFileSink() noexcept :
     _level( LogLevel::TRACE ),
     _file_size( DEFAULT_FILE_SIZE ),
     _file_path( DEFAULT_FILE_PATH ),
     _cur_file_name( "" ),
     _cur_file_size( 0 ),
-    _current_buffer( std::make_unique< Buffer >() ),
-    _next_buffer( std::make_unique< Buffer >() ),
+    _writeback_off( 0 ),
+    _dropped_off( 0 ),
+    _buffer_pool( DEFAULT_BUFFER_SIZE, DEFAULT_POOL_SIZE, DEFAULT_POOL_SIZE ),
+    _uring( nullptr ),
+    _slots(),
+    _reserve( 0 ),
+    _generation( 0 ),
+    _next_buffer( _buffer_pool.acquire() ),
     _buffers(),
     _buffer_mutex(),
+    _fd( -1 ),
     _running( false ),
-    _archive_manager( nullptr ) {
+    _archive_manager( nullptr ),
+    _formatter(),
+    _config(),
+    _drain_mutex(),
+    _sync_request( 0 ),
+    _durable_seq( 0 ),
+    _sync_count( 0 ),
+    _write_failed( false ),
+    _sync_failures( 0 ),
+    _durable_mutex(),
+    _durable_cond(),
+    _standby(),
+    _standby_opening( false ),
+    _retired_fds(),
+    _standby_mutex(),
+    _standby_cond(),
+    _max_queued( max_queued_buffers( _config, 0 ) ),
+    _queued( 0 ),
+    _space_cond(),
+    _dropped(),
+    _reported() {
 
     if ( !_file_path.empty() && !std::filesystem::is_directory( _file_path ) ) {
         std::filesystem::create_directories( _file_path );
     }
+    install_buffer( _slots[ 0 ], 0, _buffer_pool.acquire() );
     init_file_idx();
     create_new_file();
     start();
 }
 
 CFileSink::CFileSink( LogLevel lvl, uint32_t fsize, uint32_t buf_size, std::string path,
-                      bool enable ) noexcept {}
+                      bool enable, const FileSinkConfig& config ) noexcept :
+    _level( lvl ),
+    _file_size( fsize ),
+    _file_path( std::move( path ) ),
+    _cur_file_name( "" ),
+    _cur_file_size( 0 ),
+    _writeback_off( 0 ),
+    _dropped_off( 0 ),
+    _buffer_pool( buffer_size_or_default( buf_size ), DEFAULT_POOL_SIZE, DEFAULT_POOL_SIZE ),
+    _uring( make_uring_writer( config, _buffer_pool ) ),
+    _slots(),
+    _reserve( 0 ),
+    _generation( 0 ),
+    _next_buffer( _buffer_pool.acquire() ),
+    _buffers(),
+    _buffer_mutex(),
+    _fd( -1 ),
+    _running( false ),
+    _archive_manager( nullptr ),
+    _formatter(),
+    _config( config ),
+    _drain_mutex(),
+    _sync_request( 0 ),
+    _durable_seq( 0 ),
+    _sync_count( 0 ),
+    _write_failed( false ),
+    _sync_failures( 0 ),
+    _durable_mutex(),
+    _durable_cond(),
+    _standby(),
+    _standby_opening( false ),
+    _retired_fds(),
+    _standby_mutex(),
+    _standby_cond(),
+    _max_queued( max_queued_buffers( config, buf_size ) ),
+    _queued( 0 ),
+    _space_cond(),
+    _dropped(),
+    _reported() {
+    (void)enable;
+
+    if ( !_file_path.empty() && !std::filesystem::is_directory( _file_path ) ) {
+        std::filesystem::create_directories( _file_path );
+    }
+    install_buffer( _slots[ 0 ], 0, _buffer_pool.acquire() );
+    init_file_idx();
+    create_new_file();
+    start();
+}
 
 CFileSink::CFileSink( LogLevel lvl, uint32_t fsize, uint32_t buf_size, bool enable,
-                      const ArchiveConfig& archive_cfg ) noexcept :
+                      const ArchiveConfig& archive_cfg, const FileSinkConfig& config ) noexcept :
     _level( lvl ),
     _file_size( fsize ),
     _file_path( archive_cfg.base_path + "/current" ),
     _cur_file_name( "" ),
     _cur_file_size( 0 ),
-    _current_buffer( std::make_unique< Buffer >() ),
-    _next_buffer( std::make_unique< Buffer >() ),
+    _writeback_off( 0 ),
+    _dropped_off( 0 ),
+    _buffer_pool( buffer_size_or_default( buf_size ), DEFAULT_POOL_SIZE, DEFAULT_POOL_SIZE ),
+    _uring( make_uring_writer( config, _buffer_pool ) ),
+    _slots(),
+    _reserve( 0 ),
+    _generation( 0 ),
+    _next_buffer( _buffer_pool.acquire() ),
     _buffers(),
     _buffer_mutex(),
+    _fd( -1 ),
     _running( false ),
-    _archive_manager( std::make_unique< CArchiveManager >( archive_cfg ) ) {
+    _archive_manager( std::make_unique< CArchiveManager >( archive_cfg ) ),
+    _formatter(),
+    _config( config ),
+    _drain_mutex(),
+    _sync_request( 0 ),
+    _durable_seq( 0 ),
+    _sync_count( 0 ),
+    _write_failed( false ),
+    _sync_failures( 0 ),
+    _durable_mutex(),
+    _durable_cond(),
+    _standby(),
+    _standby_opening( false ),
+    _retired_fds(),
+    _standby_mutex(),
+    _standby_cond(),
+    _max_queued( max_queued_buffers( config, buf_size ) ),
+    _queued( 0 ),
+    _space_cond(),
+    _dropped(),
+    _reported() {
     (void)enable;
 
     if ( !_file_path.empty() && !std::filesystem::is_directory( _file_path ) ) {
@@ -87,6 +257,7 @@ CFileSink::CFileSink( LogLevel lvl, uint32_t fsize, uint32_t buf_size, bool enab
         _archive_manager->start();
     }
 
+    install_buffer( _slots[ 0 ], 0, _buffer_pool.acquire() );
     init_file_idx();
     create_new_file();
     start();
@@ -97,181 +268,911 @@ bool CFileSink::write( const LogRecord& r ) noexcept {
         return false;
     }
 
-    std::string format_record;
+    std::string_view format_record;
     try {
-        format_record = format_log_record( r );
+        format_record = _formatter.format( r );
     } catch ( ... ) {
         return false;
     }
+    return write_formatted( r, format_record );
+}
+
+const CPatternFormatter* CFileSink::formatter() const noexcept { return &_formatter; }
+
+bool CFileSink::write_formatted( const LogRecord& r, std::string_view line ) noexcept {
+    if ( !should_log( r._level ) || r._message.empty() ) {
+        return false;
+    }
+
+    if ( _config.backlog_policy == BacklogPolicy::DROP_LOWEST_LEVEL && shed_level( r._level ) ) {
+        count_drop( r._level );
+        return false;
+    }
+
+    uint64_t seq{ 0 };
+    if ( !append( line, r._level, seq ) ) {
+        return false;
+    }
+
+    if ( _config.durability == DurabilityPolicy::GROUP_COMMIT ) {
+        raise_sync_request( seq );
+    } else if ( _config.durability == DurabilityPolicy::SYNC_ON_LEVEL &&
+                r._level >= _config.sync_level ) {
+        if ( _config.sync_timeout_ms == 0 ) {
+            return wait_durable( seq );
+        }
+        return wait_durable_for( seq, std::chrono::milliseconds{ _config.sync_timeout_ms } );
+    }
+    return true;
+}
+
+bool CFileSink::append( std::string_view line, LogLevel level, uint64_t& seq ) noexcept {
+    size_t len = line.size();
+    if ( len > _buffer_pool.buffer_size() ) {
+        return append_large( line, level, seq );
+    }
+
+    for ( ;; ) {
+        Slot*    slot{ nullptr };
+        uint64_t generation{ 0 };
+        uint64_t word{ 0 };
+        bool     copied = utils::reserve_copy(
+            _reserve, line.data(), len, _buffer_pool.buffer_size(),
+            [ & ]( uint32_t gen ) {
+                // 拷贝提交后槽位可能被复用，代数须在提交前取出
+                slot       = &_slots[ gen & 1 ];
+                generation = slot->_generation;
+                return utils::ReserveTarget{ slot->_raw ? slot->_raw->data() : nullptr,
+                                             slot->_capacity, &slot->_committed };
+            },
+            [ & ]( uint64_t length ) { slot->_raw->set_length( length ); }, word );
+
+        if ( copied ) {
+            seq = ( generation << 32 ) | ( utils::reserve_bytes( word ) + len );
+            return true;
+        }
+        if ( !swap_full_buffer( utils::reserve_generation( word ), level ) ) {
+            return false;
+        }
+    }
+}
+
+bool CFileSink::append_large( std::string_view line, LogLevel level, uint64_t& seq ) noexcept {
+    BufferPtr large{ new ( std::nothrow ) Buffer( line.size() ) };
+    if ( !large ) {
+        return false;
+    }
+    large->append( line.data(), line.size() );
+    size_t weight = backlog_weight( *large );
 
     {
-        std::lock_guard< std::mutex > buffer_lock{ _buffer_mutex };
-        if ( format_record.size() > _current_buffer->avail() ) {
-            auto new_next = std::make_unique< Buffer >();
-            try {
-                _buffers.emplace_back( std::move( _current_buffer ) );
-                _current_buffer = std::move( _next_buffer );
-                _next_buffer    = std::move( new_next );
-            } catch ( ... ) {
+        std::unique_lock< std::mutex > lock{ _buffer_mutex };
+        if ( backlog_full( weight ) ) {
+            if ( _config.backlog_policy == BacklogPolicy::DROP_NEWEST ) {
+                count_drop( level );
+                return false;
+            }
+            auto timeout = std::chrono::milliseconds{ _config.block_timeout_ms };
+            if ( !_space_cond.wait_for( lock, timeout,
+                                        [ this, weight ]() { return !backlog_full( weight ); } ) ) {
+                count_drop( level );
                 return false;
             }
         }
 
-        if ( format_record.size() > _current_buffer->avail() ) {
+        if ( !enqueue_buffer( std::move( large ), weight, seq ) ) {
             return false;
         }
-
-        _current_buffer->append( format_record.c_str(), format_record.size() );
     }
-
     _cond.notify_one();
     return true;
 }
 
+bool CFileSink::enqueue_buffer( BufferPtr buffer, size_t weight, uint64_t& seq ) noexcept {
+    // 新的一代保证序号达到 _generation << 32 时该记录已随换出的缓冲区一并写入
+    if ( !swap_current_buffer() ) {
+        return false;
+    }
+    try {
+        _buffers.emplace_back( std::move( buffer ) );
+    } catch ( ... ) {
+        return false;
+    }
+    _queued += weight;
+    seq = _generation << 32;
+    return true;
+}
+
 bool CFileSink::flush() noexcept {
     BufferVec write_buffers{};
+    uint64_t  seq{ 0 };
+    bool      success = true;
     {
-        std::lock_guard< std::mutex > lock{ _buffer_mutex };
+        std::lock_guard< std::mutex > drain_lock{ _drain_mutex };
+        success = write_pending( write_buffers, seq );
+    }
+    success = drain_uring() && success;
+    if ( !success ) {
+        fail_writes();
+    }
+    return success;
+}
 
-        if ( _current_buffer->length() > 0 ) {
-            _buffers.emplace_back( std::move( _current_buffer ) );
-            _current_buffer.swap( _next_buffer );
-            _next_buffer = std::make_unique< Buffer >();
-        }
+void CFileSink::set_level( LogLevel lvl ) noexcept { _level = lvl; }
 
-        write_buffers.swap( _buffers );
+LogLevel CFileSink::level() const noexcept { return _level; }
+
+bool CFileSink::should_log( LogLevel lvl ) const noexcept { return lvl >= _level; }
+
+void CFileSink::set_pattern( std::string_view pattern ) { _formatter.set_pattern( pattern ); }
+
+FileWriteBackend CFileSink::backend() const noexcept {
+    return _uring ? FileWriteBackend::IO_URING : FileWriteBackend::WRITEV;
+}
+
+uint64_t CFileSink::sequence() const noexcept {
+    std::lock_guard< std::mutex > lock{ _buffer_mutex };
+    uint64_t offset = utils::reserve_bytes( _reserve.load( std::memory_order_acquire ) );
+    return ( _generation << 32 ) | std::min( offset, _slots[ _generation & 1 ]._capacity );
+}
+
+uint64_t CFileSink::durable_sequence() const noexcept { return _durable_seq.load(); }
+
+uint64_t CFileSink::sync_count() const noexcept { return _sync_count.load(); }
+
+bool CFileSink::wait_durable( uint64_t seq ) noexcept {
+    // 先取失败次数再登记请求，之后的 fdatasync 失败都会让本次等待返回
+    std::unique_lock< std::mutex > lock{ _durable_mutex };
+    uint64_t                       failures = _sync_failures;
+    if ( !request_sync( seq ) ) {
+        return false;
     }
+    _durable_cond.wait( lock,
+                        [ this, seq, failures ]() { return durable_settled( seq, failures ); } );
+    return _durable_seq >= seq;
+}
 
-    if ( write_buffers.empty() ) {
-        return true;
+bool CFileSink::wait_durable_for( uint64_t seq, std::chrono::milliseconds timeout ) noexcept {
+    std::unique_lock< std::mutex > lock{ _durable_mutex };
+    uint64_t                       failures = _sync_failures;
+    if ( !request_sync( seq ) ) {
+        return false;
     }
+    _durable_cond.wait_for( lock, timeout, [ this, seq, failures ]() {
+        return durable_settled( seq, failures );
+    } );
+    return _durable_seq >= seq;
+}
 
-    bool all_success =
-        std::all_of( write_buffers.begin(), write_buffers.end(), [ this ]( auto& buffer ) {
-            return flush_buffer_to_file( std::move( buffer ) );
-        } );
-    return all_success;
+bool CFileSink::durable_settled( uint64_t seq, uint64_t failures ) const noexcept {
+    return _durable_seq >= seq || _write_failed || _sync_failures != failures || !_running;
 }
 
-void CFileSink::set_level( LogLevel lvl ) noexcept { _level = lvl; }
+bool CFileSink::sync_pending() const noexcept {
+    return _sync_request > _durable_seq && !_write_failed;
+}
 
-LogLevel CFileSink::level() const noexcept { return _level; }
+void CFileSink::fail_writes() noexcept {
+    {
+        std::lock_guard< std::mutex > lock{ _durable_mutex };
+        _write_failed = true;
+    }
+    _durable_cond.notify_all();
+}
 
-bool CFileSink::should_log( LogLevel lvl ) const noexcept { return lvl >= _level; }
+bool CFileSink::request_sync( uint64_t seq ) noexcept {
+    if ( _config.durability == DurabilityPolicy::NONE ) {
+        return false;
+    }
+    if ( _write_failed ) {
+        return _durable_seq >= seq;
+    }
+    if ( _durable_seq >= seq ) {
+        return true;
+    }
+    raise_sync_request( seq );
+    return true;
+}
+
+void CFileSink::raise_sync_request( uint64_t seq ) noexcept {
+    uint64_t prev = _sync_request.load( std::memory_order_relaxed );
+    while ( prev < seq && !_sync_request.compare_exchange_weak( prev, seq ) ) {}
+
+    // 已有未完成的请求时后台线程不会进入等待；否则它可能正要等待，加锁后再通知才不会丢失唤醒
+    if ( prev <= _durable_seq ) {
+        {
+            std::lock_guard< std::mutex > lock{ _buffer_mutex };
+        }
+        _cond.notify_one();
+    }
+}
 
 void CFileSink::create_new_file() noexcept {
-    auto data_str = get_date_str();
+    LogFile file   = open_log_file();
+    _fd            = file._fd;
+    _cur_file_name = std::move( file._name );
+    _cur_file_size = file._size;
+    _writeback_off = file._size;
+    _dropped_off   = file._size;
+}
 
-    if ( data_str != _cur_date_str ) {
-        _cur_date_str = data_str;
-        _cur_idx      = 0;
+CFileSink::LogFile CFileSink::open_log_file() noexcept {
+    LogFile file;
+    {
+        std::lock_guard< std::mutex > lock{ _standby_mutex };
+        auto                          data_str = get_date_str();
+
+        if ( data_str != _cur_date_str ) {
+            _cur_date_str = data_str;
+            _cur_idx      = 0;
+        } else {
+            ++_cur_idx;
+        }
+
+        try {
+            file._name = log_file_name( _cur_date_str, _cur_idx );
+            file._date = _cur_date_str;
+        } catch ( ... ) {
+            return file;
+        }
+        // 先记录再创建文件，进程在两者之间退出时清单只会超前
+        save_manifest();
+    }
+
+    std::string fullPath = _file_path + "/" + file._name;
+
+    // io_uring 按显式偏移写入，O_APPEND 会使偏移失效
+    int flags = _uring ? O_WRONLY | O_CREAT | O_CLOEXEC : O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC;
+    file._fd  = ::open( fullPath.c_str(), flags, 0644 );
+    if ( file._fd >= 0 ) {
+        struct stat st;
+        file._size = ::fstat( file._fd, &st ) == 0 ? static_cast< uint64_t >( st.st_size ) : 0;
     } else {
-        ++_cur_idx;
+        std::cerr << "failed to create log file: " << strerror( errno ) << std::endl;
+    }
+    return file;
+}
+
+bool CFileSink::take_standby( LogFile& file ) noexcept {
+    auto today = get_date_str();
+    {
+        // 准备线程已分配文件名时等待其打开完成，保证文件名顺序与使用顺序一致
+        std::unique_lock< std::mutex > lock{ _standby_mutex };
+        _standby_cond.wait( lock, [ this ]() { return !_standby_opening; } );
+        // 跨天后备用文件属于前一天，留给准备线程处理
+        if ( _standby._fd < 0 || _standby._date != today ) {
+            return false;
+        }
+        file     = std::move( _standby );
+        _standby = LogFile{};
     }
+    _standby_cond.notify_all();
+    return true;
+}
 
-    std::stringstream ss_file_name;
-    ss_file_name << _cur_date_str << "_" << std::setfill( '0' ) << std::setw( 3 ) << _cur_idx;
-    _cur_file_name       = ss_file_name.str();
+bool CFileSink::refill_standby() noexcept {
+    auto    today = get_date_str();
+    LogFile stale;
+    {
+        std::lock_guard< std::mutex > lock{ _standby_mutex };
+        if ( _standby._fd >= 0 && _standby._date != today ) {
+            stale    = std::move( _standby );
+            _standby = LogFile{};
+        }
+        if ( _standby._fd >= 0 ) {
+            return true;
+        }
+        _standby_opening = true;
+    }
+    discard_file( stale );
 
-    std::string fullPath = _file_path + "/" + _cur_file_name;
+    LogFile file = open_log_file();
+    bool    success = file._fd >= 0;
+    {
+        std::lock_guard< std::mutex > lock{ _standby_mutex };
+        if ( success ) {
+            _standby = std::move( file );
+        }
+        _standby_opening = false;
+    }
+    _standby_cond.notify_all();
+    return success;
+}
 
-    _file_stream.open( fullPath, std::ios::app );
-    if ( _file_stream.is_open() ) {
-        _cur_file_size = _file_stream.tellp();
-    } else {
-        std::cerr << "failed to create log file" << std::endl;
+void CFileSink::retire_fd( int fd ) noexcept {
+    if ( fd < 0 ) {
+        return;
+    }
+    {
+        std::lock_guard< std::mutex > lock{ _standby_mutex };
+        try {
+            _retired_fds.push_back( fd );
+            fd = -1;
+        } catch ( ... ) {}
+    }
+    if ( fd >= 0 ) {
+        close_log_fd( fd );
+        return;
+    }
+    _standby_cond.notify_all();
+}
+
+void CFileSink::discard_file( LogFile& file ) noexcept {
+    if ( file._fd < 0 ) {
+        return;
+    }
+    struct stat st;
+    bool        empty = ::fstat( file._fd, &st ) == 0 && st.st_size == 0;
+    ::close( file._fd );
+    file._fd = -1;
+    if ( empty ) {
+        std::error_code ec;
+        std::filesystem::remove( _file_path + "/" + file._name, ec );
+    }
+}
+
+void CFileSink::manage_page_cache() noexcept {
+    if ( _fd < 0 ) {
+        return;
+    }
+
+#ifdef __linux__
+    // 每满一个窗口发起一次异步写回，脏页以稳定的小批量到达磁盘
+    if ( _config.writeback_window > 0 ) {
+        uint64_t window = page_align( _config.writeback_window );
+        while ( _cur_file_size - _writeback_off >= window ) {
+            if ( ::sync_file_range( _fd, static_cast< off_t >( _writeback_off ),
+                                    static_cast< off_t >( window ),
+                                    SYNC_FILE_RANGE_WRITE ) != 0 ) {
+                std::cerr << "failed to start log writeback: " << strerror( errno ) << std::endl;
+            }
+            _writeback_off += window;
+        }
+    }
+#endif
+
+    if ( _config.drop_cache_window == 0 ) {
+        return;
+    }
+    // 只移出落后写回一个窗口以上的数据，等待的写回通常早已完成；未启用写回时由这里同步写回
+    uint64_t window = page_align( _config.drop_cache_window );
+    uint64_t limit  = _cur_file_size;
+#ifdef __linux__
+    if ( _config.writeback_window > 0 ) {
+        uint64_t lag = page_align( _config.writeback_window );
+        limit        = _writeback_off > lag ? _writeback_off - lag : 0;
+    }
+#endif
+    while ( limit > _dropped_off && limit - _dropped_off >= window ) {
+#ifdef __linux__
+        if ( ::sync_file_range( _fd, static_cast< off_t >( _dropped_off ),
+                                static_cast< off_t >( window ),
+                                SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                                    SYNC_FILE_RANGE_WAIT_AFTER ) != 0 ) {
+            std::cerr << "failed to write back log file: " << strerror( errno ) << std::endl;
+        }
+#else
+        ::fdatasync( _fd );
+#endif
+        int err = ::posix_fadvise( _fd, static_cast< off_t >( _dropped_off ),
+                                   static_cast< off_t >( window ), POSIX_FADV_DONTNEED );
+        if ( err != 0 ) {
+            std::cerr << "failed to drop log pages: " << strerror( err ) << std::endl;
+        }
+        _dropped_off += window;
     }
 }
 
-bool CFileSink::flush_buffer_to_file( BufferPtr buffer_ptr ) noexcept {
+void CFileSink::close_log_fd( int fd ) noexcept {
+    if ( fd < 0 ) {
+        return;
+    }
+    if ( _config.drop_cache_window > 0 ) {
+        // 关闭前整体写回并移出，滚动后的旧文件不再占用页缓存
+        if ( ::fdatasync( fd ) != 0 ) {
+            std::cerr << "failed to sync log file: " << strerror( errno ) << std::endl;
+        }
+        ::posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+    }
+    ::close( fd );
+}
+
+bool CFileSink::size_rotation() const noexcept { return _config.rotation != RotationPolicy::TIME; }
+
+bool CFileSink::flush_buffers_to_file( BufferVec& buffers ) noexcept {
+    if ( _uring ) {
+        std::lock_guard< std::mutex > file_lock{ _file_mutex };
+        submit_buffers_to_uring( buffers );
+        return true;
+    }
+
+    bool all_success = true;
+    {
+        std::lock_guard< std::mutex > file_lock{ _file_mutex };
+
+        std::array< struct iovec, kWriteBatchSize > iov;
+        int                                         count   = 0;
+        size_t                                      pending = 0;
+
+        auto submit = [ & ]() {
+            if ( count == 0 ) {
+                return;
+            }
+            if ( !utils::write_fully( _fd, iov.data(), count ) ) {
+                std::cerr << "failed to write log file: " << strerror( errno ) << std::endl;
+                all_success = false;
+            }
+            _cur_file_size += pending;
+            count   = 0;
+            pending = 0;
+        };
+
+        for ( auto& buffer : buffers ) {
+            if ( !buffer || buffer->length() == 0 ) {
+                continue;
+            }
+
+            size_t len = buffer->length();
+            if ( size_rotation() && _cur_file_size + pending > 0 &&
+                 _cur_file_size + pending + len > _file_size ) {
+                submit();
+                rotate_file_();
+            }
+            if ( count == kWriteBatchSize ) {
+                submit();
+            }
+
+            iov[ count ].iov_base = const_cast< char* >( buffer->data() );
+            iov[ count ].iov_len  = len;
+            ++count;
+            pending += len;
+        }
+        submit();
+        manage_page_cache();
+    }
+
+    for ( auto& buffer : buffers ) {
+        _buffer_pool.release( std::move( buffer ) );
+    }
+    buffers.clear();
+    return all_success;
+}
+
+void CFileSink::submit_buffers_to_uring( BufferVec& buffers ) noexcept {
+    _uring->reap();
+    for ( auto& buffer : buffers ) {
+        if ( !buffer || buffer->length() == 0 ) {
+            _buffer_pool.release( std::move( buffer ) );
+            continue;
+        }
+
+        size_t len = buffer->length();
+        if ( size_rotation() && _cur_file_size > 0 && _cur_file_size + len > _file_size ) {
+            rotate_file_();
+        }
+        _uring->write( _fd, _cur_file_size, std::move( buffer ) );
+        _cur_file_size += len;
+    }
+    _uring->reap();
+    buffers.clear();
+    manage_page_cache();
+}
+
+bool CFileSink::drain_uring() noexcept {
+    if ( !_uring ) {
+        return true;
+    }
     std::lock_guard< std::mutex > file_lock{ _file_mutex };
+    return _uring->drain();
+}
+
+bool CFileSink::swap_full_buffer( uint32_t generation, LogLevel level ) noexcept {
+    // 代数取自预留字（模 256），不同则已被其他线程换出
+    auto swapped = [ this, generation ]() {
+        return ( _generation & utils::kReserveGenMask ) != generation;
+    };
+    bool success = true;
+    {
+        std::unique_lock< std::mutex > lock{ _buffer_mutex };
+        if ( swapped() ) {
+            return true;
+        }
+
+        if ( backlog_full( 1 ) ) {
+            // 积压已满：后台线程已有待写入的缓冲区，无需再唤醒
+            if ( _config.backlog_policy == BacklogPolicy::DROP_NEWEST ) {
+                count_drop( level );
+                return false;
+            }
+            auto timeout = std::chrono::milliseconds{ _config.block_timeout_ms };
+            bool ready   = _space_cond.wait_for( lock, timeout, [ this, &swapped ]() {
+                return swapped() || _queued < _max_queued || !_running;
+            } );
+            if ( !ready ) {
+                count_drop( level );
+                return false;
+            }
+            if ( swapped() ) {
+                return true;
+            }
+        }
+        success = swap_current_buffer();
+    }
+    if ( success ) {
+        _cond.notify_one();
+    }
+    return success;
+}
 
-    if ( _cur_file_size + buffer_ptr->length() > _file_size ) {
+bool CFileSink::swap_current_buffer() noexcept {
+    // 下一代复用上上代的槽位，须等待其中的拷贝全部结束；通常早已结束
+    uint64_t next_generation = _generation + 1;
+    Slot&    next            = _slots[ next_generation & 1 ];
+    utils::wait_reserve_commits( next._committed, next._expected.load() );
 
-        rotate_file_();
+    BufferPtr fresh = _next_buffer ? std::move( _next_buffer ) : _buffer_pool.acquire();
+    if ( !fresh ) {
+        return false;
+    }
+    try {
+        _buffers.reserve( _buffers.size() + 1 );
+    } catch ( ... ) {
+        _next_buffer = std::move( fresh );
+        return false;
+    }
+
+    install_buffer( next, next_generation, std::move( fresh ) );
+    uint64_t word = _reserve.exchange( utils::make_reserve_word( next_generation ),
+                                       std::memory_order_acq_rel );
+
+    // 旧缓冲区上可能仍有在途拷贝，由后台线程在写入前等待提交数追上 expected，之后才清空槽位
+    Slot& old = _slots[ _generation & 1 ];
+    old._expected.store( utils::reserve_writers( word ), std::memory_order_release );
+    if ( old._buffer ) {
+        // 没有越过末尾的预留时有效长度即已预留字节数，否则由越过末尾的线程记录
+        uint64_t reserved = utils::reserve_bytes( word );
+        if ( reserved <= old._capacity ) {
+            old._buffer->set_length( reserved );
+        }
+        _buffers.emplace_back( std::move( old._buffer ) );
+        ++_queued;
     }
 
-    _file_stream.write( buffer_ptr->data(), buffer_ptr->length() );
-    _cur_file_size += buffer_ptr->length();
-    _file_stream.flush();
+    _generation  = next_generation;
+    _next_buffer = _buffer_pool.acquire();
+    return true;
+}
 
-    return _file_stream.good();
+void CFileSink::install_buffer( Slot& slot, uint64_t generation, BufferPtr buffer ) noexcept {
+    slot._raw        = buffer.get();
+    slot._capacity   = buffer ? buffer->capacity() : 0;
+    slot._generation = generation;
+    slot._committed.store( 0, std::memory_order_relaxed );
+    slot._expected.store( 0, std::memory_order_relaxed );
+    slot._buffer = std::move( buffer );
 }
 
 void CFileSink::rotate_file_() {
-    if ( _file_stream.is_open() ) {
-        _file_stream.flush();
-        _file_stream.close();
+    // 旧文件的在途写入完成后才能关闭；启用持久化时关闭前先落盘，已持久化序号才能覆盖旧文件
+    // 旧文件关闭后无法再重试，写入或落盘失败的数据按写入失败处理
+    if ( _uring && !_uring->drain() ) {
+        fail_writes();
+    }
+    if ( _fd >= 0 && _config.durability != DurabilityPolicy::NONE ) {
+        if ( ::fdatasync( _fd ) != 0 ) {
+            std::cerr << "failed to sync log file: " << strerror( errno ) << std::endl;
+            fail_writes();
+        }
+        ++_sync_count;
     }
 
-    create_new_file();
+    // 备用文件未就绪（刚滚动过或跨天）时才在当前线程同步打开
+    LogFile next;
+    if ( !take_standby( next ) ) {
+        next = open_log_file();
+    }
+    retire_fd( _fd );
+    _fd            = next._fd;
+    _cur_file_name = std::move( next._name );
+    _cur_file_size = next._size;
+    _writeback_off = next._size;
+    _dropped_off   = next._size;
 }
 
-std::string CFileSink::format_log_record( const LogRecord& r ) {
-    std::stringstream ss;
+void CFileSink::rotate_on_time() noexcept {
+    refill_standby();
 
-    auto time = std::chrono::system_clock::to_time_t( r._timestamp );
-    auto tm   = safe_localtime( time );  // 线程安全
-    if ( !tm.has_value() ) {
-        return "";
+    // 边界之前到达的记录写入旧文件
+    flush();
+
+    auto                          today = get_date_str();
+    std::lock_guard< std::mutex > file_lock{ _file_mutex };
+    // 同一天内当前文件仍为空时无需滚动
+    if ( _cur_file_size == 0 && _cur_file_name.compare( 0, today.size(), today ) == 0 ) {
+        return;
     }
-    ss << std::put_time( &( tm.value() ), "%Y-%m-%d %H:%M:%S" ) << " ["
-       << loglevel::to_string( r._level ) << "] " << "[" << r._thread_id << "]"
-       << "[" << r._function << ":" << r._line << "]" << r._message << "\n";
+    rotate_file_();
+}
 
-    return ss.str();
+void CFileSink::prepare_thread() noexcept {
+    // 只按大小滚动时也在每天零点唤醒一次，替换属于前一天的备用文件
+    const bool timed    = _config.rotation != RotationPolicy::SIZE;
+    const auto interval = timed ? _config.rotation_interval : RotationInterval::DAILY;
+    auto next_rotation  = next_rotation_time( interval, std::chrono::system_clock::now() );
+
+    while ( _running ) {
+        std::vector< int > retired;
+        {
+            std::unique_lock< std::mutex > lock{ _standby_mutex };
+            _standby_cond.wait_until( lock, next_rotation, [ this ]() {
+                return !_running || _standby._fd < 0 || !_retired_fds.empty();
+            } );
+            retired.swap( _retired_fds );
+        }
+
+        for ( int fd : retired ) {
+            close_log_fd( fd );
+        }
+        if ( !_running ) {
+            break;
+        }
+
+        if ( std::chrono::system_clock::now() >= next_rotation ) {
+            if ( timed ) {
+                rotate_on_time();
+            } else {
+                refill_standby();
+            }
+            next_rotation = next_rotation_time( interval, std::chrono::system_clock::now() );
+        }
+
+        if ( !refill_standby() ) {
+            // 打开失败时稍后重试，避免空转
+            std::unique_lock< std::mutex > lock{ _standby_mutex };
+            _standby_cond.wait_for( lock, std::chrono::seconds{ 1 },
+                                    [ this ]() { return !_running; } );
+        }
+    }
 }
 
 void CFileSink::work_thread() noexcept {
-    while ( _running ) {
+    // 与 _buffers 交换后容量在两者之间往返复用
+    auto write_buffers  = BufferVec{};
+    const bool periodic = _config.durability == DurabilityPolicy::PERIODIC;
+    const auto interval = std::chrono::milliseconds{ _config.sync_interval_ms };
+    const auto window   = std::chrono::microseconds{ _config.commit_window_us };
+    auto       timeout  = periodic ? std::min( interval, std::chrono::milliseconds{ 3000 } )
+                                   : std::chrono::milliseconds{ 3000 };
+    auto       next_sync = std::chrono::steady_clock::now() + interval;
 
-        auto write_buffers = BufferVec{};
+    // fdatasync 失败后按指数退避重试，退避期内的持久化请求不唤醒本线程
+    uint32_t retry_backoff = 1;
+    auto     retry_at      = std::chrono::steady_clock::time_point{};
 
+    while ( _running ) {
+        bool requested = false;
         {
             std::unique_lock< std::mutex > lock{ _buffer_mutex };
 
-            _cond.wait_for( lock, std::chrono::seconds{ 3 }, [ this ]() {
-                return !_buffers.empty() || !_running;
+            auto now      = std::chrono::steady_clock::now();
+            bool backoff  = now < retry_at;
+            auto deadline = backoff ? std::min( retry_at, now + timeout ) : now + timeout;
+            _cond.wait_until( lock, deadline, [ this, backoff ]() {
+                return !_buffers.empty() || !_running || ( !backoff && sync_pending() );
             } );
+            requested = sync_pending() && std::chrono::steady_clock::now() >= retry_at;
+        }
 
-            if ( _current_buffer->length() > 0 ) {
-                _buffers.emplace_back( std::move( _current_buffer ) );
-                std::swap( _current_buffer, _next_buffer );
-                _next_buffer = std::make_unique< Buffer >();
-            }
+        // 组提交：等待一个合并窗口，让窗口内到达的持久化请求共用下一次 fdatasync
+        if ( requested && window.count() > 0 ) {
+            std::this_thread::sleep_for( window );
+        }
 
-            write_buffers.swap( _buffers );
+        uint64_t seq{ 0 };
+        bool     written = true;
+        {
+            std::lock_guard< std::mutex > drain_lock{ _drain_mutex };
+            written = write_pending( write_buffers, seq );
+        }
+        if ( !written ) {
+            fail_writes();
+        }
+        // 积压清空后报告丢弃计数，报告记录随下一轮写入
+        if ( _queued == 0 ) {
+            report_dropped();
         }
 
-        if ( !write_buffers.empty() ) {
-            std::for_each( write_buffers.begin(), write_buffers.end(), [ this ]( auto& buffer ) {
-                flush_buffer_to_file( std::move( buffer ) );
-            } );
+        bool sync = requested;
+        if ( periodic && std::chrono::steady_clock::now() >= next_sync ) {
+            sync      = sync || seq > _durable_seq;
+            next_sync = std::chrono::steady_clock::now() + interval;
+        }
+        if ( !sync || std::chrono::steady_clock::now() < retry_at ) {
+            continue;
+        }
+        if ( sync_to( seq, written ) ) {
+            retry_backoff = 1;
+            retry_at      = std::chrono::steady_clock::time_point{};
+        } else {
+            uint32_t delay = std::min( SYNC_RETRY_INTERVAL_MS * retry_backoff,
+                                       SYNC_MAX_RETRY_INTERVAL_MS );
+            retry_at       = std::chrono::steady_clock::now() + std::chrono::milliseconds{ delay };
+            retry_backoff  = std::min< uint32_t >( retry_backoff * 2, 128 );
         }
     }
 
-    auto final_buffers = BufferVec{};
+    report_dropped();
+    uint64_t seq{ 0 };
+    bool     written = true;
+    {
+        std::lock_guard< std::mutex > drain_lock{ _drain_mutex };
+        written = write_pending( write_buffers, seq );
+    }
+    if ( _config.durability != DurabilityPolicy::NONE ) {
+        sync_to( seq, written );
+    }
+}
 
+bool CFileSink::write_pending( BufferVec& write_buffers, uint64_t& seq ) noexcept {
     {
         std::lock_guard< std::mutex > lock{ _buffer_mutex };
-        if ( _current_buffer->length() > 0 ) {
-            _buffers.emplace_back( std::move( _current_buffer ) );
-            std::swap( _current_buffer, _next_buffer );
-            _next_buffer = std::make_unique< Buffer >();
+        if ( utils::reserve_bytes( _reserve.load( std::memory_order_acquire ) ) > 0 ) {
+            swap_current_buffer();
         }
-        final_buffers.swap( _buffers );
+        write_buffers.swap( _buffers );
+        // 换出失败时当前代的数据不计入
+        seq = _generation << 32;
+
+        // 只有上一代可能仍有在途拷贝，更早的代在槽位复用前已经结束；持锁等待期间槽位不会被复用
+        Slot& retired = _slots[ ( _generation + 1 ) & 1 ];
+        utils::wait_reserve_commits( retired._committed, retired._expected.load() );
+        // 拷贝已全部结束，旧缓冲区写入后归还缓冲区池，槽位不能再指向它
+        retired._raw      = nullptr;
+        retired._capacity = 0;
+    }
+
+    if ( write_buffers.empty() ) {
+        // 空闲时回收在途写入，缓冲区归还缓冲区池
+        drain_uring();
+        return true;
+    }
+
+    size_t count = 0;
+    for ( const auto& buffer : write_buffers ) {
+        count += buffer ? backlog_weight( *buffer ) : 0;
+    }
+    bool success = flush_buffers_to_file( write_buffers );
+    {
+        std::lock_guard< std::mutex > lock{ _buffer_mutex };
+        _queued -= count;
+    }
+    _space_cond.notify_all();
+    return success;
+}
+
+bool CFileSink::backlog_full( size_t weight ) const noexcept {
+    // 积压为空时总是放行，单条记录超过上限也不会永远等待
+    return _running && _queued > 0 && _queued + weight > _max_queued;
+}
+
+size_t CFileSink::backlog_weight( const Buffer& buffer ) const noexcept {
+    size_t size = _buffer_pool.buffer_size();
+    return std::max< size_t >( 1, ( buffer.capacity() + size - 1 ) / size );
+}
+
+bool CFileSink::shed_level( LogLevel level ) const noexcept {
+    // 积压每增加 1/5 多丢弃一个最低级别，最多丢弃到 WARN
+    size_t step = std::min< size_t >( _queued.load( std::memory_order_relaxed ) * 5 / _max_queued,
+                                      static_cast< size_t >( LogLevel::ERROR ) );
+    return static_cast< size_t >( level ) < step;
+}
+
+void CFileSink::count_drop( LogLevel level ) noexcept {
+    size_t index = std::min( static_cast< size_t >( level ), kLevelCount - 1 );
+    _dropped[ index ].fetch_add( 1, std::memory_order_relaxed );
+}
+
+uint64_t CFileSink::dropped() const noexcept {
+    uint64_t total = 0;
+    for ( const auto& counter : _dropped ) {
+        total += counter.load( std::memory_order_relaxed );
     }
+    return total;
+}
+
+uint64_t CFileSink::dropped( LogLevel level ) const noexcept {
+    size_t index = static_cast< size_t >( level );
+    return index < kLevelCount ? _dropped[ index ].load( std::memory_order_relaxed ) : 0;
+}
 
-    if ( !final_buffers.empty() ) {
-        std::for_each( final_buffers.begin(), final_buffers.end(), [ this ]( auto& buffer ) {
-            flush_buffer_to_file( std::move( buffer ) );
-        } );
+void CFileSink::report_dropped() noexcept {
+    std::array< uint64_t, kLevelCount > current{};
+    uint64_t                            total = 0;
+    for ( size_t i = 0; i < kLevelCount; ++i ) {
+        current[ i ] = _dropped[ i ].load( std::memory_order_relaxed );
+        total += current[ i ] - _reported[ i ];
+    }
+    if ( total == 0 ) {
+        return;
     }
+
+    try {
+        std::string message = "jzlog dropped " + std::to_string( total ) +
+                              " records while the write backlog was full (";
+        bool first = true;
+        for ( size_t i = 0; i < kLevelCount; ++i ) {
+            uint64_t delta = current[ i ] - _reported[ i ];
+            if ( delta == 0 ) {
+                continue;
+            }
+            message += first ? "" : " ";
+            message += to_string( static_cast< LogLevel >( i ) );
+            message += "=" + std::to_string( delta );
+            first = false;
+        }
+        message += ")";
+
+        LogRecord record;
+        record._timestamp = std::chrono::system_clock::now();
+        record._level     = LogLevel::WARN;
+        record._message   = std::move( message );
+        record._thread_id = std::this_thread::get_id();
+
+        // 报告放进独立缓冲区并越过积压上限入队：只有后台线程能腾出空间，它不能等待积压下降
+        std::string_view line = _formatter.format( record );
+        BufferPtr        report{ new ( std::nothrow ) Buffer( line.size() ) };
+        if ( !report ) {
+            return;
+        }
+        report->append( line.data(), line.size() );
+        size_t   weight = backlog_weight( *report );
+        uint64_t seq{ 0 };
+        {
+            std::lock_guard< std::mutex > lock{ _buffer_mutex };
+            if ( !enqueue_buffer( std::move( report ), weight, seq ) ) {
+                return;
+            }
+        }
+        _reported = current;
+    } catch ( ... ) {}
+}
+
+bool CFileSink::sync_to( uint64_t seq, bool written ) noexcept {
+    if ( !drain_uring() || !written ) {
+        fail_writes();
+    }
+
+    int err = 0;
+    {
+        std::lock_guard< std::mutex > file_lock{ _file_mutex };
+        if ( _fd < 0 ) {
+            err = EBADF;
+        } else if ( ::fdatasync( _fd ) != 0 ) {
+            err = errno;
+        }
+    }
+    ++_sync_count;
+    if ( err != 0 ) {
+        std::cerr << "failed to sync log file: " << strerror( err ) << std::endl;
+    }
+
+    {
+        std::lock_guard< std::mutex > lock{ _durable_mutex };
+        if ( err != 0 ) {
+            ++_sync_failures;
+        } else if ( !_write_failed && seq > _durable_seq ) {
+            // 只有 seq 之前的写入全部成功时才推进，写入失败的数据不能报告为已持久化
+            _durable_seq = seq;
+        }
+    }
+    _durable_cond.notify_all();
+    return err == 0;
 }
 
 void CFileSink::start() noexcept {
     if ( !_running.exchange( true ) ) {
-        _thread = std::thread( &CFileSink::work_thread, this );
+        _thread         = std::thread( &CFileSink::work_thread, this );
+        _prepare_thread = std::thread( &CFileSink::prepare_thread, this );
     }
 }
 
@@ -288,6 +1189,11 @@ void CFileSink::init_file_idx() noexcept {
         return;
     }
 
+    if ( load_manifest( today_str ) ) {
+        _cur_date_str = today_str;
+        return;
+    }
+
     for ( const auto& entry : std::filesystem::directory_iterator( _file_path, ec ) ) {
         if ( entry.is_regular_file() ) {
             std::string filename = entry.path().filename().string();
@@ -310,6 +1216,67 @@ void CFileSink::init_file_idx() noexcept {
     _cur_date_str = today_str;
 }
 
+bool CFileSink::load_manifest( const std::string& today ) noexcept {
+    try {
+        std::ifstream in( _file_path + "/" + std::string( MANIFEST_FILE_NAME ) );
+        std::string   date;
+        int           idx = -1;
+        if ( !( in >> date >> idx ) || date.size() != today.size() || idx < 0 ) {
+            return false;
+        }
+        if ( date != today ) {
+            idx = -1;
+        }
+
+        // 清单更新失败或由旧版本写入的文件不在清单中时向后探测；超出上限说明清单已严重落后
+        std::error_code ec;
+        for ( int probe = 0;; ++probe ) {
+            if ( !std::filesystem::exists( _file_path + "/" + log_file_name( today, idx + 1 ),
+                                           ec ) ) {
+                break;
+            }
+            if ( probe == kManifestProbeLimit ) {
+                return false;
+            }
+            ++idx;
+        }
+        _cur_idx = idx;
+        return true;
+    } catch ( ... ) {
+        return false;
+    }
+}
+
+void CFileSink::save_manifest() noexcept {
+    char content[ 64 ];
+    int  len =
+        std::snprintf( content, sizeof( content ), "%s %d\n", _cur_date_str.c_str(), _cur_idx );
+    if ( len <= 0 || static_cast< size_t >( len ) >= sizeof( content ) ) {
+        return;
+    }
+
+    std::string path;
+    std::string tmp_path;
+    try {
+        path     = _file_path + "/" + std::string( MANIFEST_FILE_NAME );
+        tmp_path = path + ".tmp";
+    } catch ( ... ) {
+        return;
+    }
+
+    int fd = ::open( tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if ( fd < 0 ) {
+        std::cerr << "failed to update log manifest: " << strerror( errno ) << std::endl;
+        return;
+    }
+    bool written = ::write( fd, content, static_cast< size_t >( len ) ) == len;
+    ::close( fd );
+    if ( !written || ::rename( tmp_path.c_str(), path.c_str() ) != 0 ) {
+        std::cerr << "failed to update log manifest: " << strerror( errno ) << std::endl;
+        ::unlink( tmp_path.c_str() );
+    }
+}
+
 std::string CFileSink::get_date_str() noexcept {
     auto now  = std::chrono::system_clock::now();
     auto time = std::chrono::system_clock::to_time_t( now );
@@ -339,18 +1306,33 @@ void CFileSink::enable_archive( bool enable ) noexcept {
 CFileSink::~CFileSink() {
     try {
         if ( _running.exchange( false ) ) {
+            {
+                std::lock_guard< std::mutex > lock{ _buffer_mutex };
+            }
             _cond.notify_all();
+            _space_cond.notify_all();
             if ( _thread.joinable() ) {
                 _thread.join();
             }
+            {
+                std::lock_guard< std::mutex > lock{ _standby_mutex };
+            }
+            _standby_cond.notify_all();
+            if ( _prepare_thread.joinable() ) {
+                _prepare_thread.join();
+            }
         }
         if ( _archive_manager ) {
             _archive_manager->stop();
         }
         flush();
-        if ( _file_stream.is_open() ) {
-            _file_stream.close();
+        close_log_fd( _fd );
+        _fd = -1;
+        for ( int fd : _retired_fds ) {
+            close_log_fd( fd );
         }
+        _retired_fds.clear();
+        discard_file( _standby );
     } catch ( ... ) {
         std::cerr << "Error in CFileSink destructor" << std::endl;
     }
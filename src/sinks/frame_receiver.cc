@@ -0,0 +1,101 @@
+#include "jzlog/sinks/frame_receiver.h"
+#include "jzlog/sinks/net_codec.h"
+#include "jzlog/utils/crc32c.h"
+#include <cerrno>
+#include <sys/socket.h>
+#include <utility>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+namespace
+{
+bool read_exact( int fd, char* data, size_t len ) noexcept {
+    while ( len > 0 ) {
+        ssize_t n = ::recv( fd, data, len, 0 );
+        if ( n < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( n <= 0 ) {
+            return false;
+        }
+        data += n;
+        len -= static_cast< size_t >( n );
+    }
+    return true;
+}
+
+bool send_exact( int fd, const char* data, size_t len ) noexcept {
+    while ( len > 0 ) {
+        ssize_t n = ::send( fd, data, len, MSG_NOSIGNAL );
+        if ( n < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( n <= 0 ) {
+            return false;
+        }
+        data += n;
+        len -= static_cast< size_t >( n );
+    }
+    return true;
+}
+}  // namespace
+
+CFrameReceiver::CFrameReceiver( Handler handler ) : _handler( std::move( handler ) ) {}
+
+void CFrameReceiver::cut_after( size_t frames ) noexcept { _cut_after = frames; }
+
+ReceiveResult CFrameReceiver::serve( int fd ) {
+    char head[ FRAME_HEADER_SIZE ];
+    while ( read_exact( fd, head, sizeof( head ) ) ) {
+        FrameHeader header;
+        if ( !decode_frame_header( head, header ) ) {
+            return ReceiveResult::BAD_HEADER;
+        }
+        _payload.resize( header.length );
+        if ( !read_exact( fd, _payload.data(), _payload.size() ) ) {
+            break;
+        }
+        if ( utils::crc32c( 0, _payload.data(), _payload.size() ) != header.crc ) {
+            return ReceiveResult::BAD_CRC;
+        }
+        _raw.resize( header.raw_length );
+        if ( !decompress_payload( header.codec, _payload.data(), _payload.size(), _raw.data(),
+                                  _raw.size() ) ) {
+            return ReceiveResult::BAD_PAYLOAD;
+        }
+        _compressed += header.codec != FrameCodec::NONE ? 1 : 0;
+
+        // 序号不大于已收到的最大值说明是断线前已收下、只是未确认的帧
+        uint64_t& last = _last_seq[ header.session ];
+        if ( header.seq > last ) {
+            _handler( header, _raw );
+            last = header.seq;
+            ++_frames;
+        } else {
+            ++_duplicates;
+        }
+        if ( _cut_after > 0 && ++_received == _cut_after ) {
+            _cut_after = 0;
+            return ReceiveResult::CUT;
+        }
+
+        char ack[ ACK_SIZE ];
+        encode_ack( last, ack );
+        if ( !send_exact( fd, ack, sizeof( ack ) ) ) {
+            return ReceiveResult::ACK_FAILED;
+        }
+    }
+    return ReceiveResult::CLOSED;
+}
+
+uint64_t CFrameReceiver::frames() const noexcept { return _frames; }
+
+uint64_t CFrameReceiver::duplicates() const noexcept { return _duplicates; }
+
+uint64_t CFrameReceiver::compressed() const noexcept { return _compressed; }
+
+}  // namespace sinks
+}  // namespace jzlog
@@ -0,0 +1,288 @@
+#include "jzlog/sinks/mmap_file_sink.h"
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/utils/reserve_word.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+namespace
+{
+constexpr uint64_t kUnused = UINT64_MAX;  // 分段尚无越过末尾的预留
+
+int64_t steady_now_ns() noexcept {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+               std::chrono::steady_clock::now().time_since_epoch() )
+        .count();
+}
+
+std::string today_str() {
+    std::time_t now = std::time( nullptr );
+    std::tm     tm_buf{};
+    localtime_r( &now, &tm_buf );
+    char buf[ 16 ];
+    std::strftime( buf, sizeof( buf ), "%Y%m%d", &tm_buf );
+    return buf;
+}
+}  // anonymous namespace
+
+CMmapFileSink::CMmapFileSink( LogLevel lvl, uint32_t fsize, std::string path ) noexcept :
+    _level( lvl ),
+    _file_size( fsize ),
+    _file_path( std::move( path ) ),
+    _cur_date_str(),
+    _cur_idx( -1 ),
+    _reserve( 0 ),
+    _segments(),
+    _rotate_mutex(),
+    _retry_backoff( 1 ),
+    _retry_at( 0 ),
+    _dropped( 0 ),
+    _formatter() {
+    std::error_code ec;
+    if ( !_file_path.empty() && !std::filesystem::is_directory( _file_path, ec ) ) {
+        std::filesystem::create_directories( _file_path, ec );
+    }
+    init_file_idx();
+    if ( !open_segment( _segments[ 0 ] ) ) {
+        schedule_retry();
+    }
+}
+
+CMmapFileSink::~CMmapFileSink() {
+    std::lock_guard< std::mutex > lock{ _rotate_mutex };
+    uint64_t                      word = _reserve.load();
+    close_segment( _segments[ utils::reserve_generation( word ) & 1 ],
+                   utils::reserve_bytes( word ) );
+}
+
+bool CMmapFileSink::write( const LogRecord& r ) noexcept {
+    if ( !should_log( r._level ) || r._message.empty() ) {
+        return false;
+    }
+
+    std::string_view format_record;
+    try {
+        format_record = _formatter.format( r );
+    } catch ( ... ) {
+        return false;
+    }
+    return append( format_record.data(), format_record.size() );
+}
+
+const CPatternFormatter* CMmapFileSink::formatter() const noexcept { return &_formatter; }
+
+bool CMmapFileSink::write_formatted( const LogRecord& r, std::string_view line ) noexcept {
+    if ( !should_log( r._level ) || r._message.empty() ) {
+        return false;
+    }
+    return append( line.data(), line.size() );
+}
+
+bool CMmapFileSink::append( const char* data, size_t len ) noexcept {
+    if ( len == 0 ) {
+        return true;
+    }
+    if ( len > _file_size ) {
+        return false;
+    }
+    // 分段创建失败后的退避期内直接丢弃，不再预留，也不在滚动锁上重复尝试创建文件
+    int64_t retry_at = _retry_at.load( std::memory_order_relaxed );
+    if ( retry_at != 0 && steady_now_ns() < retry_at ) {
+        _dropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+    }
+
+    for ( ;; ) {
+        uint64_t word{ 0 };
+        bool     copied = utils::reserve_copy(
+            _reserve, data, len, _file_size,
+            [ this ]( uint32_t gen ) {
+                Segment& seg = _segments[ gen & 1 ];
+                return utils::ReserveTarget{ seg._base, seg._capacity, &seg._committed };
+            },
+            [ this, &word ]( uint64_t length ) {
+                _segments[ utils::reserve_generation( word ) & 1 ]._used.store(
+                    length, std::memory_order_relaxed );
+            },
+            word );
+
+        if ( copied ) {
+            return true;
+        }
+        if ( !rotate( utils::reserve_generation( word ) ) ) {
+            _dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+    }
+}
+
+bool CMmapFileSink::rotate( uint32_t gen ) noexcept {
+    std::lock_guard< std::mutex > lock{ _rotate_mutex };
+    if ( utils::reserve_generation( _reserve.load( std::memory_order_acquire ) ) != gen ) {
+        return true;
+    }
+
+    int64_t retry_at = _retry_at.load( std::memory_order_relaxed );
+    if ( retry_at != 0 && steady_now_ns() < retry_at ) {
+        return false;
+    }
+
+    // 下一代的槽位在上一次滚动结束时已经关闭
+    uint32_t next = gen + 1;
+    if ( !open_segment( _segments[ next & 1 ] ) ) {
+        schedule_retry();
+        return false;
+    }
+    _retry_backoff = 1;
+    _retry_at.store( 0, std::memory_order_relaxed );
+    uint64_t word =
+        _reserve.exchange( utils::make_reserve_word( next ), std::memory_order_acq_rel );
+
+    // 等待旧分段上所有已开始的预留结束拷贝
+    Segment& old = _segments[ gen & 1 ];
+    utils::wait_reserve_commits( old._committed, utils::reserve_writers( word ) );
+    close_segment( old, utils::reserve_bytes( word ) );
+    return true;
+}
+
+bool CMmapFileSink::open_segment( Segment& seg ) noexcept {
+    std::string full_path;
+    try {
+        full_path = _file_path + "/" + next_file_name();
+    } catch ( ... ) {
+        return false;
+    }
+
+    int fd = ::open( full_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if ( fd < 0 ) {
+        std::cerr << "failed to create log file: " << strerror( errno ) << std::endl;
+        return false;
+    }
+
+    // 预分配磁盘块，写入映射时不会因空间不足触发 SIGBUS；文件系统不支持 fallocate 时由
+    // posix_fallocate 逐块写零模拟。分配失败（如磁盘已满）时不能退化为稀疏文件，否则拷贝到
+    // 没有磁盘块的页上会触发 SIGBUS
+    int err = ::posix_fallocate( fd, 0, static_cast< off_t >( _file_size ) );
+    if ( err != 0 ) {
+        std::cerr << "failed to preallocate log file: " << strerror( err ) << std::endl;
+        ::close( fd );
+        ::unlink( full_path.c_str() );
+        return false;
+    }
+
+    void* base = ::mmap( nullptr, _file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if ( base == MAP_FAILED ) {
+        std::cerr << "failed to map log file: " << strerror( errno ) << std::endl;
+        ::close( fd );
+        return false;
+    }
+
+    seg._fd       = fd;
+    seg._base     = static_cast< char* >( base );
+    seg._capacity = _file_size;
+    seg._committed.store( 0, std::memory_order_relaxed );
+    seg._used.store( kUnused, std::memory_order_relaxed );
+    return true;
+}
+
+void CMmapFileSink::schedule_retry() noexcept {
+    uint32_t interval = MMAP_RETRY_INTERVAL_MS * _retry_backoff;
+    if ( interval > MMAP_MAX_RETRY_INTERVAL_MS ) {
+        interval = MMAP_MAX_RETRY_INTERVAL_MS;
+    }
+    _retry_at.store( steady_now_ns() + int64_t{ interval } * 1000000, std::memory_order_relaxed );
+    if ( _retry_backoff < 64 ) {
+        _retry_backoff *= 2;
+    }
+}
+
+void CMmapFileSink::close_segment( Segment& seg, uint64_t reserved ) noexcept {
+    if ( seg._fd < 0 ) {
+        return;
+    }
+
+    uint64_t used = seg._used.load( std::memory_order_relaxed );
+    if ( used == kUnused ) {
+        used = std::min( reserved, seg._capacity );
+    }
+
+    ::munmap( seg._base, seg._capacity );
+    if ( ::ftruncate( seg._fd, static_cast< off_t >( used ) ) != 0 ) {
+        std::cerr << "failed to truncate log file: " << strerror( errno ) << std::endl;
+    }
+    ::close( seg._fd );
+
+    seg._fd       = -1;
+    seg._base     = nullptr;
+    seg._capacity = 0;
+}
+
+std::string CMmapFileSink::next_file_name() noexcept {
+    auto date_str = today_str();
+    if ( date_str != _cur_date_str ) {
+        _cur_date_str = date_str;
+        _cur_idx      = 0;
+    } else {
+        ++_cur_idx;
+    }
+
+    char idx[ 16 ];
+    std::snprintf( idx, sizeof( idx ), "_%03d", _cur_idx );
+    return _cur_date_str + idx;
+}
+
+void CMmapFileSink::init_file_idx() noexcept {
+    _cur_date_str = today_str();
+    _cur_idx      = -1;
+
+    std::error_code ec;
+    for ( const auto& entry : std::filesystem::directory_iterator( _file_path, ec ) ) {
+        std::string filename = entry.path().filename().string();
+        if ( filename.size() > _cur_date_str.size() + 1 &&
+             filename.compare( 0, _cur_date_str.size(), _cur_date_str ) == 0 &&
+             filename[ _cur_date_str.size() ] == '_' ) {
+            try {
+                _cur_idx = std::max( _cur_idx,
+                                     std::stoi( filename.substr( _cur_date_str.size() + 1 ) ) );
+            } catch ( ... ) {}
+        }
+    }
+}
+
+bool CMmapFileSink::flush() noexcept { return true; }
+
+uint64_t CMmapFileSink::dropped() const noexcept {
+    return _dropped.load( std::memory_order_relaxed );
+}
+
+void CMmapFileSink::set_level( LogLevel lvl ) noexcept { _level = lvl; }
+
+LogLevel CMmapFileSink::level() const noexcept { return _level; }
+
+bool CMmapFileSink::should_log( LogLevel lvl ) const noexcept { return lvl >= _level; }
+
+void CMmapFileSink::set_pattern( std::string_view pattern ) { _formatter.set_pattern( pattern ); }
+
+void CMmapFileSink::set_enabled( bool enabled ) noexcept { (void)enabled; }
+
+bool CMmapFileSink::enabled() const noexcept { return true; }
+
+}  // namespace sinks
+}  // namespace jzlog
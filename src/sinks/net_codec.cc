@@ -0,0 +1,314 @@
+#include "jzlog/sinks/net_codec.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined( JZLOG_HAVE_ZSTD ) && JZLOG_HAVE_ZSTD
+#include <zstd.h>
+#else
+#undef JZLOG_HAVE_ZSTD
+#define JZLOG_HAVE_ZSTD 0
+#endif
+
+namespace jzlog
+{
+namespace sinks
+{
+
+namespace
+{
+constexpr size_t   kMinMatch     = 4;      // 最短匹配长度
+constexpr size_t   kLastLiterals = 5;      // 末尾至少保留为字面量的字节数
+constexpr size_t   kMatchLimit   = 12;     // 距末尾不足该字节数时不再开始匹配
+constexpr size_t   kMaxOffset    = 65535;  // 最大匹配偏移
+constexpr uint32_t kHashPrime    = 2654435761u;  // 乘法哈希常数
+
+uint32_t read32( const uint8_t* p ) noexcept {
+    uint32_t v = 0;
+    std::memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+/**
+ * @brief 写入 token 之后的扩展长度：每个 255 累加，最后一个字节小于 255
+ */
+uint8_t* write_length( uint8_t* op, size_t len ) noexcept {
+    for ( ; len >= 255; len -= 255 ) {
+        *op++ = 255;
+    }
+    *op++ = static_cast< uint8_t >( len );
+    return op;
+}
+
+/**
+ * @brief 读取扩展长度
+ * @return 成功返回 true，输入截断返回 false
+ */
+bool read_length( const uint8_t*& ip, const uint8_t* end, size_t& len ) noexcept {
+    uint8_t b = 0;
+    do {
+        if ( ip >= end ) {
+            return false;
+        }
+        b = *ip++;
+        len += b;
+    } while ( b == 255 );
+    return true;
+}
+
+bool decompress_lz( const uint8_t* ip, size_t len, uint8_t* dst, size_t raw_len ) noexcept {
+    const uint8_t* iend = ip + len;
+    uint8_t*       op   = dst;
+    uint8_t*       oend = dst + raw_len;
+    while ( ip < iend ) {
+        uint8_t token   = *ip++;
+        size_t  literal = token >> 4;
+        if ( literal == 15 && !read_length( ip, iend, literal ) ) {
+            return false;
+        }
+        if ( literal > static_cast< size_t >( iend - ip ) ||
+             literal > static_cast< size_t >( oend - op ) ) {
+            return false;
+        }
+        std::memcpy( op, ip, literal );
+        op += literal;
+        ip += literal;
+        if ( ip == iend ) {
+            break;  // 最后一个序列只有字面量
+        }
+
+        if ( iend - ip < 2 ) {
+            return false;
+        }
+        size_t offset = ip[ 0 ] | ( static_cast< size_t >( ip[ 1 ] ) << 8 );
+        ip += 2;
+        size_t match = token & 15;
+        if ( match == 15 && !read_length( ip, iend, match ) ) {
+            return false;
+        }
+        match += kMinMatch;
+        if ( offset == 0 || offset > static_cast< size_t >( op - dst ) ||
+             match > static_cast< size_t >( oend - op ) ) {
+            return false;
+        }
+        const uint8_t* ref = op - offset;
+        if ( offset >= match ) {
+            std::memcpy( op, ref, match );
+            op += match;
+        } else {
+            // 重叠复制：偏移小于长度时按字节展开重复的模式
+            for ( size_t i = 0; i < match; ++i ) {
+                *op++ = ref[ i ];
+            }
+        }
+    }
+    return op == oend;
+}
+}  // anonymous namespace
+
+bool codec_available( FrameCodec codec ) noexcept {
+    switch ( codec ) {
+        case FrameCodec::NONE:
+        case FrameCodec::LZ:
+            return true;
+        case FrameCodec::ZSTD:
+            return JZLOG_HAVE_ZSTD != 0;
+    }
+    return false;
+}
+
+bool decompress_payload( FrameCodec codec, const char* src, size_t len, char* dst,
+                         size_t raw_len ) noexcept {
+    switch ( codec ) {
+        case FrameCodec::NONE:
+            if ( len != raw_len ) {
+                return false;
+            }
+            std::memcpy( dst, src, len );
+            return true;
+        case FrameCodec::LZ:
+            return decompress_lz( reinterpret_cast< const uint8_t* >( src ), len,
+                                  reinterpret_cast< uint8_t* >( dst ), raw_len );
+        case FrameCodec::ZSTD:
+#if JZLOG_HAVE_ZSTD
+        {
+            size_t n = ZSTD_decompress( dst, raw_len, src, len );
+            return !ZSTD_isError( n ) && n == raw_len;
+        }
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+CFrameCompressor::CFrameCompressor( FrameCodec codec, int level ) noexcept :
+    _codec( codec ),
+    _level( level ),
+    _hash_bits( 0 ),
+    _ways( 1 ),
+    _table(),
+    _zstd_ctx( nullptr ) {
+    if ( codec == FrameCodec::LZ ) {
+        _hash_bits = level <= 1 ? 12 : level == 2 ? 14 : 16;
+        _ways      = level <= 1 ? 1 : level == 2 ? 2 : 4;
+        try {
+            _table.resize( ( size_t{ 1 } << _hash_bits ) * _ways );
+        } catch ( ... ) {
+            _hash_bits = 0;
+        }
+    }
+#if JZLOG_HAVE_ZSTD
+    if ( codec == FrameCodec::ZSTD ) {
+        _zstd_ctx = ZSTD_createCCtx();
+    }
+#endif
+}
+
+CFrameCompressor::~CFrameCompressor() {
+#if JZLOG_HAVE_ZSTD
+    ZSTD_freeCCtx( static_cast< ZSTD_CCtx* >( _zstd_ctx ) );
+#endif
+}
+
+bool CFrameCompressor::valid() const noexcept {
+    switch ( _codec ) {
+        case FrameCodec::LZ:
+            return _hash_bits > 0;
+        case FrameCodec::ZSTD:
+            return _zstd_ctx != nullptr;
+        default:
+            return false;
+    }
+}
+
+size_t CFrameCompressor::bound( size_t len ) const noexcept {
+#if JZLOG_HAVE_ZSTD
+    if ( _codec == FrameCodec::ZSTD ) {
+        return ZSTD_compressBound( len );
+    }
+#endif
+    // 最坏情况全是字面量：每 255 字节多 1 字节长度，外加 token 与扩展长度的结尾
+    return len + len / 255 + 16;
+}
+
+size_t CFrameCompressor::compress( const char* src, size_t len, char* dst, size_t cap ) noexcept {
+    if ( !valid() ) {
+        return 0;
+    }
+#if JZLOG_HAVE_ZSTD
+    if ( _codec == FrameCodec::ZSTD ) {
+        size_t n = ZSTD_compressCCtx( static_cast< ZSTD_CCtx* >( _zstd_ctx ), dst, cap, src, len,
+                                      _level );
+        return ZSTD_isError( n ) ? 0 : n;
+    }
+#endif
+    return compress_lz( reinterpret_cast< const uint8_t* >( src ), len,
+                        reinterpret_cast< uint8_t* >( dst ), cap );
+}
+
+size_t CFrameCompressor::compress_lz( const uint8_t* src, size_t len, uint8_t* dst,
+                                      size_t cap ) noexcept {
+    std::fill( _table.begin(), _table.end(), 0 );
+    const unsigned shift = 32 - _hash_bits;
+    const unsigned skip  = _level <= 1 ? 5 : 6;  // 连续未命中时步长增长的速度
+
+    // 每个哈希桶保存最近 _ways 个位置，新位置插在桶首
+    auto insert = [ & ]( const uint8_t* p ) {
+        uint32_t* bucket = &_table[ ( ( read32( p ) * kHashPrime ) >> shift ) * _ways ];
+        for ( unsigned w = _ways - 1; w > 0; --w ) {
+            bucket[ w ] = bucket[ w - 1 ];
+        }
+        bucket[ 0 ] = static_cast< uint32_t >( p - src );
+    };
+
+    const uint8_t* ip     = src;
+    const uint8_t* anchor = src;  // 尚未输出的字面量起点
+    const uint8_t* end    = src + len;
+    uint8_t*       op     = dst;
+    uint8_t*       oend   = dst + cap;
+
+    if ( len > kMatchLimit ) {
+        const uint8_t* mflimit    = end - kMatchLimit;
+        const uint8_t* matchlimit = end - kLastLiterals;
+        while ( ip < mflimit ) {
+            // 在桶内的候选位置中取向后匹配最长的一个
+            uint32_t        seq    = read32( ip );
+            const uint32_t* bucket = &_table[ ( ( seq * kHashPrime ) >> shift ) * _ways ];
+            const uint8_t*  ref    = nullptr;
+            const uint8_t*  mp     = ip;  // 最长匹配的结束位置
+            for ( unsigned w = 0; w < _ways; ++w ) {
+                const uint8_t* cand = src + bucket[ w ];
+                if ( cand >= ip || static_cast< size_t >( ip - cand ) > kMaxOffset ||
+                     read32( cand ) != seq ) {
+                    continue;
+                }
+                const uint8_t* p = ip + kMinMatch;
+                const uint8_t* q = cand + kMinMatch;
+                while ( p < matchlimit && *p == *q ) {
+                    ++p;
+                    ++q;
+                }
+                if ( p > mp ) {
+                    mp  = p;
+                    ref = cand;
+                }
+            }
+            insert( ip );
+            if ( ref == nullptr ) {
+                ip += 1 + ( static_cast< size_t >( ip - anchor ) >> skip );
+                continue;
+            }
+
+            // 向前扩展匹配起点
+            while ( ip > anchor && ref > src && ip[ -1 ] == ref[ -1 ] ) {
+                --ip;
+                --ref;
+            }
+
+            size_t literal = static_cast< size_t >( ip - anchor );
+            size_t match   = static_cast< size_t >( mp - ip ) - kMinMatch;
+            if ( static_cast< size_t >( oend - op ) <
+                 1 + literal + literal / 255 + 1 + 2 + match / 255 + 1 ) {
+                return 0;
+            }
+            uint8_t* token = op++;
+            *token         = static_cast< uint8_t >( std::min< size_t >( literal, 15 ) << 4 );
+            if ( literal >= 15 ) {
+                op = write_length( op, literal - 15 );
+            }
+            std::memcpy( op, anchor, literal );
+            op += literal;
+
+            size_t offset = static_cast< size_t >( ip - ref );
+            *op++         = static_cast< uint8_t >( offset );
+            *op++         = static_cast< uint8_t >( offset >> 8 );
+            *token |= static_cast< uint8_t >( std::min< size_t >( match, 15 ) );
+            if ( match >= 15 ) {
+                op = write_length( op, match - 15 );
+            }
+
+            ip     = mp;
+            anchor = ip;
+            if ( ip < mflimit ) {
+                // 补记匹配末尾附近的位置，提高下一次命中率
+                insert( ip - 2 );
+            }
+        }
+    }
+
+    size_t literal = static_cast< size_t >( end - anchor );
+    if ( static_cast< size_t >( oend - op ) < 1 + literal + literal / 255 + 1 ) {
+        return 0;
+    }
+    uint8_t* token = op++;
+    *token         = static_cast< uint8_t >( std::min< size_t >( literal, 15 ) << 4 );
+    if ( literal >= 15 ) {
+        op = write_length( op, literal - 15 );
+    }
+    std::memcpy( op, anchor, literal );
+    op += literal;
+    return static_cast< size_t >( op - dst );
+}
+
+}  // namespace sinks
+}  // namespace jzlog
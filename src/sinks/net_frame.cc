@@ -0,0 +1,90 @@
+#include "jzlog/sinks/net_frame.h"
+#include <cstring>
+#include <endian.h>
+
+namespace jzlog
+{
+namespace sinks
+{
+
+namespace
+{
+void put16( char* out, uint16_t v ) noexcept {
+    v = htobe16( v );
+    std::memcpy( out, &v, sizeof( v ) );
+}
+
+void put32( char* out, uint32_t v ) noexcept {
+    v = htobe32( v );
+    std::memcpy( out, &v, sizeof( v ) );
+}
+
+void put64( char* out, uint64_t v ) noexcept {
+    v = htobe64( v );
+    std::memcpy( out, &v, sizeof( v ) );
+}
+
+uint32_t get32( const char* in ) noexcept {
+    uint32_t v = 0;
+    std::memcpy( &v, in, sizeof( v ) );
+    return be32toh( v );
+}
+
+uint64_t get64( const char* in ) noexcept {
+    uint64_t v = 0;
+    std::memcpy( &v, in, sizeof( v ) );
+    return be64toh( v );
+}
+}  // anonymous namespace
+
+void encode_frame_header( const FrameHeader& header, char* out ) noexcept {
+    put32( out, FRAME_MAGIC );
+    out[ 4 ] = static_cast< char >( FRAME_VERSION );
+    out[ 5 ] = static_cast< char >( header.codec );
+    put16( out + 6, 0 );
+    put32( out + 8, header.length );
+    put32( out + 12, header.raw_length );
+    put32( out + 16, header.records );
+    put32( out + 20, header.crc );
+    put64( out + 24, header.session );
+    put64( out + 32, header.seq );
+}
+
+bool decode_frame_header( const char* in, FrameHeader& header ) noexcept {
+    if ( get32( in ) != FRAME_MAGIC || static_cast< uint8_t >( in[ 4 ] ) != FRAME_VERSION ) {
+        return false;
+    }
+    auto codec = static_cast< uint8_t >( in[ 5 ] );
+    if ( codec > static_cast< uint8_t >( FrameCodec::ZSTD ) ) {
+        return false;
+    }
+    header.codec      = static_cast< FrameCodec >( codec );
+    header.length     = get32( in + 8 );
+    header.raw_length = get32( in + 12 );
+    header.records    = get32( in + 16 );
+    header.crc        = get32( in + 20 );
+    header.session    = get64( in + 24 );
+    header.seq        = get64( in + 32 );
+    // 接收方按 length 与 raw_length 分配缓冲区，两者都必须有上限
+    if ( header.length > MAX_FRAME_LENGTH || header.raw_length > MAX_FRAME_LENGTH ) {
+        return false;
+    }
+    return header.codec != FrameCodec::NONE || header.raw_length == header.length;
+}
+
+void encode_ack( uint64_t seq, char* out ) noexcept {
+    put32( out, ACK_MAGIC );
+    put32( out + 4, 0 );
+    put64( out + 8, seq );
+}
+
+bool decode_ack( const char* in, uint64_t& seq ) noexcept {
+    if ( get32( in ) != ACK_MAGIC ) {
+        return false;
+    }
+    seq = get64( in + 8 );
+    return true;
+}
+
+}  // namespace sinks
+}  // namespace jzlog
@@ -1,7 +1,9 @@
 #include "jzlog/sinks/network_sink.h"
 #include "jzlog/core/log_level.h"
 #include "jzlog/core/log_record.h"
+#include "jzlog/utils/crc32c.h"
 #include <algorithm>
+#include <array>
 #include <arpa/inet.h>
 #include <asm-generic/socket.h>
 #include <bits/types/struct_timeval.h>
@@ -10,16 +12,18 @@
 #include <cstring>
 #include <ctime>
 #include <errno.h>
-#include <iomanip>
+#include <linux/errqueue.h>
 #include <iostream>
 #include <mutex>
 #include <netdb.h>
 #include <netinet/in.h>
-#include <optional>
-#include <sstream>
+#include <new>
+#include <poll.h>
+#include <random>
 #include <string>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <thread>
 #include <unistd.h>
 #include <utility>
@@ -31,14 +35,20 @@ namespace sinks
 
 namespace
 {
-std::optional< std::tm > safe_localtime( std::time_t time ) {
-    std::tm tm_buf;
-#ifdef _WIN32
-    localtime_s( &tm_buf, &time );
-#else
-    localtime_r( &time, &tm_buf );
-#endif
-    return std::make_optional( tm_buf );
+constexpr size_t   kSendBatchSize      = 64;  // 单次 sendmsg 合并的最大发送块数
+constexpr uint32_t kMaxCompressBackoff = 64;  // 压缩效果差时最多连续跳过的批次数
+
+/**
+ * @brief 生成会话标识，收集端据此区分不同 sink 实例的帧序号
+ */
+uint64_t make_session_id() noexcept {
+    auto id =
+        static_cast< uint64_t >( std::chrono::system_clock::now().time_since_epoch().count() );
+    try {
+        std::random_device rd;
+        id ^= ( static_cast< uint64_t >( rd() ) << 32 ) | rd();
+    } catch ( ... ) {}
+    return id;
 }
 }  // anonymous namespace
 
@@ -50,11 +60,48 @@ CNetworkSink::CNetworkSink() noexcept :
     _connected( false ),
     _batch_size( DEFAULT_BATCH_SIZE ),
     _batch_timeout_ms( DEFAULT_BATCH_TIMEOUT_MS ),
-    _batch_buffer(),
+    _pool( NETWORK_CHUNK_SIZE, NETWORK_POOL_SIZE, 0 ),
+    _batch(),
+    _batch_bytes( 0 ),
+    _batch_count( 0 ),
     _buffer_mutex(),
+    _send_chain(),
+    _send_bytes( 0 ),
+    _send_count( 0 ),
+    _send_mutex(),
+    _zerocopy_threshold( 0 ),
+    _zerocopy( false ),
+    _zc_issued( 0 ),
+    _zc_completed( 0 ),
+    _session( make_session_id() ),
+    _next_seq( 0 ),
+    _unacked(),
+    _unacked_bytes( 0 ),
+    _ack_buffer(),
+    _ack_fill( 0 ),
+    _compressor(),
+    _compress_min_bytes( DEFAULT_COMPRESS_MIN_BYTES ),
+    _compress_backoff( 0 ),
+    _compress_skip( 0 ),
+    _compress_input(),
+    _compress_output(),
+    _stat_frames( 0 ),
+    _stat_attempted( 0 ),
+    _stat_compressed( 0 ),
+    _stat_raw_bytes( 0 ),
+    _stat_wire_bytes( 0 ),
+    _stat_compress_ns( 0 ),
+    _spool(),
+    _replay_rate( 0 ),
+    _replay_budget( 0 ),
+    _replay_at(),
+    _replay_buffer(),
     _retry_interval_ms( DEFAULT_RETRY_INTERVAL_MS ),
     _retry_backoff( 1 ),
-    _running( false ) {
+    _retry_at(),
+    _dropped( 0 ),
+    _running( false ),
+    _formatter() {
     start();
 }
 
@@ -68,40 +115,125 @@ CNetworkSink::CNetworkSink( std::string host, uint16_t port, LogLevel level, siz
     _connected( false ),
     _batch_size( batch_size ),
     _batch_timeout_ms( batch_timeout_ms ),
-    _batch_buffer(),
+    _pool( NETWORK_CHUNK_SIZE, NETWORK_POOL_SIZE, 0 ),
+    _batch(),
+    _batch_bytes( 0 ),
+    _batch_count( 0 ),
     _buffer_mutex(),
+    _send_chain(),
+    _send_bytes( 0 ),
+    _send_count( 0 ),
+    _send_mutex(),
+    _zerocopy_threshold( 0 ),
+    _zerocopy( false ),
+    _zc_issued( 0 ),
+    _zc_completed( 0 ),
+    _session( make_session_id() ),
+    _next_seq( 0 ),
+    _unacked(),
+    _unacked_bytes( 0 ),
+    _ack_buffer(),
+    _ack_fill( 0 ),
+    _compressor(),
+    _compress_min_bytes( DEFAULT_COMPRESS_MIN_BYTES ),
+    _compress_backoff( 0 ),
+    _compress_skip( 0 ),
+    _compress_input(),
+    _compress_output(),
+    _stat_frames( 0 ),
+    _stat_attempted( 0 ),
+    _stat_compressed( 0 ),
+    _stat_raw_bytes( 0 ),
+    _stat_wire_bytes( 0 ),
+    _stat_compress_ns( 0 ),
+    _spool(),
+    _replay_rate( 0 ),
+    _replay_budget( 0 ),
+    _replay_at(),
+    _replay_buffer(),
     _retry_interval_ms( retry_interval_ms ),
     _retry_backoff( 1 ),
-    _running( false ) {
+    _retry_at(),
+    _dropped( 0 ),
+    _running( false ),
+    _formatter() {
     (void)enable;
     start();
 }
 
 bool CNetworkSink::write( const LogRecord& r ) noexcept {
-    std::cout << r._message << std::endl;
     if ( !should_log( r._level ) || r._message.empty() ) {
         return false;
     }
 
-    {
+    std::string_view line;
+    try {
+        line = _formatter.format( r );
+    } catch ( ... ) {
+        return false;
+    }
+    return write_formatted( r, line );
+}
+
+const CPatternFormatter* CNetworkSink::formatter() const noexcept { return &_formatter; }
+
+bool CNetworkSink::write_formatted( const LogRecord& r, std::string_view line ) noexcept {
+    if ( !should_log( r._level ) || r._message.empty() ) {
+        return false;
+    }
+
+    bool full = false;
+    try {
         std::lock_guard lock{ _buffer_mutex };
-        _batch_buffer.push_back( r );
+        // 发送方卡在网络上时批次不再被换出，超过上限后丢弃而不是等待
+        if ( _batch_bytes + line.size() > MAX_PENDING_BYTES ) {
+            ++_dropped;
+            return false;
+        }
+        if ( !append_line( line ) ) {
+            return false;
+        }
+        full = ++_batch_count >= _batch_size;
+    } catch ( ... ) {
+        return false;
     }
-    std::cout << "write success" << std::endl;
 
-    _cond.notify_one();
+    // 未满一批时由后台线程按超时发送，无需每条都唤醒
+    if ( full ) {
+        _cond.notify_one();
+    }
     return true;
 }
 
-bool CNetworkSink::flush() noexcept {
-    bool result = true;
-    {
-        std::lock_guard lock{ _buffer_mutex };
-        if ( !_batch_buffer.empty() ) {
-            result = send_batch();
+bool CNetworkSink::append_line( std::string_view line ) noexcept {
+    if ( _batch.empty() || _batch.back()->avail() < line.size() ) {
+        BufferPtr chunk;
+        if ( line.size() > _pool.buffer_size() ) {
+            // 超长行单独占一个等长的块，发送后归还时被池直接释放
+            chunk.reset( new ( std::nothrow ) Buffer( line.size() ) );
+        } else {
+            chunk = _pool.acquire();
+        }
+        if ( !chunk ) {
+            return false;
+        }
+        try {
+            _batch.emplace_back( std::move( chunk ) );
+        } catch ( ... ) {
+            return false;
         }
     }
-    return result;
+    _batch.back()->append( line.data(), line.size() );
+    _batch_bytes += line.size();
+    return true;
+}
+
+bool CNetworkSink::flush() noexcept {
+    if ( !send_pending() ) {
+        return false;
+    }
+    std::lock_guard send_lock{ _send_mutex };
+    return wait_acked();
 }
 
 void CNetworkSink::set_level( LogLevel lvl ) noexcept { _level = lvl; }
@@ -110,6 +242,12 @@ LogLevel CNetworkSink::level() const noexcept { return _level; }
 
 bool CNetworkSink::should_log( LogLevel lvl ) const noexcept { return lvl >= _level; }
 
+void CNetworkSink::set_pattern( std::string_view pattern ) { _formatter.set_pattern( pattern ); }
+
+void CNetworkSink::set_zerocopy_threshold( size_t bytes ) noexcept {
+    _zerocopy_threshold.store( bytes );
+}
+
 void CNetworkSink::set_enabled( bool enabled ) noexcept { _enabled.store( enabled ); }
 
 bool CNetworkSink::enabled() const noexcept { return _enabled.load(); }
@@ -161,7 +299,15 @@ bool CNetworkSink::connect() noexcept {
         _socket_fd = -1;
         return false;
     }
-    std::cout << "Connect success" << std::endl;
+#ifdef SO_ZEROCOPY
+    if ( _zerocopy_threshold.load() > 0 ) {
+        int one   = 1;
+        _zerocopy = setsockopt( _socket_fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof( one ) ) == 0;
+        if ( !_zerocopy ) {
+            std::cerr << "Failed to enable SO_ZEROCOPY: " << strerror( errno ) << std::endl;
+        }
+    }
+#endif
 
     _connected     = true;
     _retry_backoff = 1;
@@ -173,7 +319,11 @@ void CNetworkSink::disconnect() noexcept {
         close( _socket_fd );
         _socket_fd = -1;
     }
-    _connected = false;
+    _connected    = false;
+    _zerocopy     = false;
+    _zc_issued    = 0;
+    _zc_completed = 0;
+    _ack_fill     = 0;
 }
 
 void CNetworkSink::auto_reconnect() noexcept {
@@ -184,91 +334,591 @@ void CNetworkSink::auto_reconnect() noexcept {
         retry_interval = MAX_RETRY_INTERVAL_MS;
     }
 
-    std::this_thread::sleep_for( std::chrono::milliseconds( retry_interval ) );
+    // 只记录下一次重连时间，不在发送线程中睡眠；期间到达的批次留在发送缓冲区，未确认的帧留在窗口中
+    _retry_at = Clock::now() + std::chrono::milliseconds( retry_interval );
 
     if ( _retry_backoff < 32 ) {
         _retry_backoff *= 2;
     }
+}
+
+bool CNetworkSink::send_pending() noexcept {
+    std::lock_guard send_lock{ _send_mutex };
+    swap_batch();
+    return send_batch();
+}
 
-    if ( connect() ) {
-        std::cerr << "Reconnected to " << _host << ":" << _port << std::endl;
+void CNetworkSink::swap_batch() noexcept {
+    std::lock_guard lock{ _buffer_mutex };
+    if ( _batch.empty() ) {
+        return;
     }
+
+    if ( _send_chain.empty() ) {
+        // 交换后两个向量的容量往返复用，发送块只移动指针
+        _send_chain.swap( _batch );
+        _send_bytes = _batch_bytes;
+        _send_count = _batch_count;
+    } else if ( _send_bytes + _batch_bytes <= MAX_PENDING_BYTES ) {
+        try {
+            _send_chain.reserve( _send_chain.size() + _batch.size() );
+        } catch ( ... ) {}
+        if ( _send_chain.capacity() >= _send_chain.size() + _batch.size() ) {
+            for ( auto& chunk : _batch ) {
+                _send_chain.emplace_back( std::move( chunk ) );
+            }
+            _send_bytes += _batch_bytes;
+            _send_count += _batch_count;
+        } else {
+            _dropped += _batch_count;
+        }
+    } else {
+        _dropped += _batch_count;
+    }
+    for ( auto& chunk : _batch ) {
+        _pool.release( std::move( chunk ) );
+    }
+    _batch.clear();
+    _batch_bytes = 0;
+    _batch_count = 0;
 }
 
-bool CNetworkSink::send_batch() noexcept {
-    if ( _batch_buffer.empty() ) {
-        return true;
+void CNetworkSink::release_send_chain() noexcept {
+    for ( auto& chunk : _send_chain ) {
+        _pool.release( std::move( chunk ) );
     }
+    _send_chain.clear();
+    _send_bytes = 0;
+    _send_count = 0;
+}
 
-    if ( !connect() ) {
-        auto_reconnect();
+bool CNetworkSink::push_frame( BufferVec& chunks, size_t bytes, size_t records ) noexcept {
+    try {
+        _unacked.emplace_back();
+    } catch ( ... ) {
         return false;
     }
+    size_t     raw_bytes = bytes;
+    FrameCodec codec     = compress_chunks( chunks, bytes );
+
+    Frame& frame     = _unacked.back();
+    frame._seq       = ++_next_seq;
+    frame._records   = static_cast< uint32_t >( records );
+    frame._bytes     = bytes;
+    frame._raw_bytes = raw_bytes;
+    frame._codec     = codec;
+    frame._chunks.swap( chunks );
+    _unacked_bytes += bytes;
+    ++_stat_frames;
+
+    FrameHeader header;
+    header.codec      = codec;
+    header.length     = static_cast< uint32_t >( bytes );
+    header.raw_length = static_cast< uint32_t >( raw_bytes );
+    header.records    = frame._records;
+    header.session    = _session;
+    header.seq        = frame._seq;
+    for ( const auto& chunk : frame._chunks ) {
+        header.crc = utils::crc32c( header.crc, chunk->data(), chunk->length() );
+    }
+    encode_frame_header( header, frame._header.data() );
+    return true;
+}
+
+FrameCodec CNetworkSink::compress_chunks( BufferVec& chunks, size_t& bytes ) noexcept {
+    if ( !_compressor || chunks.empty() ) {
+        return FrameCodec::NONE;
+    }
+    // 小批次不值得压缩；最近压缩效果差时跳过若干批次，不在不可压缩的数据上反复耗费 CPU
+    if ( bytes < _compress_min_bytes ) {
+        return FrameCodec::NONE;
+    }
+    if ( _compress_skip > 0 ) {
+        --_compress_skip;
+        return FrameCodec::NONE;
+    }
+
+    const char* input = chunks.front()->data();
+    try {
+        if ( chunks.size() > 1 ) {
+            _compress_input.clear();
+            _compress_input.reserve( bytes );
+            for ( const auto& chunk : chunks ) {
+                _compress_input.append( chunk->data(), chunk->length() );
+            }
+            input = _compress_input.data();
+        }
+        _compress_output.resize( _compressor->bound( bytes ) );
+    } catch ( ... ) {
+        return FrameCodec::NONE;
+    }
 
-    std::stringstream ss;
-    std::for_each( _batch_buffer.begin(), _batch_buffer.end(),
-                   [ &ss, this ]( const LogRecord& record ) {
-                       ss << format_log_record( record );
-                   } );
+    struct timespec start;
+    struct timespec end;
+    clock_gettime( CLOCK_THREAD_CPUTIME_ID, &start );
+    size_t wire =
+        _compressor->compress( input, bytes, _compress_output.data(), _compress_output.size() );
+    clock_gettime( CLOCK_THREAD_CPUTIME_ID, &end );
+    _stat_compress_ns += static_cast< uint64_t >( ( end.tv_sec - start.tv_sec ) * 1000000000LL +
+                                                  ( end.tv_nsec - start.tv_nsec ) );
+    ++_stat_attempted;
+    _stat_raw_bytes += bytes;
+
+    // 节省不到 1/8 时发送原文，并按指数退避跳过后续批次
+    if ( wire == 0 || wire > bytes - bytes / 8 ) {
+        _stat_wire_bytes += bytes;
+        _compress_backoff = std::min( std::max( _compress_backoff * 2, 1u ), kMaxCompressBackoff );
+        _compress_skip    = _compress_backoff;
+        return FrameCodec::NONE;
+    }
+    _compress_backoff = 0;
 
-    std::string data = ss.str();
-    if ( data.empty() ) {
-        _batch_buffer.clear();
-        return true;
+    // 压缩结果拷回池化的发送块，原文发送块归还池中
+    BufferVec out;
+    bool      ok = true;
+    try {
+        out.reserve( wire / _pool.buffer_size() + 1 );
+        for ( size_t offset = 0; offset < wire && ok; ) {
+            BufferPtr chunk = _pool.acquire();
+            ok              = static_cast< bool >( chunk );
+            if ( ok ) {
+                size_t n = std::min( wire - offset, chunk->avail() );
+                chunk->append( _compress_output.data() + offset, n );
+                offset += n;
+                out.emplace_back( std::move( chunk ) );
+            }
+        }
+    } catch ( ... ) {
+        ok = false;
+    }
+    if ( !ok ) {
+        for ( auto& chunk : out ) {
+            _pool.release( std::move( chunk ) );
+        }
+        _stat_wire_bytes += bytes;
+        return FrameCodec::NONE;
+    }
+    for ( auto& chunk : chunks ) {
+        _pool.release( std::move( chunk ) );
+    }
+    chunks.swap( out );
+    _stat_wire_bytes += wire;
+    ++_stat_compressed;
+    bytes = wire;
+    return _compressor->codec();
+}
+
+bool CNetworkSink::send_frame( const Frame& frame, bool zerocopy ) noexcept {
+    int flags = MSG_NOSIGNAL;
+#ifdef MSG_ZEROCOPY
+    if ( zerocopy ) {
+        flags |= MSG_ZEROCOPY;
     }
+#endif
+
+    // 第 0 段为帧头，第 i 段为第 i - 1 个发送块
+    size_t segments = frame._chunks.size() + 1;
+    auto   segment  = [ &frame ]( size_t i ) {
+        if ( i == 0 ) {
+            return iovec{ const_cast< char* >( frame._header.data() ), frame._header.size() };
+        }
+        return iovec{ frame._chunks[ i - 1 ]->data(), frame._chunks[ i - 1 ]->length() };
+    };
+
+    std::array< struct iovec, kSendBatchSize > iov;
+    size_t                                     index  = 0;  // 下一个未发完的段
+    size_t                                     offset = 0;  // 该段中已发出的字节数
+    while ( index < segments ) {
+        size_t count = 0;
+        for ( size_t i = index; i < segments && count < iov.size(); ++i ) {
+            struct iovec seg      = segment( i );
+            size_t       skip     = i == index ? offset : 0;
+            iov[ count ].iov_base = static_cast< char* >( seg.iov_base ) + skip;
+            iov[ count ].iov_len  = seg.iov_len - skip;
+            ++count;
+        }
+
+        struct msghdr msg;
+        std::memset( &msg, 0, sizeof( msg ) );
+        msg.msg_iov    = iov.data();
+        msg.msg_iovlen = count;
 
-    ssize_t total_sent = 0;
-    while ( total_sent < static_cast< ssize_t >( data.size() ) ) {
-        ssize_t sent =
-            send( _socket_fd, data.data() + total_sent, data.size() - total_sent, MSG_NOSIGNAL );
+        ssize_t sent = sendmsg( _socket_fd, &msg, flags );
         if ( sent < 0 ) {
-            if ( errno == EAGAIN || errno == EWOULDBLOCK ) {
-                std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            if ( errno == EINTR ) {
                 continue;
             }
+            // EAGAIN 表示超过 SOCKET_SEND_TIMEOUT_MS 仍无法发出，对端已停止接收，按断线处理；
+            // 帧留在未确认窗口中重连后整帧重发，收集端丢弃连接上残缺的帧
             std::cerr << "Failed to send data: " << strerror( errno ) << std::endl;
+            return false;
+        }
+        if ( zerocopy ) {
+            ++_zc_issued;
+        }
+
+        // 按发出的字节数推进断点
+        size_t left = static_cast< size_t >( sent );
+        while ( left > 0 && index < segments ) {
+            size_t remain = segment( index ).iov_len - offset;
+            if ( left < remain ) {
+                offset += left;
+                break;
+            }
+            left -= remain;
+            offset = 0;
+            ++index;
+        }
+    }
+    return true;
+}
+
+bool CNetworkSink::resend_unacked() noexcept {
+    for ( const auto& frame : _unacked ) {
+        if ( !send_frame( frame, false ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CNetworkSink::read_acks( bool wait ) noexcept {
+    bool released = false;
+    while ( true ) {
+        int     flags = wait && !released ? 0 : MSG_DONTWAIT;
+        ssize_t n =
+            recv( _socket_fd, _ack_buffer.data() + _ack_fill, ACK_SIZE - _ack_fill, flags );
+        if ( n == 0 ) {
+            std::cerr << "Connection closed by collector" << std::endl;
+            return false;
+        }
+        if ( n < 0 ) {
+            if ( errno == EINTR ) {
+                continue;
+            }
+            if ( errno == EAGAIN || errno == EWOULDBLOCK ) {
+                if ( flags == 0 ) {
+                    // 阻塞读取超过 SO_RCVTIMEO 仍无确认，收集端已停止处理
+                    std::cerr << "Timed out waiting for acknowledgement" << std::endl;
+                    return false;
+                }
+                return true;
+            }
+            std::cerr << "Failed to read acknowledgement: " << strerror( errno ) << std::endl;
+            return false;
+        }
+
+        _ack_fill += static_cast< size_t >( n );
+        if ( _ack_fill < ACK_SIZE ) {
+            continue;
+        }
+        _ack_fill    = 0;
+        uint64_t seq = 0;
+        if ( !decode_ack( _ack_buffer.data(), seq ) ) {
+            std::cerr << "Invalid acknowledgement from collector" << std::endl;
+            return false;
+        }
+        // 累计确认：序号不大于 seq 的帧都已送达
+        while ( !_unacked.empty() && _unacked.front()._seq <= seq ) {
+            Frame& frame = _unacked.front();
+            for ( auto& chunk : frame._chunks ) {
+                _pool.release( std::move( chunk ) );
+            }
+            _unacked_bytes -= frame._bytes;
+            _unacked.pop_front();
+            released = true;
+        }
+    }
+}
+
+bool CNetworkSink::wait_window( size_t bytes ) noexcept {
+    while ( _unacked.size() >= ACK_WINDOW_FRAMES ||
+            ( !_unacked.empty() && _unacked_bytes + bytes > MAX_PENDING_BYTES ) ) {
+        if ( !read_acks( true ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CNetworkSink::wait_acked() noexcept {
+    while ( _socket_fd >= 0 && !_unacked.empty() ) {
+        if ( !read_acks( true ) ) {
             auto_reconnect();
-            _batch_buffer.clear();
             return false;
         }
-        total_sent += sent;
     }
+    return _unacked.empty();
+}
+
+void CNetworkSink::release_unacked() noexcept {
+    // 磁盘队列没有队首插入，这些帧排在队列已有内容之后
+    for ( auto& frame : _unacked ) {
+        if ( !_spool || !spool_frame( frame ) ) {
+            _dropped += frame._records;
+        }
+        for ( auto& chunk : frame._chunks ) {
+            _pool.release( std::move( chunk ) );
+        }
+    }
+    _unacked.clear();
+    _unacked_bytes = 0;
+}
+
+bool CNetworkSink::wait_zerocopy() noexcept {
+#if defined( MSG_ZEROCOPY ) && defined( SO_EE_ORIGIN_ZEROCOPY )
+    // 通知携带已完成发送的编号区间 [ee_info, ee_data]，编号按提交顺序从 0 递增
+    while ( _zc_completed != _zc_issued ) {
+        struct pollfd pfd{ _socket_fd, 0, 0 };
+        int           ready = poll( &pfd, 1, static_cast< int >( SOCKET_SEND_TIMEOUT_MS ) );
+        if ( ready < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( ready <= 0 ) {
+            std::cerr << "Timed out waiting for zerocopy completion" << std::endl;
+            return false;
+        }
 
-    _batch_buffer.clear();
+        char          control[ 128 ];
+        struct msghdr msg;
+        std::memset( &msg, 0, sizeof( msg ) );
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof( control );
+        if ( recvmsg( _socket_fd, &msg, MSG_ERRQUEUE ) < 0 ) {
+            if ( errno == EAGAIN || errno == EINTR ) {
+                continue;
+            }
+            std::cerr << "Failed to read zerocopy completion: " << strerror( errno ) << std::endl;
+            return false;
+        }
+        for ( auto* cm = CMSG_FIRSTHDR( &msg ); cm != nullptr; cm = CMSG_NXTHDR( &msg, cm ) ) {
+            auto* err = reinterpret_cast< struct sock_extended_err* >( CMSG_DATA( cm ) );
+            if ( err->ee_errno == 0 && err->ee_origin == SO_EE_ORIGIN_ZEROCOPY ) {
+                _zc_completed = err->ee_data + 1;
+            }
+        }
+    }
+#endif
     return true;
 }
 
-void CNetworkSink::work_thread() noexcept {
-    while ( _running ) {
-        std::unique_lock lock{ _buffer_mutex };
+bool CNetworkSink::spool_chunks( const BufferVec& chunks, size_t records ) noexcept {
+    std::array< struct iovec, kSendBatchSize > iov;
+    // 发送块多于一次 iovec 上限时分成多个批次写入，顺序不变
+    for ( size_t index = 0; index < chunks.size(); ) {
+        size_t count = 0;
+        for ( ; index < chunks.size() && count < iov.size(); ++index, ++count ) {
+            iov[ count ].iov_base = chunks[ index ]->data();
+            iov[ count ].iov_len  = chunks[ index ]->length();
+        }
+        // 记录数随第一段计入，只用于统计
+        auto first = static_cast< uint32_t >( index == count ? records : 0 );
+        if ( !_spool->push( iov.data(), static_cast< int >( count ), first ) ) {
+            return false;
+        }
+    }
+    return true;
+}
 
-        _cond.wait_for( lock, std::chrono::milliseconds( _batch_timeout_ms ), [ this ]() {
-            return _batch_buffer.size() >= _batch_size || !_running;
-        } );
+bool CNetworkSink::spool_frame( const Frame& frame ) noexcept {
+    if ( frame._codec == FrameCodec::NONE ) {
+        return spool_chunks( frame._chunks, frame._records );
+    }
 
-        if ( _batch_buffer.size() >= _batch_size ) {
-            send_batch();
+    // 磁盘队列保存原文，回放时按当时的压缩配置重新编帧
+    try {
+        _compress_input.clear();
+        for ( const auto& chunk : frame._chunks ) {
+            _compress_input.append( chunk->data(), chunk->length() );
         }
+        _replay_buffer.resize( frame._raw_bytes );
+    } catch ( ... ) {
+        return false;
+    }
+    if ( !decompress_payload( frame._codec, _compress_input.data(), _compress_input.size(),
+                              _replay_buffer.data(), _replay_buffer.size() ) ) {
+        return false;
+    }
+    struct iovec iov{ _replay_buffer.data(), _replay_buffer.size() };
+    return _spool->push( &iov, 1, frame._records );
+}
+
+void CNetworkSink::spool_send_chain() noexcept {
+    if ( !spool_chunks( _send_chain, _send_count ) ) {
+        _dropped += _send_count;
+    }
+    release_send_chain();
+}
+
+bool CNetworkSink::replay_spool() noexcept {
+    auto now = Clock::now();
+    if ( _replay_rate > 0 ) {
+        // 令牌桶：额度按经过的时间补充，最多积攒一秒
+        double elapsed = std::chrono::duration< double >( now - _replay_at ).count();
+        _replay_budget = std::min( _replay_budget + elapsed * static_cast< double >( _replay_rate ),
+                                   static_cast< double >( _replay_rate ) );
+    }
+    _replay_at = now;
+
+    uint32_t records = 0;
+    while ( ( _replay_rate == 0 || _replay_budget > 0 ) &&
+            _spool->front( _replay_buffer, records ) ) {
+        size_t size = _replay_buffer.size();
+        if ( !wait_window( size ) ) {
+            return false;
+        }
+
+        // 出队后由未确认窗口保管，断线时随窗口重发
+        BufferPtr chunk( new ( std::nothrow ) Buffer( size ) );
+        BufferVec chunks;
+        try {
+            if ( chunk ) {
+                chunk->append( _replay_buffer.data(), size );
+                chunks.emplace_back( std::move( chunk ) );
+            }
+        } catch ( ... ) {}
+        if ( chunks.empty() || !push_frame( chunks, size, records ) ) {
+            return false;
+        }
+        _spool->pop();
+        _replay_budget -= static_cast< double >( size );
+        if ( !send_frame( _unacked.back(), false ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CNetworkSink::send_batch() noexcept {
+    bool spooled = _spool && !_spool->empty();
+    if ( _send_chain.empty() && !spooled && _unacked.empty() ) {
+        return true;
+    }
+
+    bool connected = _socket_fd >= 0;
+    if ( !connected && Clock::now() >= _retry_at ) {
+        // 新连接上先按序重发未确认的帧，再回放磁盘队列与发送新批次
+        connected = connect() && resend_unacked();
+        if ( !connected ) {
+            auto_reconnect();
+        }
+    }
+    if ( connected ) {
+        connected = read_acks( false ) && ( !spooled || replay_spool() );
+        if ( !connected ) {
+            auto_reconnect();
+        }
+        spooled = _spool && !_spool->empty();
+    }
+
+    // 断线或磁盘队列尚未回放完时新批次排到队列末尾；未启用磁盘队列时留在内存中等待重连
+    if ( !connected || spooled ) {
+        if ( _spool && !_send_chain.empty() ) {
+            spool_send_chain();
+        }
+        return false;
+    }
+    if ( _send_chain.empty() ) {
+        return true;
+    }
+
+    // 窗口已满时等待确认，收集端超过 SOCKET_SEND_TIMEOUT_MS 不确认按断线处理
+    if ( !wait_window( _send_bytes ) ) {
+        auto_reconnect();
+        if ( _spool ) {
+            spool_send_chain();
+        }
+        return false;
+    }
+    if ( !push_frame( _send_chain, _send_bytes, _send_count ) ) {
+        _dropped += _send_count;
+        release_send_chain();
+        return false;
+    }
+    _send_bytes = 0;
+    _send_count = 0;
+
+    const Frame& frame     = _unacked.back();
+    size_t       threshold = _zerocopy_threshold.load();
+    bool         zerocopy  = _zerocopy && threshold > 0 && frame._bytes >= threshold;
+    bool         success   = send_frame( frame, zerocopy );
+    // 零拷贝发送的页面在完成前仍被内核引用，发送块须等通知后才能复用
+    if ( success && zerocopy ) {
+        success = wait_zerocopy();
+    }
+    if ( !success ) {
+        if ( _zc_completed != _zc_issued ) {
+            // 内核仍引用发送块时以 RST 关闭，丢弃队列中的数据
+            struct linger abort_close{ 1, 0 };
+            setsockopt( _socket_fd, SOL_SOCKET, SO_LINGER, &abort_close, sizeof( abort_close ) );
+        }
+        // 帧留在未确认窗口中，重连后重发
+        auto_reconnect();
+    }
+    return success;
+}
+
+void CNetworkSink::work_thread() noexcept {
+    while ( _running ) {
+        {
+            std::unique_lock lock{ _buffer_mutex };
+            _cond.wait_for( lock, std::chrono::milliseconds( _batch_timeout_ms ), [ this ]() {
+                return _batch_count >= _batch_size || !_running;
+            } );
+        }
+
+        // 满批或超时都发送，发送期间生产者继续写入新的批次
+        send_pending();
     }
 
     flush();
 }
 
-std::string CNetworkSink::format_log_record( const LogRecord& r ) {
-    std::stringstream ss;
+bool CNetworkSink::enable_spool( const SpoolConfig& config ) noexcept {
+    std::unique_ptr< CDiskSpool > spool{ new ( std::nothrow ) CDiskSpool(
+        config.dir, config.max_bytes, config.segment_bytes ) };
+    if ( !spool || !spool->valid() ) {
+        return false;
+    }
+
+    std::lock_guard send_lock{ _send_mutex };
+    _spool         = std::move( spool );
+    _replay_rate   = config.replay_bytes_per_sec;
+    _replay_budget = 0;
+    _replay_at     = Clock::now();
+    return true;
+}
 
-    auto time = std::chrono::system_clock::to_time_t( r._timestamp );
-    auto tm   = safe_localtime( time );
-    if ( !tm.has_value() ) {
-        return "";
+bool CNetworkSink::set_compression( const CompressionConfig& config ) noexcept {
+    std::unique_ptr< CFrameCompressor > compressor;
+    if ( config.codec != FrameCodec::NONE ) {
+        compressor.reset( new ( std::nothrow ) CFrameCompressor( config.codec, config.level ) );
+        if ( !compressor || !compressor->valid() ) {
+            return false;
+        }
     }
-    ss << std::put_time( &( tm.value() ), "%Y-%m-%d %H:%M:%S" ) << " ["
-       << loglevel::to_string( r._level ) << "] " << "[" << r._thread_id << "]"
-       << "[" << r._function << ":" << r._line << "]" << r._message << "\n";
 
-    return ss.str();
+    std::lock_guard send_lock{ _send_mutex };
+    _compressor         = std::move( compressor );
+    _compress_min_bytes = config.min_bytes;
+    _compress_backoff   = 0;
+    _compress_skip      = 0;
+    return true;
+}
+
+NetworkStats CNetworkSink::stats() const noexcept {
+    NetworkStats stats;
+    stats.frames      = _stat_frames.load();
+    stats.attempted   = _stat_attempted.load();
+    stats.compressed  = _stat_compressed.load();
+    stats.raw_bytes   = _stat_raw_bytes.load();
+    stats.wire_bytes  = _stat_wire_bytes.load();
+    stats.compress_ns = _stat_compress_ns.load();
+    return stats;
 }
 
+uint64_t CNetworkSink::dropped() const noexcept { return _dropped.load(); }
+
 bool CNetworkSink::set_socket_timeout( uint32_t timeout_ms ) noexcept {
     if ( _socket_fd < 0 ) {
         return false;
@@ -306,6 +956,8 @@ CNetworkSink::~CNetworkSink() {
             }
         }
         flush();
+        // 仍未确认的帧写入磁盘队列留待下次启动，未启用时计入丢弃
+        release_unacked();
         disconnect();
     } catch ( ... ) {
         std::cerr << "Error in CNetworkSink destructor" << std::endl;
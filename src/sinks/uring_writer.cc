@@ -0,0 +1,322 @@
+#include "jzlog/sinks/uring_writer.h"
+#include "jzlog/utils/buffer_pool.h"
+#include "jzlog/utils/fd_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+#if defined( __linux__ ) && __has_include( <linux/io_uring.h> )
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define JZLOG_HAVE_IO_URING 1
+#else
+#define JZLOG_HAVE_IO_URING 0
+#endif
+
+namespace jzlog
+{
+namespace sinks
+{
+
+namespace
+{
+constexpr auto kQuiesceTimeout = std::chrono::seconds{ 5 };  // 环失效后等待已提交写入完成的上限
+}  // anonymous namespace
+
+CUringWriter::CUringWriter( utils::CBufferPool& pool, unsigned depth ) noexcept :
+    _pool( pool ) {
+#if JZLOG_HAVE_IO_URING
+    depth = depth == 0 ? DEFAULT_URING_DEPTH : depth;
+
+    struct io_uring_params params;
+    std::memset( &params, 0, sizeof( params ) );
+    int ring_fd = static_cast< int >( ::syscall( __NR_io_uring_setup, depth, &params ) );
+    if ( ring_fd < 0 ) {
+        return;
+    }
+    _ring_fd      = ring_fd;
+
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+    _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+    bool single   = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+    if ( single ) {
+        _sq_ring_size = _cq_ring_size = std::max( _sq_ring_size, _cq_ring_size );
+    }
+
+    _sq_ring = ::mmap( nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       _ring_fd, IORING_OFF_SQ_RING );
+    if ( _sq_ring == MAP_FAILED ) {
+        _sq_ring = nullptr;
+        close_ring();
+        return;
+    }
+    if ( single ) {
+        _cq_ring = _sq_ring;
+    } else {
+        _cq_ring = ::mmap( nullptr, _cq_ring_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING );
+        if ( _cq_ring == MAP_FAILED ) {
+            _cq_ring = nullptr;
+            close_ring();
+            return;
+        }
+    }
+    _sqes_size = params.sq_entries * sizeof( struct io_uring_sqe );
+    _sqes      = ::mmap( nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         _ring_fd, IORING_OFF_SQES );
+    if ( _sqes == MAP_FAILED ) {
+        _sqes = nullptr;
+        close_ring();
+        return;
+    }
+
+    auto* sq  = static_cast< char* >( _sq_ring );
+    auto* cq  = static_cast< char* >( _cq_ring );
+    _sq_tail  = reinterpret_cast< unsigned* >( sq + params.sq_off.tail );
+    _sq_mask  = reinterpret_cast< unsigned* >( sq + params.sq_off.ring_mask );
+    _sq_array = reinterpret_cast< unsigned* >( sq + params.sq_off.array );
+    _cq_head  = reinterpret_cast< unsigned* >( cq + params.cq_off.head );
+    _cq_tail  = reinterpret_cast< unsigned* >( cq + params.cq_off.tail );
+    _cq_mask  = reinterpret_cast< unsigned* >( cq + params.cq_off.ring_mask );
+    _cqes     = cq + params.cq_off.cqes;
+
+    // 在途写入数不超过提交队列长度，完成队列（默认两倍长度）不会溢出
+    depth     = std::min( depth, params.sq_entries );
+    try {
+        _slots.resize( depth );
+        _free_slots.reserve( depth );
+        for ( unsigned i = depth; i > 0; --i ) {
+            _free_slots.push_back( i - 1 );
+        }
+    } catch ( ... ) {
+        close_ring();
+    }
+#else
+    (void)depth;
+#endif
+}
+
+CUringWriter::~CUringWriter() {
+    drain();
+    close_ring();
+}
+
+void CUringWriter::write( int fd, uint64_t offset, BufferPtr buffer ) noexcept {
+    if ( !buffer || buffer->length() == 0 ) {
+        _pool.release( std::move( buffer ) );
+        return;
+    }
+
+    while ( _ring_fd >= 0 && !_unsupported && _free_slots.empty() ) {
+        enter( 1 );
+        process_completions();
+    }
+
+    if ( _ring_fd < 0 || _unsupported ) {
+        if ( !utils::pwrite_fully( fd, buffer->data(), buffer->length(),
+                                   static_cast< off_t >( offset ) ) ) {
+            std::cerr << "failed to write log file: " << strerror( errno ) << std::endl;
+            _all_success = false;
+        }
+        _pool.release( std::move( buffer ) );
+        return;
+    }
+
+    unsigned index = _free_slots.back();
+    _free_slots.pop_back();
+    Slot& slot   = _slots[ index ];
+    slot._buffer = std::move( buffer );
+    slot._fd     = fd;
+    slot._offset = offset;
+    slot._done   = 0;
+    ++_in_flight;
+    prepare( index );
+}
+
+void CUringWriter::reap() noexcept {
+    if ( _in_flight == 0 ) {
+        return;
+    }
+    enter( 0 );
+    process_completions();
+}
+
+bool CUringWriter::drain() noexcept {
+    auto deadline = std::chrono::steady_clock::now() + kQuiesceTimeout;
+    while ( _in_flight > 0 ) {
+        if ( enter( 1 ) ) {
+            process_completions();
+            continue;
+        }
+        // 环已失效，已提交的写入只能从完成队列中等到；内核迟迟不给出完成事件时放弃这些缓冲区，
+        // 宁可泄漏也不让它们被重新填充后再被迟到的写入落盘
+        process_completions();
+        if ( std::chrono::steady_clock::now() >= deadline ) {
+            abandon_submitted();
+            break;
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 1 } );
+    }
+    return std::exchange( _all_success, true );
+}
+
+void CUringWriter::prepare( unsigned index ) noexcept {
+#if JZLOG_HAVE_IO_URING
+    const Slot& slot = _slots[ index ];
+    unsigned    tail = *_sq_tail;
+    unsigned    pos  = tail & *_sq_mask;
+
+    auto* sqe        = static_cast< struct io_uring_sqe* >( _sqes ) + pos;
+    std::memset( sqe, 0, sizeof( *sqe ) );
+    sqe->opcode    = IORING_OP_WRITE;
+    sqe->fd        = slot._fd;
+    sqe->addr      = reinterpret_cast< uint64_t >( slot._buffer->data() + slot._done );
+    sqe->len       = static_cast< uint32_t >( slot._buffer->length() - slot._done );
+    sqe->off       = slot._offset + slot._done;
+    sqe->user_data = index;
+
+    _sq_array[ pos ] = pos;
+    __atomic_store_n( _sq_tail, tail + 1, __ATOMIC_RELEASE );
+    ++_to_submit;
+#else
+    (void)index;
+#endif
+}
+
+bool CUringWriter::enter( unsigned wait_nr ) noexcept {
+#if JZLOG_HAVE_IO_URING
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for ( ;; ) {
+        long ret = ::syscall( __NR_io_uring_enter, _ring_fd, _to_submit, wait_nr, flags, nullptr,
+                              0 );
+        if ( ret >= 0 ) {
+            _to_submit -= std::min( _to_submit, static_cast< unsigned >( ret ) );
+            return true;
+        }
+        if ( errno != EINTR ) {
+            break;
+        }
+    }
+
+    // 环已不可用：内核从未见过的提交队列项从队尾撤回，改用 pwrite 按显式偏移写完；已提交的
+    // 写入可能仍在内核中执行，缓冲区保留到收到完成事件为止，提前归还会被重新填充后再次落盘
+    if ( !_unsupported ) {
+        std::cerr << "failed to enter io_uring: " << strerror( errno ) << std::endl;
+    }
+    _unsupported   = true;
+    unsigned tail  = *_sq_tail;
+    unsigned first = tail - _to_submit;
+    __atomic_store_n( _sq_tail, first, __ATOMIC_RELEASE );
+    _to_submit = 0;
+    // 撤回后的提交队列项内容仍在，write_sync() 不会再准备新的提交队列项
+    for ( unsigned pos = first; pos != tail; ++pos ) {
+        const auto* sqe = static_cast< const struct io_uring_sqe* >( _sqes ) + ( pos & *_sq_mask );
+        write_sync( static_cast< unsigned >( sqe->user_data ) );
+    }
+#else
+    (void)wait_nr;
+#endif
+    return false;
+}
+
+void CUringWriter::write_sync( unsigned index ) noexcept {
+    Slot& slot = _slots[ index ];
+    if ( !utils::pwrite_fully( slot._fd, slot._buffer->data() + slot._done,
+                               slot._buffer->length() - slot._done,
+                               static_cast< off_t >( slot._offset + slot._done ) ) ) {
+        std::cerr << "failed to write log file: " << strerror( errno ) << std::endl;
+        _all_success = false;
+    }
+    finish( index );
+}
+
+void CUringWriter::process_completions() noexcept {
+#if JZLOG_HAVE_IO_URING
+    unsigned head = *_cq_head;
+    unsigned tail = __atomic_load_n( _cq_tail, __ATOMIC_ACQUIRE );
+    while ( head != tail ) {
+        const auto* cqe = static_cast< const struct io_uring_cqe* >( _cqes ) + ( head & *_cq_mask );
+        auto        index = static_cast< unsigned >( cqe->user_data );
+        int         res   = cqe->res;
+        ++head;
+
+        // 退回 pwrite 后已结束的写入可能仍有迟到的完成事件
+        if ( index >= _slots.size() || !_slots[ index ]._buffer ) {
+            continue;
+        }
+
+        // 环失效后到达的完成事件不再重新提交，剩余部分以 pwrite 写完
+        Slot& slot = _slots[ index ];
+        if ( res > 0 ) {
+            slot._done += static_cast< size_t >( res );
+            if ( slot._done >= slot._buffer->length() ) {
+                finish( index );
+            } else if ( _unsupported ) {
+                write_sync( index );
+            } else {
+                prepare( index );  // 短写，继续提交剩余部分
+            }
+        } else if ( ( res == -EINTR || res == -EAGAIN ) && !_unsupported ) {
+            prepare( index );
+        } else {
+            if ( res == -EINVAL || res == -EOPNOTSUPP ) {
+                _unsupported = true;  // 内核不支持 IORING_OP_WRITE（早于 5.6）
+            }
+            write_sync( index );
+        }
+    }
+    __atomic_store_n( _cq_head, head, __ATOMIC_RELEASE );
+#endif
+}
+
+void CUringWriter::finish( unsigned index ) noexcept {
+    Slot& slot = _slots[ index ];
+    _pool.release( std::move( slot._buffer ) );
+    slot._buffer = nullptr;
+    slot._fd     = -1;
+    --_in_flight;
+    _free_slots.push_back( index );
+}
+
+void CUringWriter::abandon_submitted() noexcept {
+    for ( unsigned i = 0; i < _slots.size(); ++i ) {
+        Slot& slot = _slots[ i ];
+        if ( slot._buffer ) {
+            std::cerr << "abandoning io_uring write at offset " << slot._offset << std::endl;
+            (void)slot._buffer.release();
+            slot._fd = -1;
+            --_in_flight;
+            _all_success = false;
+        }
+    }
+}
+
+void CUringWriter::close_ring() noexcept {
+#if JZLOG_HAVE_IO_URING
+    if ( _sqes ) {
+        ::munmap( _sqes, _sqes_size );
+        _sqes = nullptr;
+    }
+    if ( _cq_ring && _cq_ring != _sq_ring ) {
+        ::munmap( _cq_ring, _cq_ring_size );
+    }
+    _cq_ring = nullptr;
+    if ( _sq_ring ) {
+        ::munmap( _sq_ring, _sq_ring_size );
+        _sq_ring = nullptr;
+    }
+    if ( _ring_fd >= 0 ) {
+        ::close( _ring_fd );
+        _ring_fd = -1;
+    }
+#endif
+}
+
+}  // namespace sinks
+}  // namespace jzlog
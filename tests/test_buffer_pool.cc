@@ -0,0 +1,107 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/file_sink.h"
+#include "jzlog/utils/buffer_pool.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+void test_buffer() {
+    utils::CBuffer buffer( 8 );
+    check( "buffer_append", buffer.append( "1234", 4 ) && buffer.length() == 4 );
+    check( "buffer_overflow", !buffer.append( "56789", 5 ) && buffer.avail() == 4 );
+    buffer.reset();
+    check( "buffer_reset", buffer.length() == 0 && buffer.capacity() == 8 );
+}
+
+void test_pool_bound() {
+    utils::CBufferPool pool( 4096, 2, 2 );
+    check( "pool_prefault", pool.free_count() == 2 );
+
+    std::vector< utils::CBufferPool::BufferPtr > taken;
+    for ( int i = 0; i < 5; ++i ) {
+        taken.emplace_back( pool.acquire() );
+    }
+    check( "pool_grows_on_demand", taken.size() == 5 && taken.back() != nullptr &&
+                                       taken.back()->capacity() == 4096 &&
+                                       pool.free_count() == 0 );
+
+    taken.front()->append( "x", 1 );
+    for ( auto& buffer : taken ) {
+        pool.release( std::move( buffer ) );
+    }
+    check( "pool_bounded", pool.free_count() == 2 );
+
+    auto buffer = pool.acquire();
+    check( "pool_reuse_reset", buffer->length() == 0 );
+
+    pool.release( std::make_unique< utils::CBuffer >( 1024 ) );
+    check( "pool_rejects_foreign_size", pool.free_count() == 1 );
+}
+
+/**
+ * @brief 目录构造函数可用，且缓冲区大小生效（小缓冲区下频繁换缓冲区也不丢记录）
+ */
+void test_file_sink_buffer_size() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_buffer_pool";
+    std::filesystem::remove_all( dir );
+
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 64 * 1024 * 1024, 4096, dir.string(), true );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 2000; ++i ) {
+            r._message = "record " + std::to_string( i );
+            sink.write( r );
+        }
+        r._message.assign( 8192, 'x' );
+        check( "file_sink_accepts_oversized", sink.write( r ) );
+        sink.flush();
+    }
+
+    size_t lines = 0;
+    for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+        if ( entry.path().filename() == sinks::MANIFEST_FILE_NAME ) {
+            continue;
+        }
+        std::ifstream in( entry.path() );
+        std::string   line;
+        while ( std::getline( in, line ) ) {
+            ++lines;
+        }
+    }
+    check( "file_sink_buffer_size", lines == 2001 );
+    if ( lines != 2001 ) {
+        std::cout << "lines=" << lines << std::endl;
+    }
+    std::filesystem::remove_all( dir );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test buffer_pool begin" << std::endl;
+    test_buffer();
+    test_pool_bound();
+    test_file_sink_buffer_size();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test buffer_pool end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#include "jzlog/core/deferred_record.h"
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/core/logger_config.h"
+#include "jzlog/logger.hpp"
+#include "jzlog/sinks/sink.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+template < class... Args >
+std::string round_trip( const char* fmt, const Args&... args ) {
+    size_t      size = deferred::encoded_size( args... );
+    std::string bytes( size, '\0' );
+    deferred::encode( bytes.data(), size, LogLevel::INFO, kUnknownLocation, 0, fmt, args... );
+
+    std::string out;
+    deferred::format_message( bytes.data(), out );
+    return out;
+}
+
+void check( const std::string& name, const std::string& actual, const std::string& expected ) {
+    if ( actual == expected ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed: expected \"" << expected << "\", got \"" << actual << "\""
+                  << std::endl;
+    }
+}
+
+void test_encode_decode() {
+    check( "no_args", round_trip( "hello" ), "hello" );
+    check( "ints", round_trip( "%d %u %lld", -1, 2u, 3ll ), "-1 2 3" );
+    check( "double", round_trip( "%.2f %.1f", 3.14159, 2.5f ), "3.14 2.5" );
+    check( "char", round_trip( "%c", 'x' ), "x" );
+
+    char        mutable_str[] = "mutable";
+    const char* null_str      = nullptr;
+    check( "strings", round_trip( "%s-%s-%s", "literal", mutable_str, null_str ),
+           "literal-mutable-(null)" );
+
+    std::string large( 5000, 'y' );
+    check( "large", round_trip( "%s", large.c_str() ), large );
+}
+
+/**
+ * @class CCaptureSink
+ * @brief 收集后台线程写入的消息
+ */
+class CCaptureSink final : public sinks::ISink {
+public:
+    explicit CCaptureSink( std::vector< std::string >& out ) : _out( out ) {}
+    bool write( const LogRecord& r ) override {
+        std::lock_guard lock{ _mutex };
+        _out.push_back( r._message );
+        return true;
+    }
+    bool     flush() noexcept override { return true; }
+    void     set_level( LogLevel lvl ) noexcept override { _level = lvl; }
+    LogLevel level() const noexcept override { return _level; }
+    bool     should_log( LogLevel lvl ) const noexcept override { return lvl >= _level; }
+    void     set_enabled( bool enabled ) noexcept override { (void)enabled; }
+    bool     enabled() const noexcept override { return true; }
+
+private:
+    std::vector< std::string >& _out;
+    std::mutex                  _mutex;
+    LogLevel                    _level{ LogLevel::INFO };
+};
+
+void test_deferred_logger() {
+    std::vector< std::string > messages;
+    {
+        LoggerConfig config;
+        config.mode = LogMode::DEFERRED;
+        CLogger logger( config );
+        logger.add_sink( std::make_unique< CCaptureSink >( messages ) );
+
+        for ( int i = 0; i < 100; ++i ) {
+            logger.info( "message %d %s", i, "deferred" );
+            logger.debug( "filtered %d", i );
+        }
+    }
+
+    if ( messages.size() != 100 ) {
+        ++test_fail;
+        std::cout << "test_deferred_logger failed(count=" << messages.size() << ")" << std::endl;
+        return;
+    }
+    check( "deferred_first", messages.front(), "message 0 deferred" );
+    check( "deferred_last", messages.back(), "message 99 deferred" );
+}
+
+void test_deferred_threads() {
+    std::vector< std::string > messages;
+    {
+        LoggerConfig config;
+        config.mode      = LogMode::DEFERRED;
+        config.ring_size = 4096;
+        CLogger logger( config );
+        logger.add_sink( std::make_unique< CCaptureSink >( messages ) );
+
+        std::vector< std::thread > threads;
+        for ( int t = 0; t < 8; ++t ) {
+            threads.emplace_back( [ &logger, t ]() {
+                for ( int i = 0; i < 1000; ++i ) {
+                    logger.info( "thread %d message %d", t, i );
+                }
+            } );
+        }
+        for ( auto& thread : threads ) {
+            thread.join();
+        }
+    }
+
+    if ( messages.size() == 8000 ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_deferred_threads failed(count=" << messages.size() << ")" << std::endl;
+    }
+}
+
+/**
+ * @class CTimestampSink
+ * @brief 收集记录的时间戳
+ */
+class CTimestampSink final : public sinks::ISink {
+public:
+    explicit CTimestampSink( std::vector< std::chrono::system_clock::time_point >& out ) :
+        _out( out ) {}
+    bool write( const LogRecord& r ) override {
+        std::lock_guard lock{ _mutex };
+        _out.push_back( r._timestamp );
+        return true;
+    }
+    bool     flush() noexcept override { return true; }
+    void     set_level( LogLevel lvl ) noexcept override { _level = lvl; }
+    LogLevel level() const noexcept override { return _level; }
+    bool     should_log( LogLevel lvl ) const noexcept override { return lvl >= _level; }
+    void     set_enabled( bool enabled ) noexcept override { (void)enabled; }
+    bool     enabled() const noexcept override { return true; }
+
+private:
+    std::vector< std::chrono::system_clock::time_point >& _out;
+    std::mutex                                            _mutex;
+    LogLevel                                              _level{ LogLevel::TRACE };
+};
+
+void test_clock_sources() {
+    const utils::ClockSource sources[] = { utils::ClockSource::SYSTEM,
+                                           utils::ClockSource::REALTIME_COARSE,
+                                           utils::ClockSource::TSC };
+    const LogMode            modes[]   = { LogMode::SYNC, LogMode::DEFERRED };
+
+    for ( auto source : sources ) {
+        for ( auto mode : modes ) {
+            std::vector< std::chrono::system_clock::time_point > stamps;
+            auto before = std::chrono::system_clock::now();
+            {
+                LoggerConfig config;
+                config.mode  = mode;
+                config.clock = source;
+                CLogger logger( config );
+                logger.add_sink( std::make_unique< CTimestampSink >( stamps ) );
+                logger.info( "timestamp %d", 1 );
+            }
+            auto after = std::chrono::system_clock::now();
+
+            // 粗粒度时钟与 TSC 换算允许 10 毫秒误差
+            auto slack = std::chrono::milliseconds( 10 );
+            if ( stamps.size() == 1 && stamps[ 0 ] >= before - slack &&
+                 stamps[ 0 ] <= after + slack ) {
+                ++test_pass;
+            } else {
+                ++test_fail;
+                std::cout << "test_clock_sources failed(source=" << static_cast< int >( source )
+                          << ", mode=" << static_cast< int >( mode ) << ")" << std::endl;
+            }
+        }
+    }
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test deferred_record begin" << std::endl;
+    test_encode_decode();
+    test_deferred_logger();
+    test_deferred_threads();
+    test_clock_sources();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test deferred_record end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include "jzlog/sinks/disk_spool.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/uio.h>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+bool push( sinks::CDiskSpool& spool, const std::string& payload, uint32_t records ) {
+    struct iovec iov{ const_cast< char* >( payload.data() ), payload.size() };
+    return spool.push( &iov, 1, records );
+}
+
+size_t count_segments( const std::filesystem::path& dir ) {
+    size_t count = 0;
+    for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+        count += entry.path().extension() == ".seg" ? 1 : 0;
+    }
+    return count;
+}
+
+/**
+ * @brief 批次按写入顺序读出，分段写满后换新分段，读完的分段被删除
+ */
+void test_order_and_rotation( const std::filesystem::path& dir ) {
+    sinks::CDiskSpool spool( dir.string(), 1024 * 1024, 1024 );
+    check( "order_valid", spool.valid() && spool.empty() );
+
+    bool pushed = true;
+    for ( int i = 0; i < 100; ++i ) {
+        pushed = push( spool, "batch " + std::to_string( i ) + std::string( 100, 'x' ),
+                       static_cast< uint32_t >( i ) ) &&
+                 pushed;
+    }
+    check( "order_pushed", pushed );
+    check( "order_rotated", count_segments( dir ) > 5 );
+
+    bool        ordered = true;
+    std::string payload;
+    uint32_t    records = 0;
+    for ( int i = 0; i < 100; ++i ) {
+        ordered = ordered && spool.front( payload, records ) &&
+                  payload == "batch " + std::to_string( i ) + std::string( 100, 'x' ) &&
+                  records == static_cast< uint32_t >( i );
+        spool.pop();
+    }
+    check( "order_in_order", ordered );
+    check( "order_drained", spool.empty() && !spool.front( payload, records ) );
+    check( "order_segments_removed", count_segments( dir ) == 1 );
+}
+
+/**
+ * @brief 超过 max_bytes 时拒绝新批次，读出后恢复接受
+ */
+void test_cap( const std::filesystem::path& dir ) {
+    sinks::CDiskSpool spool( dir.string(), 1000, 4096 );
+    std::string       payload( 184, 'c' );
+    int               accepted = 0;
+    for ( int i = 0; i < 10; ++i ) {
+        accepted += push( spool, payload, 1 ) ? 1 : 0;
+    }
+    check( "cap_limited", accepted == 5 && spool.bytes() == 1000 );
+
+    uint32_t records = 0;
+    spool.front( payload, records );
+    spool.pop();
+    check( "cap_accepts_after_pop", push( spool, payload, 1 ) );
+}
+
+/**
+ * @brief 重新打开后从 cursor 记录的位置继续读取，尾部残缺的批次被截掉
+ */
+void test_resume( const std::filesystem::path& dir ) {
+    {
+        sinks::CDiskSpool spool( dir.string(), 1024 * 1024, 1024 );
+        for ( int i = 0; i < 30; ++i ) {
+            push( spool, "resume " + std::to_string( i ) + std::string( 100, 'r' ), 1 );
+        }
+        std::string payload;
+        uint32_t    records = 0;
+        for ( int i = 0; i < 12; ++i ) {
+            spool.front( payload, records );
+            spool.pop();
+        }
+    }
+
+    // 模拟写到一半时进程退出
+    std::filesystem::path tail;
+    for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+        if ( entry.path().extension() == ".seg" && entry.path() > tail ) {
+            tail = entry.path();
+        }
+    }
+    {
+        std::ofstream out( tail, std::ios::binary | std::ios::app );
+        out << "JZSP torn";
+    }
+
+    sinks::CDiskSpool spool( dir.string(), 1024 * 1024, 1024 );
+    std::string       payload;
+    uint32_t          records = 0;
+    bool              resumed = true;
+    for ( int i = 12; i < 30; ++i ) {
+        resumed = resumed && spool.front( payload, records ) &&
+                  payload == "resume " + std::to_string( i ) + std::string( 100, 'r' );
+        spool.pop();
+    }
+    check( "resume_from_cursor", resumed );
+    check( "resume_torn_tail_dropped", spool.empty() && !spool.front( payload, records ) );
+    check( "resume_appendable", push( spool, "after", 1 ) && spool.front( payload, records ) &&
+                                    payload == "after" );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test disk_spool begin" << std::endl;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_disk_spool";
+    for ( auto test : { test_order_and_rotation, test_cap, test_resume } ) {
+        std::filesystem::remove_all( dir );
+        test( dir );
+    }
+    std::filesystem::remove_all( dir );
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test disk_spool end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
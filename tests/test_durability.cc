@@ -0,0 +1,222 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/file_sink.h"
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+std::filesystem::path make_dir( const std::string& name ) {
+    auto dir = std::filesystem::temp_directory_path() / ( "jzlog_test_durability_" + name );
+    std::filesystem::remove_all( dir );
+    return dir;
+}
+
+size_t count_lines( const std::filesystem::path& dir ) {
+    size_t lines = 0;
+    for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+        if ( entry.path().filename() == sinks::MANIFEST_FILE_NAME ) {
+            continue;
+        }
+        std::ifstream in( entry.path() );
+        std::string   line;
+        while ( std::getline( in, line ) ) {
+            ++lines;
+        }
+    }
+    return lines;
+}
+
+sinks::FileSinkConfig make_config( sinks::DurabilityPolicy policy ) {
+    sinks::FileSinkConfig config;
+    config.durability = policy;
+    return config;
+}
+
+/**
+ * @brief NONE 策略从不 fdatasync，等待持久化直接返回 false
+ */
+void test_none() {
+    auto dir = make_dir( "none" );
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 64 * 1024 * 1024, 4096, dir.string(), true,
+                               make_config( sinks::DurabilityPolicy::NONE ) );
+        LogRecord        r;
+        r._level   = LogLevel::ERROR;
+        r._message = "none";
+        check( "none_write", sink.write( r ) );
+        check( "none_sequence", sink.sequence() > 0 );
+        check( "none_wait_refused",
+               !sink.wait_durable_for( sink.sequence(), std::chrono::milliseconds( 10 ) ) );
+        check( "none_no_sync", sink.sync_count() == 0 );
+    }
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 组提交：多线程并发写入时多条记录共用一次 fdatasync，等待序号后数据已落盘
+ */
+void test_group_commit() {
+    auto dir = make_dir( "group" );
+
+    constexpr int kThreads   = 4;
+    constexpr int kPerThread = 2000;
+    {
+        auto config             = make_config( sinks::DurabilityPolicy::GROUP_COMMIT );
+        config.commit_window_us = 1000;
+        sinks::CFileSink sink( LogLevel::INFO, 64 * 1024 * 1024, 4096, dir.string(), true,
+                               config );
+        sink.set_pattern( "%v%n" );
+
+        std::vector< std::thread > workers;
+        for ( int t = 0; t < kThreads; ++t ) {
+            workers.emplace_back( [ &sink, t ]() {
+                LogRecord r;
+                r._level = LogLevel::INFO;
+                for ( int i = 0; i < kPerThread; ++i ) {
+                    r._message = "t" + std::to_string( t ) + " " + std::to_string( i );
+                    sink.write( r );
+                }
+            } );
+        }
+        for ( auto& worker : workers ) {
+            worker.join();
+        }
+
+        uint64_t seq = sink.sequence();
+        check( "group_wait", sink.wait_durable_for( seq, std::chrono::seconds( 5 ) ) );
+        check( "group_durable_sequence", sink.durable_sequence() >= seq );
+        check( "group_batched", sink.sync_count() > 0 &&
+                                    sink.sync_count() < kThreads * kPerThread / 10 );
+        check( "group_visible", count_lines( dir ) == kThreads * kPerThread );
+    }
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief SYNC_ON_LEVEL：ERROR 记录返回时已持久化，INFO 记录不触发 fdatasync
+ */
+void test_sync_on_level() {
+    auto dir = make_dir( "level" );
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 64 * 1024 * 1024, 4096, dir.string(), true,
+                               make_config( sinks::DurabilityPolicy::SYNC_ON_LEVEL ) );
+        LogRecord        r;
+        r._level   = LogLevel::INFO;
+        r._message = "info";
+        for ( int i = 0; i < 100; ++i ) {
+            sink.write( r );
+        }
+        check( "level_info_no_sync", sink.sync_count() == 0 );
+
+        r._level   = LogLevel::ERROR;
+        r._message = "error";
+        check( "level_error_write", sink.write( r ) );
+        check( "level_error_durable", sink.durable_sequence() == sink.sequence() );
+        check( "level_error_synced", sink.sync_count() >= 1 );
+        check( "level_error_visible", count_lines( dir ) == 101 );
+    }
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief PERIODIC：有新数据时按间隔 fdatasync，也接受显式等待
+ */
+void test_periodic() {
+    auto dir = make_dir( "periodic" );
+    {
+        auto config             = make_config( sinks::DurabilityPolicy::PERIODIC );
+        config.sync_interval_ms = 50;
+        sinks::CFileSink sink( LogLevel::INFO, 64 * 1024 * 1024, 4096, dir.string(), true,
+                               config );
+        LogRecord        r;
+        r._level   = LogLevel::INFO;
+        r._message = "periodic";
+        sink.write( r );
+
+        uint64_t seq      = sink.sequence();
+        auto     deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 5 );
+        while ( sink.durable_sequence() < seq && std::chrono::steady_clock::now() < deadline ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        }
+        check( "periodic_synced", sink.durable_sequence() >= seq );
+
+        sink.write( r );
+        check( "periodic_wait",
+               sink.wait_durable_for( sink.sequence(), std::chrono::seconds( 5 ) ) );
+    }
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 写入失败（超过文件大小限制，只写入一部分）时 SYNC_ON_LEVEL 返回 false，已持久化序号
+ *        不覆盖失败的记录，之后的等待同样返回 false
+ */
+void test_write_failure() {
+    auto dir = make_dir( "failure" );
+
+    // 超过 RLIMIT_FSIZE 的写入返回 EFBIG；忽略 SIGXFSZ 以免进程被终止
+    struct rlimit saved_limit;
+    ::getrlimit( RLIMIT_FSIZE, &saved_limit );
+    auto saved_handler = std::signal( SIGXFSZ, SIG_IGN );
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 64 * 1024 * 1024, 4096, dir.string(), true,
+                               make_config( sinks::DurabilityPolicy::SYNC_ON_LEVEL ) );
+        sink.set_pattern( "%v%n" );
+        LogRecord r;
+        r._level   = LogLevel::ERROR;
+        r._message = "before";
+        check( "failure_first_write", sink.write( r ) );
+        uint64_t durable = sink.durable_sequence();
+
+        struct rlimit limit = saved_limit;
+        limit.rlim_cur      = 64 * 1024;
+        ::setrlimit( RLIMIT_FSIZE, &limit );
+        r._message.assign( 200 * 1024, 'x' );
+        auto start = std::chrono::steady_clock::now();
+        check( "failure_write_reported", !sink.write( r ) );
+        check( "failure_not_blocked",
+               std::chrono::steady_clock::now() - start < std::chrono::seconds( 2 ) );
+        check( "failure_not_durable", sink.durable_sequence() == durable );
+        ::setrlimit( RLIMIT_FSIZE, &saved_limit );
+
+        r._message = "after";
+        check( "failure_latched", !sink.write( r ) );
+        check( "failure_wait_refused",
+               !sink.wait_durable_for( sink.sequence(), std::chrono::seconds( 2 ) ) );
+    }
+    std::signal( SIGXFSZ, saved_handler );
+    std::filesystem::remove_all( dir );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test durability begin" << std::endl;
+    test_none();
+    test_group_commit();
+    test_sync_on_level();
+    test_periodic();
+    test_write_failure();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test durability end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+#include "jzlog/utils/fd_writer.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+volatile sig_atomic_t g_signals = 0;
+
+void on_alarm( int ) { g_signals = g_signals + 1; }
+
+/**
+ * @brief 向管道写入远大于管道容量的数据，读端缓慢读取以制造短写；
+ *        同时用不带 SA_RESTART 的定时信号打断阻塞中的 writev，制造 EINTR
+ */
+void test_short_write_and_eintr() {
+    int fds[ 2 ];
+    if ( pipe( fds ) != 0 ) {
+        ++test_fail;
+        std::cout << "test_short_write_and_eintr failed(pipe)" << std::endl;
+        return;
+    }
+
+    // 三段不等长数据，长度合计 4MB 左右，并包含一个空段
+    std::vector< std::string > parts;
+    parts.emplace_back( 1024 * 1024 + 17, '\0' );
+    parts.emplace_back();
+    parts.emplace_back( 3 * 1024 * 1024 - 5, '\0' );
+    uint32_t seed = 1;
+    for ( auto& part : parts ) {
+        for ( auto& c : part ) {
+            seed = seed * 1103515245 + 12345;
+            c    = static_cast< char >( seed >> 24 );
+        }
+    }
+
+    std::string received;
+    std::thread reader( [ &received, fd = fds[ 0 ] ]() {
+        char buf[ 8192 ];
+        for ( ;; ) {
+            ssize_t n = read( fd, buf, sizeof( buf ) );
+            if ( n <= 0 ) {
+                break;
+            }
+            received.append( buf, static_cast< size_t >( n ) );
+            if ( received.size() % ( 256 * 1024 ) < sizeof( buf ) ) {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            }
+        }
+    } );
+
+    struct sigaction sa;
+    std::memset( &sa, 0, sizeof( sa ) );
+    sa.sa_handler = on_alarm;
+    sigaction( SIGALRM, &sa, nullptr );
+    struct itimerval timer;
+    timer.it_interval = { 0, 500 };
+    timer.it_value    = { 0, 500 };
+    setitimer( ITIMER_REAL, &timer, nullptr );
+
+    std::vector< struct iovec > iov;
+    for ( auto& part : parts ) {
+        iov.push_back( { part.data(), part.size() } );
+    }
+    bool ok = utils::write_fully( fds[ 1 ], iov.data(), static_cast< int >( iov.size() ) );
+
+    timer.it_interval = { 0, 0 };
+    timer.it_value    = { 0, 0 };
+    setitimer( ITIMER_REAL, &timer, nullptr );
+    close( fds[ 1 ] );
+    reader.join();
+    close( fds[ 0 ] );
+
+    std::string expected = parts[ 0 ] + parts[ 1 ] + parts[ 2 ];
+    if ( ok && received == expected ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_short_write_and_eintr failed(ok=" << ok
+                  << ", received=" << received.size() << ", expected=" << expected.size()
+                  << ")" << std::endl;
+    }
+}
+
+void test_error() {
+    if ( !utils::write_fully( -1, "x", 1 ) && errno == EBADF ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_error failed" << std::endl;
+    }
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test fd_writer begin" << std::endl;
+    test_short_write_and_eintr();
+    test_error();
+    std::cout << "signals:" << g_signals << std::endl;
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test fd_writer end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
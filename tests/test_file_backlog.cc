@@ -0,0 +1,236 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/file_sink.h"
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+std::string today_str() {
+    std::time_t now = std::time( nullptr );
+    std::tm     tm_buf{};
+    localtime_r( &now, &tm_buf );
+    char buf[ 16 ];
+    std::strftime( buf, sizeof( buf ), "%Y%m%d", &tm_buf );
+    return buf;
+}
+
+/**
+ * @class CStalledDisk
+ * @brief 以命名管道充当第一个日志文件：不读取时写入线程阻塞在 write 上，模拟磁盘卡顿
+ */
+class CStalledDisk {
+public:
+    explicit CStalledDisk( const std::filesystem::path& dir ) {
+        std::filesystem::remove_all( dir );
+        std::filesystem::create_directories( dir );
+        auto path = dir / ( today_str() + "_000" );
+        ::mkfifo( path.c_str(), 0644 );
+        _fd = ::open( path.c_str(), O_RDONLY | O_NONBLOCK );
+    }
+
+    ~CStalledDisk() {
+        resume();
+        if ( _reader.joinable() ) {
+            _reader.join();
+        }
+        ::close( _fd );
+    }
+
+    /**
+     * @brief 开始读取管道，解除写入线程的阻塞
+     */
+    void resume() {
+        if ( _reader.joinable() ) {
+            return;
+        }
+        _reader = std::thread( [ this ]() {
+            int flags = ::fcntl( _fd, F_GETFL );
+            ::fcntl( _fd, F_SETFL, flags & ~O_NONBLOCK );
+            char    buf[ 65536 ];
+            ssize_t n = 0;
+            while ( ( n = ::read( _fd, buf, sizeof( buf ) ) ) > 0 ) {
+                _content.append( buf, static_cast< size_t >( n ) );
+            }
+        } );
+    }
+
+    /**
+     * @brief 获取写入管道的全部内容，须在 sink 析构后调用
+     */
+    const std::string& content() {
+        if ( _reader.joinable() ) {
+            _reader.join();
+        }
+        return _content;
+    }
+
+private:
+    int         _fd{ -1 };
+    std::thread _reader;
+    std::string _content;
+};
+
+sinks::FileSinkConfig backlog_config( sinks::BacklogPolicy policy ) {
+    sinks::FileSinkConfig config;
+    config.rotation         = sinks::RotationPolicy::SIZE;
+    config.max_queued_bytes = 5 * 4096;
+    config.backlog_policy   = policy;
+    config.block_timeout_ms = 50;
+    return config;
+}
+
+size_t count_lines( const std::string& content, const std::string& prefix ) {
+    size_t count = 0;
+    size_t pos   = 0;
+    while ( ( pos = content.find( prefix, pos ) ) != std::string::npos ) {
+        ++count;
+        pos += prefix.size();
+    }
+    return count;
+}
+
+/**
+ * @brief 累加日志中所有丢弃报告的计数；写入期间积压清空过时丢弃计数会分多条报告
+ */
+uint64_t reported_drops( const std::string& content ) {
+    const std::string prefix = "WARN jzlog dropped ";
+    uint64_t          total  = 0;
+    size_t            pos    = 0;
+    while ( ( pos = content.find( prefix, pos ) ) != std::string::npos ) {
+        pos += prefix.size();
+        total += std::strtoull( content.c_str() + pos, nullptr, 10 );
+    }
+    return total;
+}
+
+/**
+ * @brief 磁盘卡顿时积压不超过上限，超出的记录被丢弃；恢复后丢弃计数写入日志
+ */
+void test_drop_newest() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_drop_newest";
+    CStalledDisk          disk( dir );
+
+    constexpr int kRecords = 20000;
+    int           accepted = 0;
+    uint64_t      dropped  = 0;
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 1024 * 1024 * 1024, 4096, dir.string(), true,
+                               backlog_config( sinks::BacklogPolicy::DROP_NEWEST ) );
+        sink.set_pattern( "%l %v%n" );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < kRecords; ++i ) {
+            r._message = "record " + std::to_string( i );
+            accepted += sink.write( r ) ? 1 : 0;
+        }
+        dropped = sink.dropped();
+        check( "drop_newest_dropped", dropped > 0 && dropped == sink.dropped( LogLevel::INFO ) );
+        check( "drop_newest_accounted", accepted + dropped == kRecords );
+
+        disk.resume();
+    }
+
+    const auto& content = disk.content();
+    check( "drop_newest_records_written",
+           count_lines( content, "INFO record " ) == static_cast< size_t >( accepted ) );
+    check( "drop_newest_reported", reported_drops( content ) == dropped );
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief BLOCK_TIMEOUT 下积压满时写入等待 block_timeout_ms 后丢弃
+ */
+void test_block_timeout() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_block";
+    CStalledDisk          disk( dir );
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 1024 * 1024 * 1024, 4096, dir.string(), true,
+                               backlog_config( sinks::BacklogPolicy::BLOCK_TIMEOUT ) );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level      = LogLevel::INFO;
+        r._message    = std::string( 100, 'x' );
+        bool blocked  = false;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+        while ( !blocked && std::chrono::steady_clock::now() < deadline ) {
+            auto start = std::chrono::steady_clock::now();
+            bool ok    = sink.write( r );
+            blocked    = !ok && std::chrono::steady_clock::now() - start >=
+                                 std::chrono::milliseconds{ 40 };
+        }
+        check( "block_timeout_waited", blocked );
+        check( "block_timeout_counted", sink.dropped() > 0 );
+
+        disk.resume();
+        r._message = "after resume";
+        check( "block_timeout_recovered", sink.write( r ) );
+    }
+    check( "block_timeout_written", disk.content().find( "after resume\n" ) != std::string::npos );
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief DROP_LOWEST_LEVEL 下低级别先被丢弃，高级别记录仍被接受
+ */
+void test_drop_lowest_level() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_drop_lowest";
+    CStalledDisk          disk( dir );
+    {
+        sinks::CFileSink sink( LogLevel::TRACE, 1024 * 1024 * 1024, 4096, dir.string(), true,
+                               backlog_config( sinks::BacklogPolicy::DROP_LOWEST_LEVEL ) );
+        sink.set_pattern( "%l %v%n" );
+
+        LogRecord r;
+        r._level   = LogLevel::DEBUG;
+        r._message = std::string( 100, 'd' );
+        for ( int i = 0; i < 20000 && sink.dropped( LogLevel::DEBUG ) == 0; ++i ) {
+            sink.write( r );
+        }
+        check( "lowest_debug_dropped", sink.dropped( LogLevel::DEBUG ) > 0 );
+
+        r._level   = LogLevel::ERROR;
+        r._message = "important";
+        check( "lowest_error_accepted", sink.write( r ) );
+        check( "lowest_error_not_dropped", sink.dropped( LogLevel::ERROR ) == 0 );
+
+        disk.resume();
+    }
+    const auto& content = disk.content();
+    check( "lowest_error_written", content.find( "ERROR important\n" ) != std::string::npos );
+    check( "lowest_reported", content.find( "WARN jzlog dropped " ) != std::string::npos );
+    std::filesystem::remove_all( dir );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test file_backlog begin" << std::endl;
+    test_drop_newest();
+    test_block_timeout();
+    test_drop_lowest_level();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test file_backlog end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
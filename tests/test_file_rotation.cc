@@ -0,0 +1,237 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/file_sink.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+std::vector< std::filesystem::path > list_dir( const std::filesystem::path& dir ) {
+    std::vector< std::filesystem::path > paths;
+    for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+        if ( entry.path().filename() == sinks::MANIFEST_FILE_NAME ) {
+            continue;
+        }
+        paths.push_back( entry.path() );
+    }
+    std::sort( paths.begin(), paths.end() );
+    return paths;
+}
+
+std::string read_file( const std::filesystem::path& path ) {
+    std::ifstream in( path, std::ios::binary );
+    return std::string( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+}
+
+/**
+ * @brief 时间边界落在本地时间的整点或零点，且在 now 之后一个周期以内
+ */
+void test_next_rotation_time() {
+    auto now = std::chrono::system_clock::now();
+
+    auto        hourly = sinks::next_rotation_time( sinks::RotationInterval::HOURLY, now );
+    std::time_t t      = std::chrono::system_clock::to_time_t( hourly );
+    std::tm     tm{};
+    localtime_r( &t, &tm );
+    check( "hourly_after_now", hourly > now && hourly <= now + std::chrono::hours{ 1 } );
+    check( "hourly_on_the_hour", tm.tm_min == 0 && tm.tm_sec == 0 );
+
+    auto daily = sinks::next_rotation_time( sinks::RotationInterval::DAILY, now );
+    t          = std::chrono::system_clock::to_time_t( daily );
+    localtime_r( &t, &tm );
+    check( "daily_after_now", daily > now && daily <= now + std::chrono::hours{ 25 } );
+    check( "daily_at_midnight", tm.tm_hour == 0 && tm.tm_min == 0 && tm.tm_sec == 0 );
+}
+
+/**
+ * @brief 备用文件在后台提前创建，析构时删除未使用的空备用文件
+ */
+void test_standby_preopened() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_standby";
+    std::filesystem::remove_all( dir );
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 1024 * 1024, 4096, dir.string(), true );
+        sink.set_pattern( "%v%n" );
+
+        bool preopened = false;
+        for ( int i = 0; i < 200 && !preopened; ++i ) {
+            preopened = list_dir( dir ).size() == 2;
+            std::this_thread::sleep_for( std::chrono::milliseconds{ 10 } );
+        }
+        check( "standby_preopened", preopened );
+
+        LogRecord r;
+        r._level   = LogLevel::INFO;
+        r._message = "hello";
+        sink.write( r );
+    }
+    auto paths = list_dir( dir );
+    check( "standby_removed", paths.size() == 1 );
+    check( "standby_content", paths.size() == 1 && read_file( paths.front() ) == "hello\n" );
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 只按时间滚动时超过 fileSize 也不切分文件
+ */
+void test_time_only() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_time_only";
+    std::filesystem::remove_all( dir );
+
+    std::string expected;
+    {
+        sinks::FileSinkConfig config;
+        config.rotation          = sinks::RotationPolicy::TIME;
+        config.rotation_interval = sinks::RotationInterval::HOURLY;
+        sinks::CFileSink sink( LogLevel::INFO, 16 * 1024, 4096, dir.string(), true, config );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 5000; ++i ) {
+            r._message = "record " + std::to_string( i );
+            sink.write( r );
+            expected += r._message + "\n";
+        }
+    }
+    auto paths = list_dir( dir );
+    check( "time_only_single_file", paths.size() == 1 );
+    check( "time_only_content", paths.size() == 1 && read_file( paths.front() ) == expected );
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 按大小滚动时依次换入备用文件，文件名顺序与写入顺序一致
+ */
+void test_size_rotation_order() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_size_order";
+    std::filesystem::remove_all( dir );
+
+    std::string expected;
+    {
+        sinks::FileSinkConfig config;
+        config.rotation = sinks::RotationPolicy::SIZE;
+        sinks::CFileSink sink( LogLevel::INFO, 8 * 1024, 4096, dir.string(), true, config );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 20000; ++i ) {
+            r._message = "record " + std::to_string( i );
+            sink.write( r );
+            expected += r._message + "\n";
+        }
+    }
+    auto        paths = list_dir( dir );
+    std::string content;
+    bool        bounded = true;
+    for ( const auto& path : paths ) {
+        auto part = read_file( path );
+        bounded   = bounded && part.size() <= 8 * 1024;
+        content += part;
+    }
+    check( "size_rotated", paths.size() > 10 );
+    check( "size_bounded", bounded );
+    check( "size_order", content == expected );
+    std::filesystem::remove_all( dir );
+}
+
+std::string today_str() {
+    std::time_t now = std::time( nullptr );
+    std::tm     tm_buf{};
+    localtime_r( &now, &tm_buf );
+    char buf[ 16 ];
+    std::strftime( buf, sizeof( buf ), "%Y%m%d", &tm_buf );
+    return buf;
+}
+
+std::string read_manifest( const std::filesystem::path& dir ) {
+    return read_file( dir / std::string( sinks::MANIFEST_FILE_NAME ) );
+}
+
+void touch( const std::filesystem::path& path ) { std::ofstream out( path ); }
+
+/**
+ * @brief 清单记录最近分配的索引；重启时沿用清单，清单落后时向后探测，缺失或损坏时遍历目录
+ */
+void test_manifest() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_manifest";
+    std::filesystem::remove_all( dir );
+    std::filesystem::create_directories( dir );
+    auto today = today_str();
+
+    sinks::FileSinkConfig config;
+    config.rotation = sinks::RotationPolicy::SIZE;
+    auto write_one  = [ & ]( const std::string& message ) {
+        sinks::CFileSink sink( LogLevel::INFO, 1024 * 1024, 4096, dir.string(), true, config );
+        sink.set_pattern( "%v%n" );
+        LogRecord r;
+        r._level   = LogLevel::INFO;
+        r._message = message;
+        sink.write( r );
+    };
+
+    // 清单中的索引包含准备线程提前打开的备用文件
+    write_one( "first" );
+    auto manifest = read_manifest( dir );
+    check( "manifest_written", manifest.compare( 0, today.size() + 1, today + " " ) == 0 );
+    check( "manifest_first", read_file( dir / ( today + "_000" ) ) == "first\n" );
+
+    // 清单之后已有文件（例如清单更新失败）时跳过它们
+    std::ofstream( dir / std::string( sinks::MANIFEST_FILE_NAME ) ) << today << " 0\n";
+    touch( dir / ( today + "_001" ) );
+    touch( dir / ( today + "_002" ) );
+    write_one( "probed" );
+    check( "manifest_probed", read_file( dir / ( today + "_003" ) ) == "probed\n" );
+
+    // 落后过多或清单损坏时遍历目录
+    std::ofstream( dir / std::string( sinks::MANIFEST_FILE_NAME ) ) << today << " 0\n";
+    for ( int i = 4; i < 20; ++i ) {
+        char idx[ 8 ];
+        std::snprintf( idx, sizeof( idx ), "_%03d", i );
+        touch( dir / ( today + idx ) );
+    }
+    write_one( "scanned" );
+    check( "manifest_stale_scanned", read_file( dir / ( today + "_020" ) ) == "scanned\n" );
+
+    std::ofstream( dir / std::string( sinks::MANIFEST_FILE_NAME ) ) << "garbage";
+    write_one( "corrupt" );
+    check( "manifest_corrupt_scanned", read_file( dir / ( today + "_021" ) ) == "corrupt\n" );
+    check( "manifest_no_tmp_left",
+           !std::filesystem::exists( dir / ( std::string( sinks::MANIFEST_FILE_NAME ) + ".tmp" ) ) );
+    std::filesystem::remove_all( dir );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test file_rotation begin" << std::endl;
+    test_next_rotation_time();
+    test_standby_preopened();
+    test_time_only();
+    test_size_rotation_order();
+    test_manifest();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test file_rotation end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/file_sink.h"
+#include "jzlog/utils/reserve_word.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+/**
+ * @brief 按文件名顺序拼接目录下所有日志文件的内容
+ */
+std::string read_dir( const std::filesystem::path& dir, size_t& files ) {
+    std::vector< std::filesystem::path > paths;
+    for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+        if ( entry.path().filename() == sinks::MANIFEST_FILE_NAME ) {
+            continue;
+        }
+        paths.push_back( entry.path() );
+    }
+    std::sort( paths.begin(), paths.end() );
+    files = paths.size();
+
+    std::string content;
+    for ( const auto& path : paths ) {
+        std::ifstream in( path, std::ios::binary );
+        content.append( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+    }
+    return content;
+}
+
+/**
+ * @brief 多线程写入小缓冲区，同时另一线程反复 flush；每个线程的记录完整、有序且序号递增，
+ *        其间穿插的超过缓冲区大小的记录同样按顺序写入
+ */
+void run_concurrent( const std::string& name, const sinks::FileSinkConfig& config ) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / ( "jzlog_test_" + name );
+    std::filesystem::remove_all( dir );
+
+    constexpr int kThreads   = 8;
+    constexpr int kPerThread = 20000;
+    constexpr int kLargeStep = 1000;
+    bool          monotonic  = true;
+    bool          accepted   = true;
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 256 * 1024, 4096, dir.string(), true, config );
+        sink.set_pattern( "%v%n" );
+
+        std::atomic< bool >        stop{ false };
+        std::atomic< int >         regressions{ 0 };
+        std::atomic< int >         rejected{ 0 };
+        std::vector< std::thread > workers;
+        for ( int t = 0; t < kThreads; ++t ) {
+            workers.emplace_back( [ &sink, &regressions, &rejected, t ]() {
+                LogRecord r;
+                r._level      = LogLevel::INFO;
+                uint64_t last = 0;
+                for ( int i = 0; i < kPerThread; ++i ) {
+                    r._message = "t" + std::to_string( t ) + " " + std::to_string( i );
+                    if ( i % kLargeStep == 0 ) {
+                        r._message.resize( 10000, 'x' );
+                    }
+                    if ( !sink.write( r ) ) {
+                        ++rejected;
+                    }
+                    uint64_t seq = sink.sequence();
+                    if ( seq < last ) {
+                        ++regressions;
+                    }
+                    last = seq;
+                }
+            } );
+        }
+        std::thread flusher( [ &sink, &stop ]() {
+            while ( !stop ) {
+                sink.flush();
+                std::this_thread::yield();
+            }
+        } );
+        for ( auto& worker : workers ) {
+            worker.join();
+        }
+        stop = true;
+        flusher.join();
+        monotonic = regressions == 0;
+        accepted  = rejected == 0;
+    }
+
+    size_t             files   = 0;
+    auto               content = read_dir( dir, files );
+    std::vector< int > next( kThreads, 0 );
+    bool               ordered = true;
+    std::istringstream in( content );
+    std::string        line;
+    while ( std::getline( in, line ) ) {
+        int t = 0;
+        int i = 0;
+        if ( std::sscanf( line.c_str(), "t%d %d", &t, &i ) != 2 || t < 0 || t >= kThreads ||
+             i != next[ t ] ) {
+            ordered = false;
+            break;
+        }
+        ++next[ t ];
+    }
+    check( name + "_accepts_oversized", accepted );
+    check( name + "_ordered", ordered );
+    check( name + "_complete", std::all_of( next.begin(), next.end(),
+                                            [ & ]( int n ) { return n == kPerThread; } ) );
+    check( name + "_rotated", files > 1 );
+    check( name + "_sequence_monotonic", monotonic );
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 序号由缓冲区代数与代内偏移组成，换出后持久化序号覆盖此前的所有记录
+ */
+void test_sequence() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_sink_seq";
+    std::filesystem::remove_all( dir );
+    {
+        sinks::FileSinkConfig config;
+        config.durability = sinks::DurabilityPolicy::PERIODIC;
+        sinks::CFileSink sink( LogLevel::INFO, 1024 * 1024, 4096, dir.string(), true, config );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level   = LogLevel::INFO;
+        r._message = "0123456789";
+        sink.write( r );
+        check( "sequence_offset", sink.sequence() == 11 );
+
+        uint64_t seq = sink.sequence();
+        check( "sequence_durable", sink.wait_durable( seq ) && sink.durable_sequence() >= seq );
+
+        sink.write( r );
+        check( "sequence_next_generation", sink.sequence() > sink.durable_sequence() );
+    }
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 当前代放不下时不再登记预留：换代被拒绝期间反复写入，预留字保持不变，偏移不会进位到代数
+ */
+void test_reserve_full() {
+    constexpr uint64_t      kCapacity = 64;
+    char                    buffer[ kCapacity ];
+    std::atomic< uint64_t > reserve{ utils::make_reserve_word( 3 ) };
+    std::atomic< uint32_t > committed{ 0 };
+    uint64_t                length = UINT64_MAX;
+
+    auto target = [ & ]( uint32_t ) {
+        return utils::ReserveTarget{ buffer, kCapacity, &committed };
+    };
+    auto mark   = [ & ]( uint64_t len ) { length = len; };
+
+    std::string record( 10, 'r' );
+    uint64_t    word{ 0 };
+    int         copied = 0;
+    while ( utils::reserve_copy( reserve, record.data(), record.size(), kCapacity, target, mark,
+                                 word ) ) {
+        ++copied;
+    }
+    uint64_t full = reserve.load();
+    for ( int i = 0; i < 100000; ++i ) {
+        utils::reserve_copy( reserve, record.data(), record.size(), kCapacity, target, mark,
+                             word );
+    }
+    check( "reserve_full_copied", copied == 6 && committed == 6 );
+    check( "reserve_full_unchanged", reserve.load() == full );
+    check( "reserve_full_bytes", utils::reserve_bytes( full ) == 60 );
+    check( "reserve_full_generation", utils::reserve_generation( word ) == 3 );
+    check( "reserve_full_unmarked", length == UINT64_MAX );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test file_sink_concurrency begin" << std::endl;
+    run_concurrent( "reserve_writev", sinks::FileSinkConfig{} );
+
+    sinks::FileSinkConfig uring;
+    uring.backend = sinks::FileWriteBackend::IO_URING;
+    run_concurrent( "reserve_uring", uring );
+
+    test_sequence();
+    test_reserve_full();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test file_sink_concurrency end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
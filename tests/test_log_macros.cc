@@ -0,0 +1,121 @@
+#define JZLOG_ACTIVE_LEVEL JZLOG_LEVEL_INFO
+
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/core/logger_config.h"
+#include "jzlog/logger.hpp"
+#include "jzlog/sinks/sink.h"
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+struct Captured {
+    const char* _file;
+    const char* _function;
+    int         _line;
+};
+
+/**
+ * @class CLocationSink
+ * @brief 收集记录中的源码位置
+ */
+class CLocationSink final : public sinks::ISink {
+public:
+    explicit CLocationSink( std::vector< Captured >& out ) : _out( out ) {}
+    bool write( const LogRecord& r ) override {
+        std::lock_guard lock{ _mutex };
+        _out.push_back( { r._file, r._function, r._line } );
+        return true;
+    }
+    bool     flush() noexcept override { return true; }
+    void     set_level( LogLevel lvl ) noexcept override { _level = lvl; }
+    LogLevel level() const noexcept override { return _level; }
+    bool     should_log( LogLevel lvl ) const noexcept override { return lvl >= _level; }
+    void     set_enabled( bool enabled ) noexcept override { (void)enabled; }
+    bool     enabled() const noexcept override { return true; }
+
+private:
+    std::vector< Captured >& _out;
+    std::mutex               _mutex;
+    LogLevel                 _level{ LogLevel::TRACE };
+};
+
+int side_effect( int& counter ) { return ++counter; }
+
+void check_location( const char* name, LogMode mode ) {
+    std::vector< Captured > captured;
+    int                     expected_line = 0;
+    int                     evaluated     = 0;
+    {
+        LoggerConfig config;
+        config.mode = mode;
+        CLogger logger( config );
+        logger.add_sink( std::make_unique< CLocationSink >( captured ) );
+
+        expected_line = __LINE__ + 1;
+        JZLOG_INFO( logger, "value %d", 42 );
+        JZLOG_DEBUG( logger, "eliminated %d", side_effect( evaluated ) );
+        JZLOG_TRACE( logger, "eliminated %d", side_effect( evaluated ) );
+    }
+
+    if ( evaluated != 0 ) {
+        ++test_fail;
+        std::cout << name << " failed(disabled level evaluated its arguments)" << std::endl;
+    } else {
+        ++test_pass;
+    }
+
+    if ( captured.size() == 1 && captured[ 0 ]._line == expected_line &&
+         std::strcmp( captured[ 0 ]._function, "check_location" ) == 0 &&
+         std::strstr( captured[ 0 ]._file, "test_log_macros.cc" ) != nullptr ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed(location)" << std::endl;
+    }
+}
+
+void test_runtime_gate() {
+    std::vector< Captured > captured;
+    int                     evaluated = 0;
+
+    CLogger logger;
+    if ( logger.should_log( LogLevel::FATAL ) ) {
+        ++test_fail;
+        std::cout << "test_runtime_gate failed(no sink should disable everything)" << std::endl;
+    }
+
+    logger.add_sink( std::make_unique< CLocationSink >( captured ) );
+    logger.set_level( LogLevel::WARN );
+
+    JZLOG_INFO( logger, "filtered %d", side_effect( evaluated ) );
+    JZLOG_WARN( logger, "kept %d", side_effect( evaluated ) );
+    logger.info( "filtered" );
+
+    if ( evaluated == 1 && captured.size() == 1 && logger.should_log( LogLevel::ERROR ) &&
+         !logger.should_log( LogLevel::INFO ) ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_runtime_gate failed(evaluated=" << evaluated
+                  << ", records=" << captured.size() << ")" << std::endl;
+    }
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test log_macros begin" << std::endl;
+    check_location( "sync", LogMode::SYNC );
+    check_location( "deferred", LogMode::DEFERRED );
+    test_runtime_gate();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test log_macros end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
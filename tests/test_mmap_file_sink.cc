@@ -0,0 +1,198 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/mmap_file_sink.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+std::string read_file( const std::filesystem::path& path ) {
+    std::ifstream in( path, std::ios::binary );
+    return std::string( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+}
+
+std::vector< std::filesystem::path > list_dir( const std::filesystem::path& dir ) {
+    std::vector< std::filesystem::path > paths;
+    for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+        paths.push_back( entry.path() );
+    }
+    std::sort( paths.begin(), paths.end() );
+    return paths;
+}
+
+/**
+ * @brief 多线程写入小分段，频繁滚动；每个线程的记录完整且有序，文件截断到实际长度
+ */
+void test_concurrent_rotation() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_mmap_sink";
+    std::filesystem::remove_all( dir );
+
+    constexpr int      kThreads   = 4;
+    constexpr int      kPerThread = 20000;
+    constexpr uint32_t kSegment   = 64 * 1024;
+    {
+        sinks::CMmapFileSink sink( LogLevel::INFO, kSegment, dir.string() );
+        sink.set_pattern( "%v%n" );
+
+        std::vector< std::thread > workers;
+        for ( int t = 0; t < kThreads; ++t ) {
+            workers.emplace_back( [ &sink, t ]() {
+                LogRecord r;
+                r._level = LogLevel::INFO;
+                for ( int i = 0; i < kPerThread; ++i ) {
+                    r._message = "t" + std::to_string( t ) + " " + std::to_string( i );
+                    sink.write( r );
+                }
+            } );
+        }
+        for ( auto& worker : workers ) {
+            worker.join();
+        }
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        r._message.assign( kSegment + 1, 'x' );
+        check( "mmap_rejects_oversized", !sink.write( r ) );
+    }
+
+    auto             paths = list_dir( dir );
+    std::vector< int > next( kThreads, 0 );
+    bool             ordered    = true;
+    bool             sized      = true;
+    bool             no_padding = true;
+    for ( const auto& path : paths ) {
+        auto content = read_file( path );
+        sized        = sized && content.size() <= kSegment;
+        no_padding   = no_padding && content.find( '\0' ) == std::string::npos;
+
+        std::istringstream in( content );
+        std::string        line;
+        while ( std::getline( in, line ) ) {
+            int t = 0;
+            int i = 0;
+            if ( std::sscanf( line.c_str(), "t%d %d", &t, &i ) != 2 || t < 0 || t >= kThreads ||
+                 i != next[ t ] ) {
+                ordered = false;
+                break;
+            }
+            ++next[ t ];
+        }
+    }
+    check( "mmap_rotated", paths.size() > 10 );
+    check( "mmap_ordered", ordered );
+    check( "mmap_complete", std::all_of( next.begin(), next.end(),
+                                         [ & ]( int n ) { return n == kPerThread; } ) );
+    check( "mmap_segment_size", sized );
+    check( "mmap_truncated", no_padding );
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 子进程写入后直接退出（不执行析构），已写入的记录仍保留在文件中
+ */
+void test_crash_survival() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_mmap_crash";
+    std::filesystem::remove_all( dir );
+
+    pid_t pid = fork();
+    if ( pid == 0 ) {
+        auto* sink = new sinks::CMmapFileSink( LogLevel::INFO, 1024 * 1024, dir.string() );
+        sink->set_pattern( "%v%n" );
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 1000; ++i ) {
+            r._message = "record " + std::to_string( i );
+            sink->write( r );
+        }
+        _exit( 0 );
+    }
+    int status = 0;
+    waitpid( pid, &status, 0 );
+
+    auto paths = list_dir( dir );
+    check( "mmap_crash_single_file", paths.size() == 1 );
+    if ( paths.size() == 1 ) {
+        auto content = read_file( paths.front() );
+        auto end     = content.find( '\0' );
+        std::string expected;
+        for ( int i = 0; i < 1000; ++i ) {
+            expected += "record " + std::to_string( i ) + "\n";
+        }
+        check( "mmap_crash_records_kept", content.substr( 0, end ) == expected );
+        check( "mmap_crash_preallocated", content.size() == 1024 * 1024 );
+    }
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 目录被删除后分段无法创建：写入失败计入 dropped()，退避期内不重复创建文件，
+ *        目录恢复且退避期过后重新可写
+ */
+void test_rotate_failure_backoff() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_mmap_retry";
+    std::filesystem::remove_all( dir );
+
+    sinks::CMmapFileSink sink( LogLevel::INFO, 4096, dir.string() );
+    sink.set_pattern( "%v%n" );
+    std::filesystem::remove_all( dir );
+
+    // 捕获错误输出，统计创建文件的尝试次数
+    std::ostringstream errors;
+    auto*              saved = std::cerr.rdbuf( errors.rdbuf() );
+    LogRecord          r;
+    r._level   = LogLevel::INFO;
+    r._message = std::string( 100, 'r' );
+    int failed = 0;
+    for ( int i = 0; i < 10000; ++i ) {
+        failed += sink.write( r ) ? 0 : 1;
+    }
+    std::cerr.rdbuf( saved );
+
+    std::string log      = errors.str();
+    size_t      attempts = 0;
+    for ( size_t pos = log.find( "failed to" ); pos != std::string::npos; ++attempts ) {
+        pos = log.find( "failed to", pos + 1 );
+    }
+    check( "mmap_retry_writes_fail", failed > 9000 );
+    check( "mmap_retry_dropped", sink.dropped() == static_cast< uint64_t >( failed ) );
+    check( "mmap_retry_backoff", attempts >= 1 && attempts <= 2 );
+
+    std::filesystem::create_directories( dir );
+    std::this_thread::sleep_for( std::chrono::milliseconds( sinks::MMAP_RETRY_INTERVAL_MS * 3 ) );
+    check( "mmap_retry_recovered", sink.write( r ) );
+    std::filesystem::remove_all( dir );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test mmap_file_sink begin" << std::endl;
+    test_concurrent_rotation();
+    test_crash_survival();
+    test_rotate_failure_backoff();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test mmap_file_sink end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
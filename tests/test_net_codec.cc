@@ -0,0 +1,185 @@
+#include "jzlog/sinks/net_codec.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+/**
+ * @brief 压缩后解压，返回是否与原文一致；compressed 返回压缩结果
+ */
+bool roundtrip( sinks::CFrameCompressor& compressor, const std::string& input,
+                std::string& compressed ) {
+    compressed.resize( compressor.bound( input.size() ) );
+    size_t n = compressor.compress( input.data(), input.size(), compressed.data(),
+                                    compressed.size() );
+    if ( n == 0 || n > compressed.size() ) {
+        return false;
+    }
+    compressed.resize( n );
+
+    std::string output( input.size(), '\0' );
+    return sinks::decompress_payload( compressor.codec(), compressed.data(), compressed.size(),
+                                      output.data(), output.size() ) &&
+           output == input;
+}
+
+std::string random_bytes( size_t len, uint32_t seed ) {
+    std::mt19937 rng( seed );
+    std::string  out( len, '\0' );
+    for ( auto& c : out ) {
+        c = static_cast< char >( rng() );
+    }
+    return out;
+}
+
+std::string log_lines( size_t count ) {
+    std::string out;
+    for ( size_t i = 0; i < count; ++i ) {
+        out += "2026-10-17 12:00:" + std::to_string( 10 + i % 50 ) + ".123456 [INFO] [worker-" +
+               std::to_string( i % 8 ) + "] request " + std::to_string( i * 7919 ) +
+               " handled in " + std::to_string( i % 977 ) + " us\n";
+    }
+    return out;
+}
+
+/**
+ * @brief 各级别在边界长度、重复、日志与随机数据上往返一致，且不超过 bound()
+ */
+void test_lz_roundtrip() {
+    std::vector< std::pair< std::string, std::string > > inputs = {
+        { "empty", "" },
+        { "one_byte", "x" },
+        { "below_match_limit", "abcabcabcab" },
+        { "literal_15", std::string( "0123456789abcde" ) },
+        { "literal_270", random_bytes( 270, 1 ) },
+        { "run_long", std::string( 200000, 'a' ) },
+        { "period_3", [] {
+              std::string s;
+              for ( int i = 0; i < 10000; ++i ) {
+                  s += "abc";
+              }
+              return s;
+          }() },
+        { "log_lines", log_lines( 2000 ) },
+        { "random", random_bytes( 100000, 2 ) },
+        { "far_repeat", random_bytes( 70000, 3 ) + random_bytes( 70000, 3 ) },
+    };
+
+    for ( int level = 1; level <= 3; ++level ) {
+        sinks::CFrameCompressor compressor( sinks::FrameCodec::LZ, level );
+        check( "lz_valid_" + std::to_string( level ), compressor.valid() );
+        for ( const auto& [ name, input ] : inputs ) {
+            std::string compressed;
+            check( "lz_" + name + "_" + std::to_string( level ),
+                   roundtrip( compressor, input, compressed ) );
+        }
+    }
+}
+
+/**
+ * @brief 日志行与长重复串可压缩，级别越高压缩结果越小
+ */
+void test_lz_ratio() {
+    std::string input = log_lines( 2000 );
+    size_t      sizes[ 3 ];
+    for ( int level = 1; level <= 3; ++level ) {
+        sinks::CFrameCompressor compressor( sinks::FrameCodec::LZ, level );
+        std::string             compressed;
+        roundtrip( compressor, input, compressed );
+        sizes[ level - 1 ] = compressed.size();
+    }
+    check( "ratio_log_lines", sizes[ 0 ] < input.size() / 3 );
+    check( "ratio_levels", sizes[ 2 ] < sizes[ 1 ] && sizes[ 1 ] < sizes[ 0 ] );
+
+    sinks::CFrameCompressor compressor( sinks::FrameCodec::LZ, 1 );
+    std::string             compressed;
+    roundtrip( compressor, std::string( 1000000, 'z' ), compressed );
+    check( "ratio_run", compressed.size() < 5000 );
+}
+
+/**
+ * @brief 输出空间不足返回 0，截断或篡改的数据解压失败而不越界
+ */
+void test_lz_corrupt() {
+    sinks::CFrameCompressor compressor( sinks::FrameCodec::LZ, 1 );
+    std::string             input = log_lines( 200 );
+    std::string             compressed;
+    roundtrip( compressor, input, compressed );
+
+    std::string small( compressed.size() / 2, '\0' );
+    check( "corrupt_small_output",
+           compressor.compress( input.data(), input.size(), small.data(), small.size() ) == 0 );
+
+    std::string output( input.size(), '\0' );
+    check( "corrupt_truncated",
+           !sinks::decompress_payload( sinks::FrameCodec::LZ, compressed.data(),
+                                       compressed.size() - 1, output.data(), output.size() ) );
+    check( "corrupt_wrong_length",
+           !sinks::decompress_payload( sinks::FrameCodec::LZ, compressed.data(),
+                                       compressed.size(), output.data(), output.size() - 1 ) );
+
+    // 随机篡改字节：只要求不越界，结果正确与否不作要求
+    std::mt19937 rng( 4 );
+    size_t       rejected = 0;
+    for ( int i = 0; i < 1000; ++i ) {
+        std::string damaged = compressed;
+        damaged[ rng() % damaged.size() ] ^= static_cast< char >( 1 + rng() % 255 );
+        rejected += sinks::decompress_payload( sinks::FrameCodec::LZ, damaged.data(),
+                                               damaged.size(), output.data(), output.size() )
+                        ? 0
+                        : 1;
+    }
+    check( "corrupt_rejected", rejected > 0 );
+
+    std::string zero_offset( "\x14"
+                             "a\x00\x00",
+                             4 );
+    check( "corrupt_zero_offset",
+           !sinks::decompress_payload( sinks::FrameCodec::LZ, zero_offset.data(),
+                                       zero_offset.size(), output.data(), 5 ) );
+    check( "none_length_mismatch", !sinks::decompress_payload( sinks::FrameCodec::NONE, "abc", 3,
+                                                               output.data(), 4 ) );
+}
+
+/**
+ * @brief 构建未启用 zstd 时编码不可用，启用时往返一致
+ */
+void test_zstd() {
+    sinks::CFrameCompressor compressor( sinks::FrameCodec::ZSTD, 3 );
+    if ( !sinks::codec_available( sinks::FrameCodec::ZSTD ) ) {
+        check( "zstd_unavailable", !compressor.valid() );
+        return;
+    }
+    std::string compressed;
+    check( "zstd_valid", compressor.valid() );
+    check( "zstd_log_lines", roundtrip( compressor, log_lines( 2000 ), compressed ) );
+    check( "zstd_random", roundtrip( compressor, random_bytes( 100000, 5 ), compressed ) );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test net_codec begin" << std::endl;
+    test_lz_roundtrip();
+    test_lz_ratio();
+    test_lz_corrupt();
+    test_zstd();
+    check( "none_invalid", !sinks::CFrameCompressor( sinks::FrameCodec::NONE, 1 ).valid() );
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test net_codec end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
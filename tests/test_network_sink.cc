@@ -0,0 +1,477 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/frame_receiver.h"
+#include "jzlog/sinks/net_codec.h"
+#include "jzlog/sinks/net_frame.h"
+#include "jzlog/sinks/network_sink.h"
+#include "jzlog/utils/crc32c.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <netinet/in.h>
+#include <optional>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+/**
+ * @class CCollector
+ * @brief 本地回环上的日志收集端：正常模式由 CFrameReceiver 按帧校验、解压、去重并累计确认，卡顿
+ *        模式从不 accept，发送方最终阻塞在 send 上；port 为 0 时由系统分配端口
+ */
+class CCollector {
+public:
+    /**
+     * @param cut_after 非 0 时第 cut_after 帧收下后不确认，直接断开连接（只断开一次）
+     */
+    explicit CCollector( bool reading, uint16_t port = 0, size_t cut_after = 0 ) :
+        _receiver( [ this ]( const sinks::FrameHeader&, const std::string& lines ) {
+            _content += lines;
+        } ) {
+        _receiver.cut_after( cut_after );
+        _listen_fd = ::socket( AF_INET, SOCK_STREAM, 0 );
+        int reuse  = 1;
+        ::setsockopt( _listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof( reuse ) );
+        if ( !reading ) {
+            int size = 4096;
+            ::setsockopt( _listen_fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof( size ) );
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        addr.sin_port        = htons( port );
+        ::bind( _listen_fd, reinterpret_cast< sockaddr* >( &addr ), sizeof( addr ) );
+        ::listen( _listen_fd, 1 );
+
+        socklen_t len = sizeof( addr );
+        ::getsockname( _listen_fd, reinterpret_cast< sockaddr* >( &addr ), &len );
+        _port = ntohs( addr.sin_port );
+
+        if ( reading ) {
+            _reader = std::thread( [ this ]() {
+                int fd = -1;
+                while ( ( fd = ::accept( _listen_fd, nullptr, nullptr ) ) >= 0 ) {
+                    sinks::ReceiveResult result = _receiver.serve( fd );
+                    if ( result == sinks::ReceiveResult::BAD_HEADER ||
+                         result == sinks::ReceiveResult::BAD_CRC ||
+                         result == sinks::ReceiveResult::BAD_PAYLOAD ) {
+                        ++_errors;
+                    }
+                    ::close( fd );
+                }
+            } );
+        }
+    }
+
+    ~CCollector() {
+        ::shutdown( _listen_fd, SHUT_RDWR );
+        if ( _reader.joinable() ) {
+            _reader.join();
+        }
+        ::close( _listen_fd );
+    }
+
+    uint16_t port() const { return _port; }
+
+    /**
+     * @brief 获取收到的全部内容，须在 sink 析构后调用；sink 析构前已等到全部确认，不会漏读
+     */
+    const std::string& content() {
+        ::shutdown( _listen_fd, SHUT_RDWR );
+        if ( _reader.joinable() ) {
+            _reader.join();
+        }
+        return _content;
+    }
+
+    size_t duplicates() const { return _receiver.duplicates(); }
+
+    size_t errors() const { return _errors; }
+
+    size_t compressed() const { return _receiver.compressed(); }
+
+private:
+    int                   _listen_fd{ -1 };
+    uint16_t              _port{ 0 };
+    size_t                _errors{ 0 };
+    std::string           _content;
+    sinks::CFrameReceiver _receiver;
+    std::thread           _reader;
+};
+
+/**
+ * @brief 取一个当前无人监听的本地端口
+ */
+uint16_t unused_port() {
+    CCollector probe( false );
+    return probe.port();
+}
+
+/**
+ * @brief 帧头与确认编解码往返一致，越界或不一致的帧头被拒绝，CRC-32C 与标准校验值一致
+ */
+void test_frame_codec() {
+    check( "crc32c_check_value", utils::crc32c( 0, "123456789", 9 ) == 0xe3069283 );
+    std::string data( 1000, 'z' );
+    check( "crc32c_incremental", utils::crc32c( utils::crc32c( 0, data.data(), 333 ),
+                                                data.data() + 333, 667 ) ==
+                                     utils::crc32c( 0, data.data(), data.size() ) );
+
+    sinks::FrameHeader in;
+    in.codec      = sinks::FrameCodec::LZ;
+    in.length     = 123;
+    in.raw_length = 456;
+    in.records    = 7;
+    in.crc        = 0xdeadbeef;
+    in.session    = 0x0102030405060708ULL;
+    in.seq        = 42;
+    char buf[ sinks::FRAME_HEADER_SIZE ];
+    sinks::encode_frame_header( in, buf );
+    sinks::FrameHeader out;
+    check( "frame_header_roundtrip", sinks::decode_frame_header( buf, out ) &&
+                                         out.codec == sinks::FrameCodec::LZ &&
+                                         out.length == 123 && out.raw_length == 456 &&
+                                         out.records == 7 && out.crc == 0xdeadbeef &&
+                                         out.session == in.session && out.seq == 42 );
+
+    sinks::FrameHeader bad = in;
+    bad.raw_length         = sinks::MAX_FRAME_LENGTH + 1;
+    sinks::encode_frame_header( bad, buf );
+    check( "frame_header_raw_too_long", !sinks::decode_frame_header( buf, out ) );
+    bad       = in;
+    bad.codec = sinks::FrameCodec::NONE;
+    sinks::encode_frame_header( bad, buf );
+    check( "frame_header_raw_mismatch", !sinks::decode_frame_header( buf, out ) );
+    sinks::encode_frame_header( in, buf );
+    buf[ 5 ] = 9;
+    check( "frame_header_bad_codec", !sinks::decode_frame_header( buf, out ) );
+    sinks::encode_frame_header( in, buf );
+    buf[ 0 ] = 'X';
+    check( "frame_header_bad_magic", !sinks::decode_frame_header( buf, out ) );
+
+    char     ack[ sinks::ACK_SIZE ];
+    uint64_t seq = 0;
+    sinks::encode_ack( 99, ack );
+    check( "ack_roundtrip", sinks::decode_ack( ack, seq ) && seq == 99 );
+}
+
+/**
+ * @brief 收集端正常时所有记录按序送达，其中超过发送块大小的行单独成块
+ * @param zerocopy_threshold 使用 MSG_ZEROCOPY 的批次大小下限，0 表示不使用
+ * @param codec 批次压缩编码，NONE 表示不压缩
+ */
+void run_delivered( const std::string& name, size_t zerocopy_threshold,
+                    sinks::FrameCodec codec = sinks::FrameCodec::NONE ) {
+    CCollector  collector( true );
+    std::string expected;
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", collector.port(), LogLevel::INFO, 100, 50, 100,
+                                  true );
+        sink.set_pattern( "%v%n" );
+        sink.set_zerocopy_threshold( zerocopy_threshold );
+        sinks::CompressionConfig compression;
+        compression.codec     = codec;
+        compression.min_bytes = 512;
+        sink.set_compression( compression );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 10000; ++i ) {
+            r._message = "record " + std::to_string( i );
+            if ( i % 1000 == 0 ) {
+                r._message.resize( sinks::NETWORK_CHUNK_SIZE + 100, 'x' );
+            }
+            sink.write( r );
+            expected += r._message + "\n";
+        }
+        check( name + "_not_dropped", sink.dropped() == 0 );
+        if ( codec != sinks::FrameCodec::NONE ) {
+            sink.flush();
+            sinks::NetworkStats stats = sink.stats();
+            check( name + "_compressed", stats.compressed > 0 && stats.ratio() < 0.5 );
+        }
+    }
+    check( name + "_content", collector.content() == expected );
+    check( name + "_no_errors", collector.errors() == 0 );
+    check( name + "_codec",
+           ( collector.compressed() > 0 ) == ( codec != sinks::FrameCodec::NONE ) );
+}
+
+/**
+ * @brief 小于 min_bytes 的批次不压缩；不可压缩的数据压缩失败后退避，不再逐批尝试
+ */
+void test_compression_skip() {
+    CCollector collector( true );
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", collector.port(), LogLevel::INFO, 100, 50, 100,
+                                  true );
+        sink.set_pattern( "%v%n" );
+        sinks::CompressionConfig compression;
+        compression.min_bytes = 1024 * 1024;
+        check( "compression_enabled", sink.set_compression( compression ) );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 1000; ++i ) {
+            r._message = "small " + std::to_string( i );
+            sink.write( r );
+        }
+        sink.flush();
+        sinks::NetworkStats stats = sink.stats();
+        check( "compression_min_bytes", stats.frames > 0 && stats.attempted == 0 );
+
+        // 随机字节压缩不到 7/8，连续失败后跳过的批次越来越多
+        compression.min_bytes = 0;
+        sink.set_compression( compression );
+        std::mt19937 rng( 1 );
+        for ( int i = 0; i < 2000; ++i ) {
+            r._message.clear();
+            for ( int j = 0; j < 64; ++j ) {
+                r._message += static_cast< char >( 'a' + rng() % 64 );
+            }
+            sink.write( r );
+            if ( i % 20 == 0 ) {
+                sink.flush();
+            }
+        }
+        sink.flush();
+        stats = sink.stats();
+        check( "compression_backoff", stats.compressed == 0 && stats.attempted > 0 &&
+                                          stats.attempted * 2 < stats.frames );
+    }
+    check( "compression_skip_no_errors", collector.errors() == 0 );
+}
+
+/**
+ * @brief 析构时仍未确认的压缩帧解压后写入磁盘队列，下一个 sink 实例回放
+ */
+void test_compressed_spool() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_net_lz";
+    std::filesystem::remove_all( dir );
+
+    uint16_t                    port = unused_port();
+    std::optional< CCollector > collector;
+    std::string                 expected;
+    sinks::SpoolConfig          config;
+    config.dir = dir.string();
+    sinks::CompressionConfig compression;
+    compression.min_bytes = 0;
+
+    collector.emplace( false, port );
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", port, LogLevel::INFO, 100, 20, 50, true );
+        sink.set_pattern( "%v%n" );
+        check( "lz_spool_enabled", sink.enable_spool( config ) );
+        sink.set_compression( compression );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 500; ++i ) {
+            r._message = "unacked " + std::to_string( i );
+            sink.write( r );
+            expected += r._message + "\n";
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 200 } );
+        check( "lz_spool_sent_compressed", sink.stats().compressed > 0 );
+        // 收集端关闭，已发出的帧都没有确认
+        collector.reset();
+    }
+    check( "lz_spool_written", std::filesystem::exists( dir ) &&
+                                   !std::filesystem::is_empty( dir ) );
+
+    collector.emplace( true, port );
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", port, LogLevel::INFO, 100, 20, 50, true );
+        sink.set_pattern( "%v%n" );
+        sink.enable_spool( config );
+        sink.set_compression( compression );
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+        while ( ( !sink.flush() || sink.stats().frames == 0 ) &&
+                std::chrono::steady_clock::now() < deadline ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds{ 20 } );
+        }
+        check( "lz_spool_not_dropped", sink.dropped() == 0 );
+    }
+    check( "lz_spool_replayed", collector->content() == expected );
+    check( "lz_spool_replay_compressed", collector->compressed() > 0 );
+    std::filesystem::remove_all( dir );
+}
+
+/**
+ * @brief 收集端收下一帧后不确认就断开，重连后未确认的帧被重发并按序号去重，内容不重不漏
+ */
+void test_retransmit() {
+    CCollector  collector( true, 0, 5 );
+    std::string expected;
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", collector.port(), LogLevel::INFO, 100, 20, 50,
+                                  true );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 5000; ++i ) {
+            r._message = "retransmit " + std::to_string( i );
+            sink.write( r );
+            expected += r._message + "\n";
+            if ( i % 100 == 0 ) {
+                std::this_thread::sleep_for( std::chrono::milliseconds{ 1 } );
+            }
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+        while ( !sink.flush() && std::chrono::steady_clock::now() < deadline ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds{ 20 } );
+        }
+        check( "retransmit_not_dropped", sink.dropped() == 0 );
+    }
+    check( "retransmit_content", collector.content() == expected );
+    check( "retransmit_deduplicated", collector.duplicates() > 0 );
+}
+
+/**
+ * @brief 收集端停止接收时发送线程阻塞在 send 上，写入延迟不受影响
+ */
+void test_stalled_collector() {
+    CCollector collector( false );
+
+    std::chrono::steady_clock::duration worst{ 0 };
+    size_t                              bytes = 0;
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", collector.port(), LogLevel::INFO, 100, 50, 100,
+                                  true );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level   = LogLevel::INFO;
+        r._message = std::string( 100, 'x' );
+        auto end   = std::chrono::steady_clock::now() + std::chrono::milliseconds{ 1500 };
+        for ( int i = 1; std::chrono::steady_clock::now() < end; ++i ) {
+            auto start = std::chrono::steady_clock::now();
+            sink.write( r );
+            worst = std::max( worst, std::chrono::steady_clock::now() - start );
+            bytes += r._message.size() + 1;
+            if ( i % 100 == 0 ) {
+                std::this_thread::sleep_for( std::chrono::milliseconds{ 1 } );
+            }
+        }
+    }
+    // 写入量远超两端 socket 缓冲区，发送线程必然在写入期间卡住
+    check( "stalled_exceeds_socket_buffers", bytes > 1024 * 1024 );
+    check( "stalled_producer_not_blocked", worst < std::chrono::milliseconds{ 100 } );
+}
+
+/**
+ * @brief 收集端不可达时写入与析构都不等待重连退避
+ */
+void test_collector_down() {
+    uint16_t port  = unused_port();
+    auto     start = std::chrono::steady_clock::now();
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", port, LogLevel::INFO, 10, 20, 1000, true );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level   = LogLevel::INFO;
+        r._message = "lost";
+        bool all   = true;
+        for ( int i = 0; i < 1000; ++i ) {
+            all = sink.write( r ) && all;
+        }
+        check( "down_writes_accepted", all );
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 100 } );
+        check( "down_flush_fails", !sink.flush() );
+    }
+    check( "down_no_backoff_sleep",
+           std::chrono::steady_clock::now() - start < std::chrono::milliseconds{ 900 } );
+}
+
+/**
+ * @brief 收集端不可达时批次写入磁盘队列，收集端恢复后按序回放，不丢失记录
+ */
+void test_spool_replay() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "jzlog_test_net_spool";
+    std::filesystem::remove_all( dir );
+
+    uint16_t                    port = unused_port();
+    std::optional< CCollector > collector;
+    std::string                 expected;
+    {
+        sinks::CNetworkSink sink( "127.0.0.1", port, LogLevel::INFO, 100, 20, 50, true );
+        sink.set_pattern( "%v%n" );
+        sinks::SpoolConfig config;
+        config.dir                  = dir.string();
+        config.segment_bytes        = 64 * 1024;
+        config.replay_bytes_per_sec = 4 * 1024 * 1024;
+        check( "spool_enabled", sink.enable_spool( config ) );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; i < 20000; ++i ) {
+            r._message = "spooled " + std::to_string( i );
+            sink.write( r );
+            expected += r._message + "\n";
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 200 } );
+        check( "spool_not_dropped_while_down", sink.dropped() == 0 );
+        size_t segments = 0;
+        for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+            segments += entry.path().extension() == ".seg" ? 1 : 0;
+        }
+        check( "spool_segments_written", segments > 1 );
+
+        collector.emplace( true, port );
+        for ( int i = 0; i < 100; ++i ) {
+            r._message = "live " + std::to_string( i );
+            sink.write( r );
+            expected += r._message + "\n";
+        }
+        // 等待重连退避结束并回放完磁盘队列
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+        while ( !sink.flush() && std::chrono::steady_clock::now() < deadline ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds{ 20 } );
+        }
+        check( "spool_not_dropped", sink.dropped() == 0 );
+    }
+    check( "spool_replayed_in_order", collector->content() == expected );
+    std::filesystem::remove_all( dir );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test network_sink begin" << std::endl;
+    test_frame_codec();
+    run_delivered( "delivered", 0 );
+    run_delivered( "delivered_zerocopy", 1 );
+    run_delivered( "delivered_lz", 0, sinks::FrameCodec::LZ );
+    run_delivered( "delivered_lz_zerocopy", 1, sinks::FrameCodec::LZ );
+    if ( sinks::codec_available( sinks::FrameCodec::ZSTD ) ) {
+        run_delivered( "delivered_zstd", 0, sinks::FrameCodec::ZSTD );
+    }
+    test_compression_skip();
+    test_retransmit();
+    test_stalled_collector();
+    test_collector_down();
+    test_spool_replay();
+    test_compressed_spool();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test network_sink end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
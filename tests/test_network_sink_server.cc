@@ -1,95 +1,106 @@
+/**
+ * @file test_network_sink_server.cc
+ * @brief CNetworkSink 分帧协议的参考接收端
+ *
+ * 逐个连接交给 CFrameReceiver（jzlog/sinks/frame_receiver.h）：校验、解压、按 (session, seq)
+ * 去重后把日志行写到标准输出并回复累计确认。帧头或校验错误时断开连接，发送方重连后从未确认的帧重发。
+ *
+ * 用法：test_tcp_server [port]，默认端口 9999
+ */
+#include "jzlog/sinks/frame_receiver.h"
 #include <arpa/inet.h>
-#include <asm-generic/socket.h>
-#include <errno.h>
+#include <cstdio>
+#include <cstdlib>
 #include <netinet/in.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
+#include <string>
 #include <sys/socket.h>
-#include <sys/types.h>
 #include <unistd.h>
 
-#define PORT        9999
-#define BUFFER_SIZE 4096
+using namespace jzlog;
 
-void handle_client( int client_fd, struct sockaddr_in* client_addr ) {
-    char client_ip[ INET_ADDRSTRLEN ];
-    inet_ntop( AF_INET, &( client_addr->sin_addr ), client_ip, INET_ADDRSTRLEN );
+namespace
+{
 
-    printf( "[SERVER] Client connected from %s:%d\n", client_ip, ntohs( client_addr->sin_port ) );
-    printf( "[SERVER] Waiting for logs...\n" );
+constexpr uint16_t kDefaultPort = 9999;
 
-    char    buffer[ BUFFER_SIZE ];
-    ssize_t bytes_received = 0;
+sinks::CFrameReceiver g_receiver( []( const sinks::FrameHeader&, const std::string& lines ) {
+    std::fwrite( lines.data(), 1, lines.size(), stdout );
+    std::fflush( stdout );
+} );
 
-    while ( 1 ) {
-        bytes_received = recv( client_fd, buffer, BUFFER_SIZE - 1, 0 );
-        if ( bytes_received <= 0 ) {
-            if ( bytes_received == 0 ) {
-                printf( "[SERVER] Client disconnected\n" );
-            } else {
-                printf( "[SERVER] Receive error: %s\n", strerror( errno ) );
-            }
+void handle_client( int client_fd, const sockaddr_in& client_addr ) {
+    char client_ip[ INET_ADDRSTRLEN ];
+    inet_ntop( AF_INET, &client_addr.sin_addr, client_ip, sizeof( client_ip ) );
+    std::printf( "[SERVER] Client connected from %s:%d\n", client_ip,
+                 ntohs( client_addr.sin_port ) );
+
+    uint64_t frames     = g_receiver.frames();
+    uint64_t duplicates = g_receiver.duplicates();
+    switch ( g_receiver.serve( client_fd ) ) {
+        case sinks::ReceiveResult::BAD_HEADER:
+            std::fprintf( stderr, "[SERVER] Invalid frame header, closing connection\n" );
+            break;
+        case sinks::ReceiveResult::BAD_CRC:
+            std::fprintf( stderr, "[SERVER] Checksum mismatch, closing connection\n" );
+            break;
+        case sinks::ReceiveResult::BAD_PAYLOAD:
+            std::fprintf( stderr, "[SERVER] Failed to decode payload, closing connection\n" );
+            break;
+        default:
             break;
-        }
-
-        buffer[ bytes_received ] = '\0';
-
-        fwrite( buffer, 1, bytes_received, stdout );
-        fflush( stdout );
     }
 
+    std::printf( "[SERVER] Client disconnected (%llu frames, %llu duplicates)\n",
+                 static_cast< unsigned long long >( g_receiver.frames() - frames ),
+                 static_cast< unsigned long long >( g_receiver.duplicates() - duplicates ) );
     close( client_fd );
 }
 
-int main() {
+}  // anonymous namespace
+
+int main( int argc, char* argv[] ) {
+    uint16_t port =
+        argc > 1 ? static_cast< uint16_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) ) : kDefaultPort;
+
     int server_fd = socket( AF_INET, SOCK_STREAM, 0 );
     if ( server_fd < 0 ) {
-        perror( "[SERVER] Failed to create socket" );
-        exit( EXIT_FAILURE );
+        std::perror( "[SERVER] Failed to create socket" );
+        return EXIT_FAILURE;
     }
 
     int opt = 1;
     if ( setsockopt( server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof( opt ) ) < 0 ) {
-        perror( "[SERVER] Failed to set SO_REUSEADDR" );
+        std::perror( "[SERVER] Failed to set SO_REUSEADDR" );
         close( server_fd );
-        exit( EXIT_FAILURE );
+        return EXIT_FAILURE;
     }
 
-    struct sockaddr_in server_addr;
-    memset( &server_addr, 0, sizeof( server_addr ) );
+    sockaddr_in server_addr{};
     server_addr.sin_family      = AF_INET;
     server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port        = htons( PORT );
-
-    if ( bind( server_fd, (struct sockaddr*)&server_addr, sizeof( server_addr ) ) < 0 ) {
-        perror( "[SERVER] Failed to bind" );
+    server_addr.sin_port        = htons( port );
+    if ( bind( server_fd, reinterpret_cast< sockaddr* >( &server_addr ), sizeof( server_addr ) ) <
+         0 ) {
+        std::perror( "[SERVER] Failed to bind" );
         close( server_fd );
-        exit( EXIT_FAILURE );
+        return EXIT_FAILURE;
     }
-
     if ( listen( server_fd, 5 ) < 0 ) {
-        perror( "[SERVER] Failed to listen" );
+        std::perror( "[SERVER] Failed to listen" );
         close( server_fd );
-        exit( EXIT_FAILURE );
+        return EXIT_FAILURE;
     }
 
-    printf( "[SERVER] TCP server started on 127.0.0.1:%d\n", PORT );
-    printf( "[SERVER] Waiting for connections...\n" );
-
-    while ( 1 ) {
-        struct sockaddr_in client_addr;
-        socklen_t          client_len = sizeof( client_addr );
-
-        int client_fd = accept( server_fd, (struct sockaddr*)&client_addr, &client_len );
+    std::printf( "[SERVER] Frame receiver started on 0.0.0.0:%d\n", port );
+    while ( true ) {
+        sockaddr_in client_addr{};
+        socklen_t   client_len = sizeof( client_addr );
+        int         client_fd =
+            accept( server_fd, reinterpret_cast< sockaddr* >( &client_addr ), &client_len );
         if ( client_fd < 0 ) {
-            perror( "[SERVER] Failed to accept connection" );
+            std::perror( "[SERVER] Failed to accept connection" );
             continue;
         }
-
-        handle_client( client_fd, &client_addr );
+        handle_client( client_fd, client_addr );
     }
-
-    close( server_fd );
-    return 0;
 }
@@ -0,0 +1,145 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/sinks/file_sink.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, bool ok ) {
+    if ( ok ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed" << std::endl;
+    }
+}
+
+std::vector< std::filesystem::path > list_dir( const std::filesystem::path& dir ) {
+    std::vector< std::filesystem::path > paths;
+    for ( const auto& entry : std::filesystem::directory_iterator( dir ) ) {
+        if ( entry.path().filename() == sinks::MANIFEST_FILE_NAME ) {
+            continue;
+        }
+        paths.push_back( entry.path() );
+    }
+    std::sort( paths.begin(), paths.end() );
+    return paths;
+}
+
+/**
+ * @brief 统计文件在页缓存中的页数
+ * @param total 返回文件总页数
+ */
+size_t resident_pages( const std::filesystem::path& path, size_t& total ) {
+    total  = 0;
+    int fd = ::open( path.c_str(), O_RDONLY );
+    if ( fd < 0 ) {
+        return 0;
+    }
+    size_t size = static_cast< size_t >( ::lseek( fd, 0, SEEK_END ) );
+    size_t page = static_cast< size_t >( ::sysconf( _SC_PAGESIZE ) );
+    total       = ( size + page - 1 ) / page;
+
+    size_t resident = 0;
+    void*  base     = MAP_FAILED;
+    if ( total > 0 ) {
+        base = ::mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+    }
+    if ( base != MAP_FAILED ) {
+        std::vector< unsigned char > vec( total );
+        if ( ::mincore( base, size, vec.data() ) == 0 ) {
+            resident = static_cast< size_t >(
+                std::count_if( vec.begin(), vec.end(), []( unsigned char v ) { return v & 1; } ) );
+        }
+        ::munmap( base, size );
+    }
+    ::close( fd );
+    return resident;
+}
+
+/**
+ * @brief 写入过程中落后的窗口被移出页缓存，滚动后的旧文件关闭时整体移出，内容不受影响
+ */
+void run_page_cache( const std::string& name, const sinks::FileSinkConfig& config ) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / ( "jzlog_test_" + name );
+    std::filesystem::remove_all( dir );
+
+    constexpr size_t kWindow = 256 * 1024;
+    std::string      expected;
+    size_t           total    = 0;
+    size_t           resident = 0;
+    {
+        sinks::CFileSink sink( LogLevel::INFO, 8 * 1024 * 1024, 64 * 1024, dir.string(), true,
+                               config );
+        sink.set_pattern( "%v%n" );
+
+        LogRecord r;
+        r._level = LogLevel::INFO;
+        for ( int i = 0; expected.size() < 12 * 1024 * 1024; ++i ) {
+            r._message = "record " + std::to_string( i ) + " " + std::string( 100, 'x' );
+            sink.write( r );
+            expected += r._message + "\n";
+        }
+        sink.flush();
+
+        // 当前文件只保留最近的几个窗口
+        auto paths = list_dir( dir );
+        for ( const auto& path : paths ) {
+            size_t pages = 0;
+            size_t in    = resident_pages( path, pages );
+            if ( pages > total ) {
+                total    = pages;
+                resident = in;
+            }
+        }
+    }
+    size_t page = static_cast< size_t >( ::sysconf( _SC_PAGESIZE ) );
+    check( name + "_dropped_while_writing", total > 0 && resident * page <= 4 * kWindow );
+
+    auto        paths   = list_dir( dir );
+    bool        dropped = true;
+    std::string content;
+    for ( const auto& path : paths ) {
+        size_t pages = 0;
+        dropped      = dropped && resident_pages( path, pages ) * 4 <= pages;
+
+        std::ifstream in( path, std::ios::binary );
+        content.append( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+    }
+    check( name + "_rotated", paths.size() > 1 );
+    check( name + "_dropped_on_close", dropped );
+    check( name + "_content", content == expected );
+    std::filesystem::remove_all( dir );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test page_cache begin" << std::endl;
+    sinks::FileSinkConfig config;
+    config.rotation          = sinks::RotationPolicy::SIZE;
+    config.writeback_window  = 256 * 1024;
+    config.drop_cache_window = 256 * 1024;
+    run_page_cache( "page_cache_writeback", config );
+
+    config.writeback_window = 0;
+    run_page_cache( "page_cache_drop_only", config );
+
+    config.backend          = sinks::FileWriteBackend::IO_URING;
+    config.writeback_window = 256 * 1024;
+    run_page_cache( "page_cache_uring", config );
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test page_cache end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+#include "jzlog/core/log_level.h"
+#include "jzlog/core/log_record.h"
+#include "jzlog/core/pattern_formatter.h"
+#include "jzlog/logger.hpp"
+#include "jzlog/sinks/sink.h"
+#include "jzlog/utils/fixed_buffer.h"
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void check( const std::string& name, const std::string& actual, const std::string& expected ) {
+    if ( actual == expected ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed(actual=" << actual << ", expected=" << expected << ")"
+                  << std::endl;
+    }
+}
+
+LogRecord make_record() {
+    LogRecord r;
+    r._timestamp = std::chrono::system_clock::from_time_t( 1718454645 ) +
+                   std::chrono::microseconds( 7089 );
+    r._level     = LogLevel::WARN;
+    r._message   = "hello 42";
+    r._thread_id = std::this_thread::get_id();
+    r._file      = "/src/app/main.cc";
+    r._function  = "run";
+    r._line      = 128;
+    return r;
+}
+
+std::string format( std::string_view pattern, const LogRecord& r ) {
+    CPatternFormatter formatter( pattern );
+    return std::string( formatter.format( r ) );
+}
+
+/**
+ * @brief 默认模式与旧版 stringstream 实现的输出一致
+ */
+void test_default_layout() {
+    setenv( "TZ", "Asia/Shanghai", 1 );
+    tzset();
+
+    LogRecord r = make_record();
+
+    std::stringstream ss;
+    auto              time = std::chrono::system_clock::to_time_t( r._timestamp );
+    std::tm           tm_buf{};
+    localtime_r( &time, &tm_buf );
+    ss << std::put_time( &tm_buf, "%Y-%m-%d %H:%M:%S" ) << " ["
+       << loglevel::to_string( r._level ) << "] " << "[" << r._thread_id << "]"
+       << "[" << r._function << ":" << r._line << "]" << r._message << "\n";
+
+    check( "default_layout", format( kDefaultPattern, r ), ss.str() );
+}
+
+void test_tokens() {
+    setenv( "TZ", "Asia/Shanghai", 1 );
+    tzset();
+
+    LogRecord r = make_record();
+    check( "date_fields", format( "%Y/%m/%d %H-%M-%S", r ), "2024/06/15 20-30-45" );
+    check( "fraction", format( "%S.%e|%S.%f", r ), "45.007|45.007089" );
+    check( "utc_offset", format( "%z", r ), "+08:00" );
+    check( "source", format( "%s|%g|%!|%#", r ), "main.cc|/src/app/main.cc|run|128" );
+    check( "level_message", format( "[%l] %v%n", r ), "[WARN] hello 42\n" );
+    check( "escape", format( "100%% %q %", r ), "100% %q %" );
+    check( "literal_only", format( "no tokens", r ), "no tokens" );
+    check( "reordered", format( "%H:%M %Y", r ), "20:30 2024" );
+}
+
+/**
+ * @brief 超过固定缓冲区时退化为字符串输出
+ */
+void test_long_message() {
+    LogRecord r = make_record();
+    r._message.assign( utils::kSmallBuffer * 3, 'x' );
+
+    CPatternFormatter        formatter( "[%l] %v" );
+    utils::FixedBuffer< 64 > small;
+    if ( formatter.format_to( r, small ) ) {
+        ++test_fail;
+        std::cout << "test_long_message failed(fixed buffer should overflow)" << std::endl;
+    } else {
+        ++test_pass;
+    }
+
+    check( "long_message", std::string( formatter.format( r ) ), "[WARN] " + r._message );
+}
+
+/**
+ * @class CLayoutSink
+ * @brief 记录收到的渲染结果及其地址
+ */
+class CLayoutSink final : public sinks::ISink {
+public:
+    explicit CLayoutSink( std::string_view pattern ) : _formatter( pattern ) {}
+    bool write( const LogRecord& r ) override {
+        _lines.emplace_back( _formatter.format( r ) );
+        _addresses.push_back( nullptr );
+        return true;
+    }
+    const CPatternFormatter* formatter() const noexcept override { return &_formatter; }
+    bool write_formatted( const LogRecord& r, std::string_view line ) override {
+        (void)r;
+        _lines.emplace_back( line );
+        _addresses.push_back( line.data() );
+        return true;
+    }
+    bool     flush() noexcept override { return true; }
+    void     set_level( LogLevel lvl ) noexcept override { _level = lvl; }
+    LogLevel level() const noexcept override { return _level; }
+    bool     should_log( LogLevel lvl ) const noexcept override { return lvl >= _level; }
+    void     set_enabled( bool enabled ) noexcept override { (void)enabled; }
+    bool     enabled() const noexcept override { return true; }
+
+    std::vector< std::string > _lines;
+    std::vector< const char* > _addresses;
+
+private:
+    CPatternFormatter _formatter;
+    LogLevel          _level{ LogLevel::TRACE };
+};
+
+/**
+ * @brief 相同模式串的 sink 共享同一份渲染结果
+ */
+void test_shared_render() {
+    CLogger logger;
+    auto    file    = std::make_unique< CLayoutSink >( "[%l] %v" );
+    auto    network = std::make_unique< CLayoutSink >( "[%l] %v" );
+    auto    other   = std::make_unique< CLayoutSink >( "%l|%v" );
+    auto*   a       = file.get();
+    auto*   b       = network.get();
+    auto*   c       = other.get();
+    logger.add_sink( std::move( file ) );
+    logger.add_sink( std::move( other ) );
+    logger.add_sink( std::move( network ) );
+
+    logger.info( "shared %d", 1 );
+
+    check( "shared_file", a->_lines.at( 0 ), "[INFO] shared 1" );
+    check( "shared_network", b->_lines.at( 0 ), "[INFO] shared 1" );
+    check( "shared_other", c->_lines.at( 0 ), "INFO|shared 1" );
+    if ( a->_addresses[ 0 ] != nullptr && a->_addresses[ 0 ] == b->_addresses[ 0 ] &&
+         c->_addresses[ 0 ] != a->_addresses[ 0 ] ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_shared_render failed(render was not shared)" << std::endl;
+    }
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test pattern_formatter begin" << std::endl;
+    test_default_layout();
+    test_tokens();
+    test_long_message();
+    test_shared_render();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test pattern_formatter end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
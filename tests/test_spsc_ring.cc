@@ -0,0 +1,112 @@
+#include "jzlog/utils/spsc_ring.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+void test_reserve_commit() {
+    utils::CSpscRing ring( 4096 );
+
+    char* dst = ring.reserve( 5 );
+    std::memcpy( dst, "hello", 5 );
+    ring.commit();
+
+    size_t      len  = 0;
+    const char* data = ring.front( len );
+    if ( data != nullptr && len == 5 && std::memcmp( data, "hello", 5 ) == 0 ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_reserve_commit failed(front)" << std::endl;
+    }
+    ring.pop( len );
+
+    if ( ring.empty() && ring.front( len ) == nullptr ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_reserve_commit failed(empty)" << std::endl;
+    }
+}
+
+void test_full_and_oversized() {
+    utils::CSpscRing ring( 4096 );
+
+    if ( ring.reserve( ring.max_record_size() + 1 ) == nullptr ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_full_and_oversized failed(oversized accepted)" << std::endl;
+    }
+
+    int count = 0;
+    while ( ring.reserve( 100 ) != nullptr ) {
+        ring.commit();
+        ++count;
+    }
+    if ( count > 0 && count <= 4096 / 108 ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_full_and_oversized failed(count=" << count << ")" << std::endl;
+    }
+}
+
+void test_wrap_around_concurrent() {
+    utils::CSpscRing ring( 4096 );
+    constexpr uint64_t kCount = 200000;
+
+    std::thread producer( [ &ring ]() {
+        for ( uint64_t i = 0; i < kCount; ++i ) {
+            size_t len = sizeof( uint64_t ) + i % 300;
+            char*  dst = nullptr;
+            while ( ( dst = ring.reserve( len ) ) == nullptr ) {
+                std::this_thread::yield();
+            }
+            std::memcpy( dst, &i, sizeof( i ) );
+            ring.commit();
+        }
+    } );
+
+    uint64_t expected = 0;
+    bool     ordered  = true;
+    while ( expected < kCount ) {
+        size_t      len  = 0;
+        const char* data = ring.front( len );
+        if ( data == nullptr ) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint64_t value = 0;
+        std::memcpy( &value, data, sizeof( value ) );
+        if ( value != expected || len != sizeof( uint64_t ) + expected % 300 ) {
+            ordered = false;
+        }
+        ring.pop( len );
+        ++expected;
+    }
+    producer.join();
+
+    if ( ordered ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_wrap_around_concurrent failed(order)" << std::endl;
+    }
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test spsc_ring begin" << std::endl;
+    test_reserve_commit();
+    test_full_and_oversized();
+    test_wrap_around_concurrent();
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test spsc_ring end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}
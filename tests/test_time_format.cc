@@ -0,0 +1,115 @@
+#include "jzlog/utils/time_format.h"
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+using namespace jzlog;
+
+int test_pass = 0;
+int test_fail = 0;
+
+/**
+ * @brief 使用 localtime_r + strftime 生成参考结果
+ */
+std::string reference( std::chrono::system_clock::time_point tp, const char* fmt ) {
+    std::time_t time = std::chrono::system_clock::to_time_t( tp );
+    if ( tp < std::chrono::system_clock::from_time_t( time ) ) {
+        --time;
+    }
+    std::tm tm_buf{};
+    localtime_r( &time, &tm_buf );
+    char buf[ 64 ];
+    size_t n = std::strftime( buf, sizeof( buf ), fmt, &tm_buf );
+    return std::string( buf, n );
+}
+
+void check( const std::string& name, const std::string& actual, const std::string& expected ) {
+    if ( actual == expected ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << name << " failed(actual=" << actual << ", expected=" << expected << ")"
+                  << std::endl;
+    }
+}
+
+std::string format( std::chrono::system_clock::time_point tp, utils::TimePrecision precision ) {
+    char   buf[ utils::kMaxTimestampSize ];
+    size_t n = utils::format_timestamp( tp, precision, buf );
+    return std::string( buf, n );
+}
+
+/**
+ * @brief 在指定时区下逐小时比较前缀与 UTC 偏移（覆盖夏令时切换）
+ */
+void test_timezone( const char* tz ) {
+    setenv( "TZ", tz, 1 );
+    tzset();
+
+    // 2024-01-01 00:00:00 UTC 起，逐 37 分钟遍历一年
+    auto start      = std::chrono::system_clock::from_time_t( 1704067200 );
+    int  mismatches = 0;
+    for ( int i = 0; i < 365 * 24 * 60 / 37; ++i ) {
+        auto tp = start + std::chrono::minutes( 37 * i ) + std::chrono::seconds( i % 60 );
+
+        std::string actual   = format( tp, utils::TimePrecision::SECONDS );
+        std::string expected = reference( tp, "%Y-%m-%d %H:%M:%S" );
+
+        char        offset[ utils::kUtcOffsetSize ];
+        std::string offset_actual( offset,
+                                   utils::format_utc_offset( utils::utc_offset( tp ), offset ) );
+        std::string offset_expected = reference( tp, "%z" );
+        offset_expected.insert( 3, ":" );
+
+        if ( actual != expected || offset_actual != offset_expected ) {
+            if ( mismatches++ < 3 ) {
+                std::cout << tz << " mismatch " << actual << " vs " << expected << ", "
+                          << offset_actual << " vs " << offset_expected << std::endl;
+            }
+        }
+    }
+
+    if ( mismatches == 0 ) {
+        ++test_pass;
+    } else {
+        ++test_fail;
+        std::cout << "test_timezone(" << tz << ") failed(mismatches=" << mismatches << ")"
+                  << std::endl;
+    }
+}
+
+void test_precision() {
+    setenv( "TZ", "UTC", 1 );
+    tzset();
+
+    auto tp = std::chrono::system_clock::from_time_t( 1704067200 ) +
+              std::chrono::microseconds( 123456 );
+    check( "seconds", format( tp, utils::TimePrecision::SECONDS ), "2024-01-01 00:00:00" );
+    check( "millis", format( tp, utils::TimePrecision::MILLIS ), "2024-01-01 00:00:00.123" );
+    check( "micros", format( tp, utils::TimePrecision::MICROS ), "2024-01-01 00:00:00.123456" );
+
+    // 同一秒内命中缓存，跨秒后重新渲染
+    check( "cached", format( tp + std::chrono::milliseconds( 500 ), utils::TimePrecision::MILLIS ),
+           "2024-01-01 00:00:00.623" );
+    check( "next_second",
+           format( tp + std::chrono::milliseconds( 900 ), utils::TimePrecision::MILLIS ),
+           "2024-01-01 00:00:01.023" );
+    check( "leap_day", format( std::chrono::system_clock::from_time_t( 1709164800 ),
+                               utils::TimePrecision::SECONDS ),
+           "2024-02-29 00:00:00" );
+}
+
+int main( int argc, char* argv[] ) {
+    std::cout << "Test time_format begin" << std::endl;
+    test_precision();
+    test_timezone( "UTC" );
+    test_timezone( "Asia/Shanghai" );
+    test_timezone( "America/New_York" );
+    test_timezone( "Australia/Lord_Howe" );
+    std::cout << "test_pass:" << test_pass << std::endl;
+    std::cout << "test_fail:" << test_fail << std::endl;
+    std::cout << "Test time_format end" << std::endl;
+    return test_fail == 0 ? 0 : 1;
+}